@@ -14,6 +14,7 @@
 #include "AstralEngine/Core/AWindow.h"
 #include "AstralEngine/Core/Input.h"
 #include "AstralEngine/Core/Time.h"
+#include "AstralEngine/Core/JobSystem.h"
 #include "AstralEngine/Core/Keycodes.h"
 #include "AstralEngine/Core/MouseButtonCodes.h"
 
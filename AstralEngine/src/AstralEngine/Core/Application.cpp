@@ -3,6 +3,7 @@
 #include "AstralEngine/Renderer/Renderer.h"
 #include "Core.h"
 #include "Time.h"
+#include "JobSystem.h"
 #include "AstralEngine/UI/UICore.h"
 
 #include <glad/glad.h>
@@ -23,6 +24,7 @@ namespace AstralEngine
 
 		m_layerStack.AttachLayer(m_uiContext);
 
+		JobSystem::Init();
 		Renderer::Init();
 		Random::Init();
 
@@ -34,6 +36,8 @@ namespace AstralEngine
 		//no need to delete the UIContext since the LayerStack will do it for us
 		AE_PROFILE_FUNCTION();
 		Renderer::Shutdown();
+		ResourceHandler::CancelAsyncLoads();
+		JobSystem::Shutdown();
 		delete m_window;
 	}
 
@@ -104,6 +108,12 @@ namespace AstralEngine
 				Input::OnUpdate();
 				m_window->OnUpdate();
 			}
+
+			//create the gpu resources of the assets which finished loading in the background
+			ResourceHandler::FinalizeAsyncLoads();
+
+			//resources deleted during the frame are only destroyed once nothing can borrow them anymore
+			ResourceHandler::ReleaseRemovedResources();
 		}
 	}
 
@@ -15,6 +15,17 @@
 	#define AE_RENDER_ASSERTS
 #endif
 
+// SIMD instruction sets used by the math code, define AE_NO_SIMD to use the scalar reference implementations
+#ifndef AE_NO_SIMD
+	#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define AE_SIMD_SSE
+	#endif
+
+	#if defined(AE_SIMD_SSE) && defined(__AVX2__)
+		#define AE_SIMD_AVX2
+	#endif
+#endif
+
 #ifdef AE_ENABLE_ASSERTS
 	#define AE_CORE_ASSERT(exp, ...) { if(!(exp)){ AE_CORE_ERROR(__VA_ARGS__); __debugbreak(); } }
 	#define AE_ASSERT(exp, ...) { if (!exp) { AE_ERROR(__VA_ARGS__); __debugbreak(); } }
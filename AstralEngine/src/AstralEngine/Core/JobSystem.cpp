@@ -0,0 +1,355 @@
+#include "aepch.h"
+#include "JobSystem.h"
+
+namespace AstralEngine
+{
+	// JobQueue ////////////////////////////////////////////////////////
+
+	/*double ended queue of jobs owned by a single thread, the owner pushes and pops
+	  jobs at the back while other threads steal the oldest jobs from the front
+	*/
+	class JobQueue
+	{
+	public:
+		JobQueue() : m_jobs(new Job[s_startCapacity]), m_capacity(s_startCapacity), m_front(0), m_count(0) { }
+		~JobQueue() { delete[] m_jobs; }
+
+		void Push(const Job& job)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_count == m_capacity)
+			{
+				Grow();
+			}
+			m_jobs[(m_front + m_count) & (m_capacity - 1)] = job;
+			m_count++;
+		}
+
+		bool Pop(Job& outJob)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_count == 0)
+			{
+				return false;
+			}
+			m_count--;
+			outJob = m_jobs[(m_front + m_count) & (m_capacity - 1)];
+			return true;
+		}
+
+		bool Steal(Job& outJob)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_count == 0)
+			{
+				return false;
+			}
+			outJob = m_jobs[m_front];
+			m_front = (m_front + 1) & (m_capacity - 1);
+			m_count--;
+			return true;
+		}
+
+	private:
+		void Grow()
+		{
+			size_t newCapacity = m_capacity * 2;
+			Job* temp = new Job[newCapacity];
+			for (size_t i = 0; i < m_count; i++)
+			{
+				temp[i] = m_jobs[(m_front + i) & (m_capacity - 1)];
+			}
+
+			delete[] m_jobs;
+			m_jobs = temp;
+			m_capacity = newCapacity;
+			m_front = 0;
+		}
+
+		//must be a power of two
+		static constexpr size_t s_startCapacity = 256;
+
+		std::mutex m_mutex;
+		Job* m_jobs;
+		size_t m_capacity;
+		size_t m_front;
+		size_t m_count;
+	};
+
+	// JobSystem ///////////////////////////////////////////////////////
+
+	static constexpr size_t s_noQueueIndex = MAXSIZE_T;
+
+	//index of the queue owned by the current thread
+	static thread_local size_t s_threadQueueIndex = s_noQueueIndex;
+
+	size_t JobSystem::s_numThreads = 1;
+	JobQueue* JobSystem::s_queues = nullptr;
+	JobQueue* JobSystem::s_backgroundQueue = nullptr;
+	std::thread* JobSystem::s_workers = nullptr;
+	std::atomic<bool> JobSystem::s_isRunning = false;
+	std::atomic<size_t> JobSystem::s_pendingJobs = 0;
+	std::atomic<size_t> JobSystem::s_nextQueue = 0;
+	std::mutex JobSystem::s_sleepMutex;
+	std::condition_variable JobSystem::s_wakeCondition;
+
+	void JobSystem::Init(size_t numThreads)
+	{
+		AE_PROFILE_FUNCTION();
+		AE_CORE_ASSERT(!IsInitialized(), "JobSystem already initialized");
+
+		if (numThreads == 0)
+		{
+			numThreads = (std::max)((size_t)std::thread::hardware_concurrency(), (size_t)1);
+		}
+
+		s_numThreads = numThreads;
+		s_queues = new JobQueue[s_numThreads];
+		s_backgroundQueue = new JobQueue();
+		s_isRunning = true;
+		s_threadQueueIndex = 0;
+
+		//queue 0 belongs to the main thread
+		s_workers = new std::thread[s_numThreads - 1];
+		for (size_t i = 1; i < s_numThreads; i++)
+		{
+			s_workers[i - 1] = std::thread(&JobSystem::WorkerLoop, i);
+		}
+	}
+
+	void JobSystem::Shutdown()
+	{
+		AE_PROFILE_FUNCTION();
+		if (!IsInitialized())
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_sleepMutex);
+			s_isRunning = false;
+		}
+		s_wakeCondition.notify_all();
+
+		/*the workers only exit once every queue is empty, the jobs still queued hold pointers to
+		  data owned by their callers and counters which would otherwise never reach zero
+		*/
+		while (s_pendingJobs > 0)
+		{
+			if (!TryExecuteJob(GetQueueIndex()))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		for (size_t i = 0; i < s_numThreads - 1; i++)
+		{
+			s_workers[i].join();
+		}
+
+		delete[] s_workers;
+		delete[] s_queues;
+		delete s_backgroundQueue;
+		s_workers = nullptr;
+		s_queues = nullptr;
+		s_backgroundQueue = nullptr;
+		s_numThreads = 1;
+		s_threadQueueIndex = s_noQueueIndex;
+	}
+
+	void JobSystem::Submit(const Job& job)
+	{
+		if (job.counter != nullptr)
+		{
+			job.counter->m_count.fetch_add(1, std::memory_order_relaxed);
+		}
+		PushJob(job);
+	}
+
+	void JobSystem::Submit(const Job* jobs, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			Submit(jobs[i]);
+		}
+	}
+
+	void JobSystem::SubmitAfter(JobCounter& dependency, const Job& job)
+	{
+		if (job.counter != nullptr)
+		{
+			job.counter->m_count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		{
+			/*the lock is also taken when the counter reaches zero so the job is either
+			  stored before the continuations are flushed or the dependency is already done
+			*/
+			std::lock_guard<std::mutex> lock(dependency.m_continuationMutex);
+			if (!dependency.IsDone())
+			{
+				dependency.m_continuations.Add(job);
+				return;
+			}
+		}
+		PushJob(job);
+	}
+
+	void JobSystem::SubmitBackground(const Job& job)
+	{
+		if (job.counter != nullptr)
+		{
+			job.counter->m_count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if (!IsInitialized() || s_numThreads == 1)
+		{
+			Execute(job);
+			return;
+		}
+
+		s_pendingJobs++;
+		s_backgroundQueue->Push(job);
+		{
+			std::lock_guard<std::mutex> lock(s_sleepMutex);
+		}
+		s_wakeCondition.notify_one();
+	}
+
+	void JobSystem::WaitFor(const JobCounter& counter)
+	{
+		AE_PROFILE_FUNCTION();
+		size_t index = GetQueueIndex();
+		while (!counter.IsDone())
+		{
+			if (!TryExecuteJob(index))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		//wait for the job which completed the counter to be done with it
+		std::lock_guard<std::mutex> lock(counter.m_continuationMutex);
+	}
+
+	void JobSystem::WorkerLoop(size_t index)
+	{
+		s_threadQueueIndex = index;
+
+		//once shutting down the worker keeps running until every queue is empty
+		while (s_isRunning || s_pendingJobs > 0)
+		{
+			if (!TryExecuteJob(index) && !TryExecuteBackgroundJob())
+			{
+				std::unique_lock<std::mutex> lock(s_sleepMutex);
+				s_wakeCondition.wait(lock, []() { return s_pendingJobs > 0 || !s_isRunning; });
+			}
+		}
+	}
+
+	//runs a job from the queue of the thread or steals one from another thread if it is empty
+	bool JobSystem::TryExecuteJob(size_t index)
+	{
+		if (!IsInitialized())
+		{
+			return false;
+		}
+
+		Job job;
+		bool found = index != s_noQueueIndex && s_queues[index].Pop(job);
+		for (size_t i = 1; i <= s_numThreads && !found; i++)
+		{
+			found = s_queues[(index + i) % s_numThreads].Steal(job);
+		}
+
+		if (found)
+		{
+			s_pendingJobs--;
+			Execute(job);
+		}
+		return found;
+	}
+
+	//only called by the worker threads, the main thread never runs background jobs
+	bool JobSystem::TryExecuteBackgroundJob()
+	{
+		Job job;
+		if (s_backgroundQueue->Steal(job))
+		{
+			s_pendingJobs--;
+			Execute(job);
+			return true;
+		}
+		return false;
+	}
+
+	void JobSystem::Execute(const Job& job)
+	{
+		job.function();
+
+		if (job.counter != nullptr)
+		{
+			DecrementCounter(*job.counter);
+		}
+	}
+
+	/*only the final decrement takes the lock of the counter, WaitFor takes that same lock 
+	  before returning so a counter is never destroyed while a job is still using it
+	*/
+	void JobSystem::DecrementCounter(JobCounter& counter)
+	{
+		size_t count = counter.m_count.load(std::memory_order_relaxed);
+		while (count > 1)
+		{
+			if (counter.m_count.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel))
+			{
+				return;
+			}
+		}
+
+		std::unique_lock<std::mutex> lock(counter.m_continuationMutex);
+		if (counter.m_count.fetch_sub(1, std::memory_order_acq_rel) == 1 
+			&& !counter.m_continuations.IsEmpty())
+		{
+			//the counter reached zero, release the jobs which were waiting on it
+			ADynArr<Job> continuations = counter.m_continuations;
+			counter.m_continuations.Clear();
+			lock.unlock();
+
+			for (const Job& continuation : continuations)
+			{
+				PushJob(continuation);
+			}
+		}
+	}
+
+	void JobSystem::PushJob(const Job& job)
+	{
+		if (!IsInitialized())
+		{
+			//no worker threads, run the job right away
+			Execute(job);
+			return;
+		}
+
+		size_t index = GetQueueIndex();
+		if (index == s_noQueueIndex)
+		{
+			index = s_nextQueue++ % s_numThreads;
+		}
+
+		s_pendingJobs++;
+		s_queues[index].Push(job);
+
+		//taking the lock guarantees a worker is either already waiting or will see the new job
+		{
+			std::lock_guard<std::mutex> lock(s_sleepMutex);
+		}
+		s_wakeCondition.notify_one();
+	}
+
+	size_t JobSystem::GetQueueIndex()
+	{
+		return s_threadQueueIndex;
+	}
+}
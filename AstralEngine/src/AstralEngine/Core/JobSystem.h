@@ -0,0 +1,153 @@
+#pragma once
+#include "AstralEngine/Data Struct/ADelegate.h"
+#include "AstralEngine/Data Struct/ADynArr.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace AstralEngine
+{
+	class JobCounter;
+
+	/*unit of work executed by the JobSystem, the delegate does not own the data it is bound to
+	  so that data must outlive the job (usually by waiting on the counter of the job)
+	*/
+	struct Job
+	{
+		Job() : counter(nullptr) { }
+		Job(ADelegate<void()> func, JobCounter* c = nullptr) : function(func), counter(c) { }
+
+		ADelegate<void()> function;
+		JobCounter* counter;
+	};
+
+	/*tracks how many jobs are still pending, jobs can be scheduled to only start once a
+	  counter reaches zero which allows building graphs of dependent tasks
+
+	  a counter must outlive the jobs it tracks and should not be reused while jobs wait on it
+	*/
+	class JobCounter
+	{
+		friend class JobSystem;
+	public:
+		JobCounter() : m_count(0) { }
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+		size_t GetCount() const { return m_count.load(std::memory_order_acquire); }
+
+	private:
+		std::atomic<size_t> m_count;
+		mutable std::mutex m_continuationMutex;
+		ADynArr<Job> m_continuations;
+	};
+
+	class JobQueue;
+
+	/*engine wide pool of worker threads, every thread owns a queue of jobs and idle threads
+	  steal work from the queues of the other threads. The thread calling Init is considered
+	  the main thread and takes part in the work while it waits on a counter
+
+	  long running work which nobody waits on within the frame (e.g. loading assets) is submitted 
+	  as background jobs, those are only executed by the worker threads so they never stall the main thread
+	*/
+	class JobSystem
+	{
+	public:
+		//numThreads includes the main thread, 0 uses one thread per hardware core
+		static void Init(size_t numThreads = 0);
+
+		//every job submitted before the call (and the jobs they submit) completes before the worker threads are joined
+		static void Shutdown();
+
+		static bool IsInitialized() { return s_queues != nullptr; }
+
+		//number of threads executing jobs including the main thread
+		static size_t GetThreadCount() { return s_numThreads; }
+
+		//the counter provided (if any) is incremented for each job and decremented once that job completes
+		static void Submit(const Job& job);
+		static void Submit(const Job* jobs, size_t count);
+
+		//the job is only submitted once the dependency counter reaches zero
+		static void SubmitAfter(JobCounter& dependency, const Job& job);
+
+		/*the job is executed by a worker thread once it has no other job to run, 
+		  without worker threads the job is executed right away on the calling thread
+		*/
+		static void SubmitBackground(const Job& job);
+
+		//executes pending jobs on the calling thread until the counter reaches zero
+		static void WaitFor(const JobCounter& counter);
+
+		/*calls func(task) for every task in [0, taskCount) spread over the worker threads,
+		  the calling thread takes part in the work and the function returns once every task is done
+		*/
+		template<typename Func>
+		static void ParallelFor(size_t taskCount, Func func)
+		{
+			size_t numJobs = (std::min)(s_numThreads, taskCount);
+			if (numJobs <= 1)
+			{
+				for (size_t i = 0; i < taskCount; i++)
+				{
+					func(i);
+				}
+				return;
+			}
+
+			//every job pulls tasks from the same range so no allocation is needed per task
+			ParallelForData<Func> data(func, taskCount);
+			JobCounter counter;
+			Job job = Job(ADelegate<void()>(&ParallelForData<Func>::Run, &data), &counter);
+			for (size_t i = 0; i < numJobs - 1; i++)
+			{
+				Submit(job);
+			}
+
+			ParallelForData<Func>::Run(&data);
+			WaitFor(counter);
+		}
+
+	private:
+		template<typename Func>
+		struct ParallelForData
+		{
+			ParallelForData(Func& f, size_t count) : func(f), nextTask(0), taskCount(count) { }
+
+			static void Run(void* ptr)
+			{
+				ParallelForData<Func>* data = (ParallelForData<Func>*)ptr;
+				for (size_t task = data->nextTask++; task < data->taskCount; task = data->nextTask++)
+				{
+					data->func(task);
+				}
+			}
+
+			Func& func;
+			std::atomic<size_t> nextTask;
+			size_t taskCount;
+		};
+
+		static void WorkerLoop(size_t index);
+		static bool TryExecuteJob(size_t index);
+		static bool TryExecuteBackgroundJob();
+		static void Execute(const Job& job);
+		static void DecrementCounter(JobCounter& counter);
+		static void PushJob(const Job& job);
+		static size_t GetQueueIndex();
+
+		static size_t s_numThreads;
+		static JobQueue* s_queues;
+		static JobQueue* s_backgroundQueue;
+		static std::thread* s_workers;
+		static std::atomic<bool> s_isRunning;
+		static std::atomic<size_t> s_pendingJobs;
+		static std::atomic<size_t> s_nextQueue;
+		static std::mutex s_sleepMutex;
+		static std::condition_variable s_wakeCondition;
+	};
+}
@@ -132,6 +132,7 @@ namespace AstralEngine
 
 	void Logger::PrintInColor(const std::string& prefix, const std::string& message, WORD color)
 	{
+		std::lock_guard<std::mutex> lock(s_mutex);
 		SetConsoleTextAttribute(s_handle, color);
 		s_file << prefix << message << "\n";
 		std::cout << prefix << message << "\n";
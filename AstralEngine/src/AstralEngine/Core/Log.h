@@ -4,6 +4,7 @@
 #include <windows.h>
 #include <fstream>
 #include <sstream>
+#include <mutex>
 
 
 #ifdef AE_DEBUG
@@ -51,6 +52,8 @@ namespace AstralEngine
 
 		static HANDLE s_handle;
 		static std::ofstream s_file;
+		//messages can be logged from the worker threads of the JobSystem
+		static std::mutex s_mutex;
 	};
 }
 
@@ -4,9 +4,42 @@
 #include "AstralEngine/Renderer/Shader.h"
 #include "AstralEngine/Renderer/Renderer.h"
 #include "AstralEngine/Renderer/Mesh.h"
+#include "JobSystem.h"
+#include "Time.h"
+
+#include <atomic>
 
 namespace AstralEngine
 {
+	// AsyncLoadRequest ////////////////////////////////////////////////////////////
+
+	enum class AsyncLoadType
+	{
+		Texture2D,
+		Mesh
+	};
+
+	/*asset requested asynchronously, the worker thread fills in the decoded data 
+	  then sets isDecoded which hands the request back to the main thread
+	*/
+	struct AsyncLoadRequest
+	{
+		AsyncLoadRequest(AsyncLoadType t, const std::string& path, ResourceHandle h) : type(t), filepath(path), 
+			handle(h), pixels(nullptr), width(0), height(0), isDecoded(false), isCancelled(false) { }
+
+		AsyncLoadType type;
+		std::string filepath;
+		ResourceHandle handle;
+
+		AReference<Mesh> mesh;
+		unsigned char* pixels;
+		unsigned int width;
+		unsigned int height;
+
+		std::atomic<bool> isDecoded;
+		std::atomic<bool> isCancelled;
+	};
+
 	// ResourceHandler /////////////////////////////////////////////////////////////
 	bool ResourceHandler::ShaderIsValid(ShaderHandle handle) 
 	{ 
@@ -23,6 +56,11 @@ namespace AstralEngine
 		return GetHandler()->m_shaders.GetResource(handle);
 	}
 
+	ResourceView<Shader> ResourceHandler::BorrowShader(ShaderHandle handle)
+	{
+		return ResourceView<Shader>(GetHandler()->m_shaders.BorrowResource(handle));
+	}
+
 	void ResourceHandler::DeleteShader(ShaderHandle handle)
 	{
 		GetHandler()->m_shaders.RemoveHandle(handle);
@@ -75,11 +113,24 @@ namespace AstralEngine
 		return GetHandler()->m_textures2D.AddResource(texture);
 	}
 
+	Texture2DHandle ResourceHandler::LoadTexture2DAsync(const std::string& filepath)
+	{
+		AReference<Texture2D> placeholder = GetTexture2D(Texture2D::WhiteTexture());
+		Texture2DHandle handle = GetHandler()->m_textures2D.AddResource(placeholder);
+		SubmitAsyncLoad(new AsyncLoadRequest(AsyncLoadType::Texture2D, filepath, handle));
+		return handle;
+	}
+
 	AReference<Texture2D> ResourceHandler::GetTexture2D(Texture2DHandle handle)
 	{
 		return GetHandler()->m_textures2D.GetResource(handle);
 	}
 
+	ResourceView<Texture2D> ResourceHandler::BorrowTexture2D(Texture2DHandle handle)
+	{
+		return ResourceView<Texture2D>(GetHandler()->m_textures2D.BorrowResource(handle));
+	}
+
 	void ResourceHandler::DeleteTexture2D(Texture2DHandle handle)
 	{
 		GetHandler()->m_textures2D.RemoveHandle(handle);
@@ -106,6 +157,11 @@ namespace AstralEngine
 		return GetHandler()->m_materials.GetResource(handle);
 	}
 
+	ResourceView<Material> ResourceHandler::BorrowMaterial(MaterialHandle handle)
+	{
+		return ResourceView<Material>(GetHandler()->m_materials.BorrowResource(handle));
+	}
+
 	void ResourceHandler::DeleteMaterial(MaterialHandle handle)
 	{
 		GetHandler()->m_materials.RemoveHandle(handle);
@@ -123,6 +179,7 @@ namespace AstralEngine
 		{
 			return NullHandle;
 		}
+		CreateMeshGPUResources(*m);
 		return GetHandler()->m_meshes.AddResource(m);
 	}
 
@@ -134,24 +191,218 @@ namespace AstralEngine
 		{
 			return NullHandle;
 		}
+		m->CreateGPUBuffers();
 		return GetHandler()->m_meshes.AddResource(m);
 	}
 
+	MeshHandle ResourceHandler::LoadMeshAsync(const std::string& filepath)
+	{
+		AReference<Mesh> placeholder = GetMesh(EmptyMesh());
+		MeshHandle handle = GetHandler()->m_meshes.AddResource(placeholder);
+		GetHandler()->m_loadingMeshes.Add(handle, true);
+		SubmitAsyncLoad(new AsyncLoadRequest(AsyncLoadType::Mesh, filepath, handle));
+		return handle;
+	}
+
 	AReference<Mesh> ResourceHandler::GetMesh(MeshHandle handle)
 	{
 		AE_PROFILE_FUNCTION();
 		return GetHandler()->m_meshes.GetResource(handle);
 	}
 
+	ResourceView<Mesh> ResourceHandler::BorrowMesh(MeshHandle handle)
+	{
+		return ResourceView<Mesh>(GetHandler()->m_meshes.BorrowResource(handle));
+	}
+
 	void ResourceHandler::DeleteMesh(MeshHandle handle)
 	{
+		//the levels of detail of a mesh are owned by it
+		if (MeshIsValid(handle))
+		{
+			ResourceView<Mesh> mesh = BorrowMesh(handle);
+			if (mesh != nullptr)
+			{
+				for (MeshHandle lod : mesh->m_lods)
+				{
+					DeleteMesh(lod);
+				}
+			}
+		}
 		GetHandler()->m_meshes.RemoveHandle(handle);
 	}
 
+	void ResourceHandler::ReleaseRemovedResources()
+	{
+		ResourceHandler* handler = GetHandler();
+		handler->m_textures2D.ReleaseRemovedResources();
+		handler->m_shaders.ReleaseRemovedResources();
+		handler->m_materials.ReleaseRemovedResources();
+		handler->m_meshes.ReleaseRemovedResources();
+	}
+
+	void ResourceHandler::FinalizeAsyncLoads(double timeBudget)
+	{
+		AE_PROFILE_FUNCTION();
+		ADynArr<AsyncLoadRequest*>& pendingLoads = GetHandler()->m_pendingLoads;
+		GetHandler()->m_finalizedMeshes.Clear();
+		double startTime = Time::GetTime();
+		size_t numRemaining = 0;
+
+		for (size_t i = 0; i < pendingLoads.GetCount(); i++)
+		{
+			AsyncLoadRequest* request = pendingLoads[i];
+			bool hasTimeLeft = Time::GetTime() - startTime < timeBudget;
+			if (hasTimeLeft && request->isDecoded.load(std::memory_order_acquire))
+			{
+				FinalizeAsyncLoad(request);
+				delete request;
+			}
+			else
+			{
+				pendingLoads[numRemaining] = request;
+				numRemaining++;
+			}
+		}
+
+		while (pendingLoads.GetCount() > numRemaining)
+		{
+			pendingLoads.RemoveAt(pendingLoads.GetCount() - 1);
+		}
+	}
+
+	size_t ResourceHandler::GetNumPendingLoads()
+	{
+		return GetHandler()->m_pendingLoads.GetCount();
+	}
+
+	void ResourceHandler::CancelAsyncLoads()
+	{
+		AE_PROFILE_FUNCTION();
+		ResourceHandler* handler = GetHandler();
+		for (AsyncLoadRequest* request : handler->m_pendingLoads)
+		{
+			request->isCancelled.store(true, std::memory_order_relaxed);
+		}
+		JobSystem::WaitFor(handler->m_decodeCounter);
+
+		for (AsyncLoadRequest* request : handler->m_pendingLoads)
+		{
+			if (request->pixels != nullptr)
+			{
+				Texture2D::FreePixels(request->pixels);
+			}
+			delete request;
+		}
+		handler->m_pendingLoads.Clear();
+		handler->m_loadingMeshes.Clear();
+	}
+
+	bool ResourceHandler::MeshIsLoading(MeshHandle handle)
+	{
+		return GetHandler()->m_loadingMeshes.ContainsKey(handle);
+	}
+
+	const ADynArr<MeshHandle>& ResourceHandler::GetFinalizedMeshes()
+	{
+		return GetHandler()->m_finalizedMeshes;
+	}
+
 	ResourceHandler* ResourceHandler::GetHandler()
 	{
 		static ResourceHandler* handler = new ResourceHandler();
 		return handler;
 	}
 
+	MeshHandle ResourceHandler::EmptyMesh()
+	{
+		static MeshHandle emptyMesh = CreateMesh(ADynArr<Vector3>(), ADynArr<Vector2>(), 
+			ADynArr<Vector3>(), ADynArr<unsigned int>());
+		return emptyMesh;
+	}
+
+	void ResourceHandler::CreateMeshGPUResources(Mesh& mesh)
+	{
+		mesh.CreateGPUBuffers();
+		for (AReference<Mesh>& lod : mesh.m_lodMeshes)
+		{
+			lod->CreateGPUBuffers();
+			mesh.m_lods.Add(GetHandler()->m_meshes.AddResource(lod));
+		}
+		mesh.m_lodMeshes = ADynArr<AReference<Mesh>>(0);
+	}
+
+	void ResourceHandler::SubmitAsyncLoad(AsyncLoadRequest* request)
+	{
+		ResourceHandler* handler = GetHandler();
+		handler->m_pendingLoads.Add(request);
+		JobSystem::SubmitBackground(Job(ADelegate<void()>(&ResourceHandler::DecodeAsyncLoad, request), 
+			&handler->m_decodeCounter));
+	}
+
+	// runs on a worker thread so it must not touch the resource pools or the rendering context
+	void ResourceHandler::DecodeAsyncLoad(void* data)
+	{
+		AsyncLoadRequest* request = (AsyncLoadRequest*)data;
+		if (request->isCancelled.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		switch (request->type)
+		{
+		case AsyncLoadType::Texture2D:
+			request->pixels = Texture2D::DecodeFile(request->filepath, request->width, request->height);
+			break;
+
+		case AsyncLoadType::Mesh:
+			request->mesh = Mesh::LoadFromFile(request->filepath);
+			break;
+		}
+		request->isDecoded.store(true, std::memory_order_release);
+	}
+
+	// replaces the placeholder of the request unless its handle was deleted while the asset was loading
+	void ResourceHandler::FinalizeAsyncLoad(AsyncLoadRequest* request)
+	{
+		ResourceHandler* handler = GetHandler();
+		switch (request->type)
+		{
+		case AsyncLoadType::Texture2D:
+			if (request->pixels == nullptr)
+			{
+				AE_CORE_WARN("could not load texture \"%S\"", request->filepath);
+				break;
+			}
+
+			if (handler->m_textures2D.HandleIsValid(request->handle))
+			{
+				AReference<Texture2D> texture = Texture2D::Create(request->width, request->height, 
+					request->pixels, request->width * request->height * 4);
+				if (texture != nullptr)
+				{
+					handler->m_textures2D.GetResource(request->handle) = texture;
+				}
+			}
+			Texture2D::FreePixels(request->pixels);
+			break;
+
+		case AsyncLoadType::Mesh:
+			handler->m_loadingMeshes.Remove(request->handle);
+			handler->m_finalizedMeshes.Add(request->handle);
+			if (request->mesh == nullptr)
+			{
+				AE_CORE_WARN("could not load mesh \"%S\"", request->filepath);
+				break;
+			}
+
+			if (handler->m_meshes.HandleIsValid(request->handle))
+			{
+				CreateMeshGPUResources(*request->mesh);
+				handler->m_meshes.GetResource(request->handle) = request->mesh;
+			}
+			break;
+		}
+	}
+
 }
\ No newline at end of file
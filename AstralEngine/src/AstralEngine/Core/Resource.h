@@ -2,7 +2,9 @@
 #include "AstralEngine/Data Struct/ADynArr.h"
 #include "AstralEngine/Data Struct/AStack.h"
 #include "AstralEngine/Data Struct/AReference.h"
+#include "AstralEngine/Data Struct/AUnorderedMap.h"
 #include "AstralEngine/Math/AMath.h"
+#include "JobSystem.h"
 
 namespace AstralEngine
 {
@@ -20,47 +22,135 @@ namespace AstralEngine
 	class Material;
 	class Mesh;
 	enum class Texture2DInternalFormat;
+	struct AsyncLoadRequest;
 
+	/* non owning access to a resource which does not touch its reference count, a view obtained from 
+	   one of the Borrow functions of the ResourceHandler stays valid until the end of the frame even 
+	   if the resource is deleted in the meantime so it should never be kept longer than that
+	*/
+	template<typename T>
+	class ResourceView
+	{
+	public:
+		ResourceView() : m_ptr(nullptr) { }
+		ResourceView(std::nullptr_t) : m_ptr(nullptr) { }
+		explicit ResourceView(T* ptr) : m_ptr(ptr) { }
+
+		T* Get() const { return m_ptr; }
+
+		T* operator->() const
+		{
+			AE_CORE_ASSERT(m_ptr != nullptr, "Trying to access a null ResourceView");
+			return m_ptr;
+		}
+
+		T& operator*() const
+		{
+			AE_CORE_ASSERT(m_ptr != nullptr, "Trying to access a null ResourceView");
+			return *m_ptr;
+		}
+
+		bool operator==(std::nullptr_t) const { return m_ptr == nullptr; }
+		bool operator!=(std::nullptr_t) const { return m_ptr != nullptr; }
+
+	private:
+		T* m_ptr;
+	};
+
+	/* slot map storing the resources of a type, a handle holds the index of the slot of the resource 
+	   in its lower bits and the generation of that slot in its upper bits. The generation of a slot is 
+	   incremented when its resource is removed so handles to removed resources are detected in constant 
+	   time and never alias the resource which reuses the slot
+
+	   removed resources are only released by ReleaseRemovedResources so the ResourceViews 
+	   borrowed during the frame remain valid
+	*/
 	template<typename T>
 	class ResourcePool
 	{
 	public:
 		ResourceHandle AddResource(const AReference<T>& resource)
 		{
-			ResourceHandle handle;
-			if (m_handlesToReuse.IsEmpty())
+			size_t index;
+			if (m_freeSlots.IsEmpty())
 			{
-				handle = m_resourceList.GetCount();
-				m_resourceList.Add(resource);
+				index = m_slots.GetCount();
+				AE_CORE_ASSERT(index < s_indexMask, "Too many resources in the ResourcePool");
+				m_slots.Add(Slot());
 			}
 			else
 			{
-				handle = m_handlesToReuse.Pop();
-				m_resourceList[handle] = resource;
+				index = m_freeSlots.Pop();
 			}
-			return handle;
+
+			Slot& slot = m_slots[index];
+			slot.resource = resource;
+			slot.isUsed = true;
+			return ComposeHandle(index, slot.generation);
 		}
 
+		// the resource is destroyed once it was released and no other reference to it is held
 		void RemoveHandle(ResourceHandle handle)
 		{
 			AE_CORE_ASSERT(HandleIsValid(handle), "");
-			m_handlesToReuse.Push(handle);
+			size_t index = GetIndex(handle);
+			Slot& slot = m_slots[index];
+			m_removedResources.Add(slot.resource);
+			slot.resource = nullptr;
+			slot.isUsed = false;
+			slot.generation = (slot.generation + 1) & s_generationMask;
+			m_freeSlots.Push(index);
 		}
 
 		AReference<T>& GetResource(ResourceHandle handle)
 		{
 			AE_CORE_ASSERT(HandleIsValid(handle), "Invalid handle provided");
-			return m_resourceList[handle];
+			return m_slots[GetIndex(handle)].resource;
+		}
+
+		T* BorrowResource(ResourceHandle handle)
+		{
+			AE_CORE_ASSERT(HandleIsValid(handle), "Invalid handle provided");
+			const AReference<T>& resource = m_slots[GetIndex(handle)].resource;
+			return resource == nullptr ? nullptr : resource.Get();
 		}
 
-		bool HandleIsValid(ResourceHandle handle)
+		void ReleaseRemovedResources()
 		{
-			return handle < m_resourceList.GetCount() && !m_handlesToReuse.Contains(handle);
+			m_removedResources.Clear();
+		}
+
+		bool HandleIsValid(ResourceHandle handle) const
+		{
+			size_t index = GetIndex(handle);
+			return index < m_slots.GetCount() && m_slots[index].isUsed 
+				&& m_slots[index].generation == GetGeneration(handle);
 		}
 
 	private:
-		ADynArr<AReference<T>> m_resourceList;
-		AStack<ResourceHandle> m_handlesToReuse;
+		struct Slot
+		{
+			AReference<T> resource;
+			size_t generation = 0;
+			bool isUsed = false;
+		};
+
+		//the generation never reaches the mask so NullHandle is never a valid handle
+		static constexpr size_t s_indexMask = 0xFFFFFFFF;
+		static constexpr size_t s_generationMask = 0x7FFFFFFF;
+		static constexpr size_t s_generationShift = 32;
+
+		static ResourceHandle ComposeHandle(size_t index, size_t generation)
+		{
+			return (generation << s_generationShift) | index;
+		}
+
+		static size_t GetIndex(ResourceHandle handle) { return handle & s_indexMask; }
+		static size_t GetGeneration(ResourceHandle handle) { return handle >> s_generationShift; }
+
+		ADynArr<Slot> m_slots;
+		AStack<size_t> m_freeSlots;
+		ADynArr<AReference<T>> m_removedResources;
 	};
 
 	class ResourceHandler
@@ -70,16 +160,23 @@ namespace AstralEngine
 		static bool ShaderIsValid(ShaderHandle handle);
 		static ShaderHandle LoadShader(const std::string& filepath);
 		static AReference<Shader> GetShader(ShaderHandle handle);
+		static ResourceView<Shader> BorrowShader(ShaderHandle handle);
 		static void DeleteShader(ShaderHandle handle);
 
 		// Texture2D /////////////////////////////////////////////////
 		static bool Texture2DIsValid(Texture2DHandle handle);
 		static Texture2DHandle LoadTexture2D(const std::string& filepath);
+
+		/*returns right away a handle backed by the white texture, the file is decoded by the JobSystem 
+		  and the texture replaces the placeholder once it is finalized by FinalizeAsyncLoads
+		*/
+		static Texture2DHandle LoadTexture2DAsync(const std::string& filepath);
 		static Texture2DHandle CreateTexture2D(unsigned int width, unsigned int height);
 		static Texture2DHandle CreateTexture2D(unsigned int width, unsigned int height, 
 			Texture2DInternalFormat internalFormat);
 		static Texture2DHandle CreateTexture2D(unsigned int width, unsigned int height, void* data, unsigned int size);
 		static AReference<Texture2D> GetTexture2D(Texture2DHandle handle);
+		static ResourceView<Texture2D> BorrowTexture2D(Texture2DHandle handle);
 		static void DeleteTexture2D(Texture2DHandle handle);
 
 		// Material /////////////////////////////////////////////////////
@@ -87,23 +184,67 @@ namespace AstralEngine
 		static MaterialHandle CreateMaterial();
 		static MaterialHandle CreateMaterial(const Vector4& color);
 		static AReference<Material> GetMaterial(MaterialHandle handle);
+		static ResourceView<Material> BorrowMaterial(MaterialHandle handle);
 		static void DeleteMaterial(MaterialHandle handle);
 
 		// Mesh //////////////////////////////////////////////////////////
 		static bool MeshIsValid(MeshHandle handle);
 		static MeshHandle LoadMesh(const std::string& filepath);
+
+		//same as LoadTexture2DAsync, the placeholder is an empty mesh so nothing is drawn until the mesh is ready
+		static MeshHandle LoadMeshAsync(const std::string& filepath);
 		static MeshHandle CreateMesh(const ADynArr<Vector3>& positions, const ADynArr<Vector2>& textureCoords,
 			const ADynArr<Vector3>& normals, const ADynArr<unsigned int>& indices);
 		static AReference<Mesh> GetMesh(MeshHandle handle);
+		static ResourceView<Mesh> BorrowMesh(MeshHandle handle);
 		static void DeleteMesh(MeshHandle handle);
 
+		// destroys the resources deleted since the last call which are not referenced anymore, called once per frame
+		static void ReleaseRemovedResources();
+
+		/*creates the gpu resources of the assets decoded by the worker threads, called once per frame on 
+		  the main thread. No more assets are finalized once timeBudget (in seconds) is exceeded
+		*/
+		static void FinalizeAsyncLoads(double timeBudget = s_defaultFinalizeBudget);
+
+		// number of assets requested asynchronously which were not finalized yet
+		static size_t GetNumPendingLoads();
+
+		/*drops the assets requested asynchronously which were not finalized yet, the ones still queued 
+		  are not decoded and the function waits for the ones being decoded. Called before the JobSystem is shut down
+		*/
+		static void CancelAsyncLoads();
+
+		// true while the mesh behind the handle is the placeholder of a load which was not finalized yet
+		static bool MeshIsLoading(MeshHandle handle);
+
+		/*handles of the meshes loaded asynchronously which were finalized (or failed to load) by the last 
+		  call to FinalizeAsyncLoads, used by the scenes to refresh the bounds of the entities rendering them
+		*/
+		static const ADynArr<MeshHandle>& GetFinalizedMeshes();
+
 	private:
+		static constexpr double s_defaultFinalizeBudget = 0.002;
+
 		static ResourceHandler* GetHandler();
+		static MeshHandle EmptyMesh();
+		static void DecodeAsyncLoad(void* request);
+		static void SubmitAsyncLoad(AsyncLoadRequest* request);
+		static void FinalizeAsyncLoad(AsyncLoadRequest* request);
+
+		//creates the gpu buffers of the mesh and of its levels of detail then adds the levels of detail to the pool
+		static void CreateMeshGPUResources(Mesh& mesh);
 
 		ResourcePool<Texture2D> m_textures2D;
 		ResourcePool<Shader> m_shaders;
 		ResourcePool<Material> m_materials;
 		ResourcePool<Mesh> m_meshes;
 
+		// requests in the order they were made, only accessed from the main thread
+		ADynArr<AsyncLoadRequest*> m_pendingLoads;
+		JobCounter m_decodeCounter;
+		AUnorderedMap<MeshHandle, bool> m_loadingMeshes;
+		ADynArr<MeshHandle> m_finalizedMeshes;
+
 	};
 }
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+#include "AstralEngine/Core/Core.h"
+
+#include <new>
+
+namespace AstralEngine
+{
+	/*allocators used by the containers to get the raw storage of their elements, the memory
+	  returned is uninitialized and the containers construct and destroy the elements in it
+
+	  an allocator provides
+	    T* Allocate(size_t count)
+	    void Deallocate(T* ptr, size_t count)
+	    bool IsInline(const T* ptr) const, true if the storage lives inside the allocator and
+	        cannot be handed over to another container when moving it
+	    s_inlineCount, number of elements that fit in the inline storage
+	*/
+	template<typename T>
+	class AHeapAllocator
+	{
+	public:
+		static constexpr size_t s_inlineCount = 0;
+
+		T* Allocate(size_t count)
+		{
+			if (count == 0)
+			{
+				return nullptr;
+			}
+			return (T*)::operator new(count * sizeof(T));
+		}
+
+		void Deallocate(T* ptr, size_t count)
+		{
+			::operator delete(ptr);
+		}
+
+		bool IsInline(const T* ptr) const { return false; }
+	};
+
+	/*hands out a buffer of N elements stored inside the allocator itself and falls back to the
+	  heap for anything larger, used by ASmallArr so short lived arrays which stay small never
+	  allocate. The buffer can only be used by one allocation at a time
+	*/
+	template<typename T, size_t N>
+	class AInlineAllocator
+	{
+	public:
+		static constexpr size_t s_inlineCount = N;
+
+		AInlineAllocator() : m_inlineUsed(false) { }
+
+		//the buffer belongs to the container holding the allocator so it is never copied
+		AInlineAllocator(const AInlineAllocator&) = delete;
+		AInlineAllocator& operator=(const AInlineAllocator&) = delete;
+
+		T* Allocate(size_t count)
+		{
+			if (count <= N && !m_inlineUsed)
+			{
+				m_inlineUsed = true;
+				return (T*)m_buffer;
+			}
+			return AHeapAllocator<T>().Allocate(count);
+		}
+
+		void Deallocate(T* ptr, size_t count)
+		{
+			if (IsInline(ptr))
+			{
+				m_inlineUsed = false;
+				return;
+			}
+			AHeapAllocator<T>().Deallocate(ptr, count);
+		}
+
+		bool IsInline(const T* ptr) const { return ptr == (const T*)m_buffer; }
+
+	private:
+		alignas(T) unsigned char m_buffer[N * sizeof(T)];
+		bool m_inlineUsed;
+	};
+}
@@ -1,5 +1,5 @@
 #pragma once
-#include "ASinglyLinkedList.h"
+#include "ADynArr.h"
 #include <type_traits>
 #include <tuple>
 #include <functional>
@@ -203,6 +203,11 @@ namespace AstralEngine
 	template<typename...>
 	class Sink;
 
+	/*the delegates are stored contiguously and called from the most recently added one to the first.
+	  Delegates can be added or removed by the delegates being called: a removed delegate is only 
+	  cleared while a dispatch is running and the array is compacted by the next modification made 
+	  outside of one, delegates added during a dispatch are called from the next one
+	*/
 	template<typename Return, typename... Args>
 	class SignalHandler<Return(Args...)>
 	{
@@ -210,41 +215,168 @@ namespace AstralEngine
 
 		using DelegateType = ADelegate<Return(Args...)>;
 	public:
+		SignalHandler() : m_removedCount(0), m_dispatchDepth(0) { }
+
+		SignalHandler(const SignalHandler<Return(Args...)>& other) 
+			: m_delegates(other.m_delegates), m_removedCount(other.m_removedCount), m_dispatchDepth(0) { }
 
 		void AddDelegate(const DelegateType& d)
 		{
+			Compact();
 			m_delegates.Add(d);
 		}
 
 		void RemoveDelegate(const DelegateType& d)
 		{
-			m_delegates.Remove(d);
+			//the most recently added match is removed like the linked list used to
+			for (size_t i = m_delegates.GetCount(); i > 0; i--)
+			{
+				if (m_delegates[i - 1] == d)
+				{
+					if (m_dispatchDepth > 0)
+					{
+						m_delegates[i - 1].FreeFunction();
+						m_removedCount++;
+					}
+					else
+					{
+						m_delegates.RemoveAt(i - 1);
+					}
+					break;
+				}
+			}
+			Compact();
 		}
 
-		void CallDelagates(Args... args) const
+		void CallDelegates(Args... args) const
 		{
-			for (DelegateType func : m_delegates)
+			if (m_delegates.IsEmpty())
 			{
-				func(std::forward<Args>(args)...);
+				return;
 			}
+
+			DispatchScope scope(*this);
+			for (size_t i = m_delegates.GetCount(); i > 0; i--)
+			{
+				//copied since the array can grow while the delegate runs
+				DelegateType func = m_delegates[i - 1];
+				if (func.HasFunction())
+				{
+					func(std::forward<Args>(args)...);
+				}
+			}
+		}
+
+		/*calls the delegates once per entity in [first, first + count), used by the bulk component 
+		  operations of the registry for signals with the signature void(Owner&, const Entity)
+		  
+		  every delegate is called for an entity before moving to the next one so the order is the
+		  same as calling CallDelegates for each entity
+		*/
+		template<typename Owner, typename Entity>
+		void CallDelegates(Owner& owner, const Entity* first, size_t count) const
+		{
+			static_assert(std::is_invocable_v<DelegateType, Owner&, const Entity&>, 
+				"Batched dispatch requires a void(Owner&, const Entity) signal");
+
+			if (m_delegates.IsEmpty() || count == 0)
+			{
+				return;
+			}
+
+			DispatchScope scope(*this);
+			const size_t delegateCount = m_delegates.GetCount();
+			for (size_t e = 0; e < count; e++)
+			{
+				for (size_t i = delegateCount; i > 0; i--)
+				{
+					DelegateType func = m_delegates[i - 1];
+					if (func.HasFunction())
+					{
+						func(owner, first[e]);
+					}
+				}
+			}
+		}
+
+		//kept for the code written before the spelling was fixed
+		void CallDelagates(Args... args) const
+		{
+			CallDelegates(std::forward<Args>(args)...);
 		}
 
 		void Clear()
 		{
+			if (m_dispatchDepth > 0)
+			{
+				for (DelegateType& d : m_delegates)
+				{
+					if (d.HasFunction())
+					{
+						d.FreeFunction();
+						m_removedCount++;
+					}
+				}
+				return;
+			}
+
 			m_delegates.Clear();
+			m_removedCount = 0;
 		}
 
-		size_t GetCount() const { return m_delegates.GetCount(); }
+		size_t GetCount() const { return m_delegates.GetCount() - m_removedCount; }
 
-		bool IsEmpty() const { return m_delegates.IsEmpty(); }
+		bool IsEmpty() const { return GetCount() == 0; }
 
 		void operator()(Args... args) const
 		{
-			CallDelagates(std::forward<Args>(args)...);
+			CallDelegates(std::forward<Args>(args)...);
+		}
+
+		SignalHandler<Return(Args...)>& operator=(const SignalHandler<Return(Args...)>& other)
+		{
+			if (this != &other)
+			{
+				AE_DATASTRUCT_ASSERT(m_dispatchDepth == 0, "SignalHandler assigned while calling its delegates");
+				m_delegates = other.m_delegates;
+				m_removedCount = other.m_removedCount;
+			}
+			return *this;
 		}
 
 	private:
-		ASinglyLinkedList<DelegateType> m_delegates;
+		//counts the dispatches in progress (delegates can trigger the signal again)
+		struct DispatchScope
+		{
+			DispatchScope(const SignalHandler<Return(Args...)>& handler) : m_handler(handler) { m_handler.m_dispatchDepth++; }
+			~DispatchScope() { m_handler.m_dispatchDepth--; }
+
+			const SignalHandler<Return(Args...)>& m_handler;
+		};
+
+		//removes the delegates cleared during a dispatch, keeps the order of the others
+		void Compact()
+		{
+			if (m_removedCount == 0 || m_dispatchDepth > 0)
+			{
+				return;
+			}
+
+			size_t count = 0;
+			for (size_t i = 0; i < m_delegates.GetCount(); i++)
+			{
+				if (m_delegates[i].HasFunction())
+				{
+					m_delegates[count++] = m_delegates[i];
+				}
+			}
+			m_delegates.Resize(count);
+			m_removedCount = 0;
+		}
+
+		ADynArr<DelegateType> m_delegates;
+		size_t m_removedCount;
+		mutable unsigned int m_dispatchDepth;
 	};
 
 
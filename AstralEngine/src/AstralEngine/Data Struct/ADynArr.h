@@ -1,66 +1,70 @@
 #pragma once
 #include "AstralEngine/Core/Core.h"
 #include "AstralEngine/Debug/Instrumentor.h"
+#include "AAllocator.h"
+
+#include <type_traits>
+#include <cstring>
 
 
 namespace AstralEngine
 {
-	template<typename T>
+	template<typename T, typename Allocator = AHeapAllocator<T>>
 	class ADynArr;
 
-	template<typename T>
+	template<typename T, typename Allocator = AHeapAllocator<T>>
 	class ADynArrIterator
 	{
-		friend class ADynArr<T>;
+		friend class ADynArr<T, Allocator>;
 	public:
-		ADynArrIterator(const ADynArrIterator<T>& other) : m_pos(other.m_pos), m_arr(other.m_arr) { }
+		ADynArrIterator(const ADynArrIterator<T, Allocator>& other) : m_pos(other.m_pos), m_arr(other.m_arr) { }
 
 		virtual ~ADynArrIterator() { }
 
-		ADynArrIterator<T>& operator++()
+		ADynArrIterator<T, Allocator>& operator++()
 		{
 			m_pos++;
 			return *this;
 		}
 
-		ADynArrIterator<T>& operator+=(size_t i)
+		ADynArrIterator<T, Allocator>& operator+=(size_t i)
 		{
 			m_pos += i;
 			return *this;
 		}
 
-		ADynArrIterator<T> operator++(int)
+		ADynArrIterator<T, Allocator> operator++(int)
 		{
-			ADynArrIterator<T> copy = *this;
+			ADynArrIterator<T, Allocator> copy = *this;
 			this->operator++();
 			return copy;
 		}
 
-		ADynArrIterator<T>& operator--()
+		ADynArrIterator<T, Allocator>& operator--()
 		{
 			m_pos--;
 			return *this;
 		}
 
-		ADynArrIterator<T>& operator-=(size_t i)
+		ADynArrIterator<T, Allocator>& operator-=(size_t i)
 		{
 			m_pos -= i;
 			return *this;
 		}
 
-		ADynArrIterator<T> operator--(int)
+		ADynArrIterator<T, Allocator> operator--(int)
 		{
-			ADynArrIterator<T> copy = *this;
+			ADynArrIterator<T, Allocator> copy = *this;
 			this->operator--();
 			return copy;
 		}
 
-		bool operator==(const ADynArrIterator<T>& other) const
+		bool operator==(const ADynArrIterator<T, Allocator>& other) const
 		{
 			return m_pos == other.m_pos && m_arr == other.m_arr;
 		}
 
-		bool operator!=(const ADynArrIterator<T>& other) const
+		bool operator!=(const ADynArrIterator<T, Allocator>& other) const
 		{
 			return !(*this == other);
 		}
@@ -71,124 +75,126 @@ namespace AstralEngine
 		}
 
 	protected:
-		ADynArrIterator(size_t pos, ADynArr<T>* arr) : m_pos(pos), m_arr(arr) { }
+		ADynArrIterator(size_t pos, ADynArr<T, Allocator>* arr) : m_pos(pos), m_arr(arr) { }
 
 	private:
 		size_t m_pos;
-		ADynArr<T>* m_arr;
+		ADynArr<T, Allocator>* m_arr;
 	};
 
-	template<typename T>
-	class ADynArrConstIterator : public ADynArrIterator<T>
+	template<typename T, typename Allocator = AHeapAllocator<T>>
+	class ADynArrConstIterator : public ADynArrIterator<T, Allocator>
 	{
-		friend class ADynArr<T>;
+		friend class ADynArr<T, Allocator>;
 	public:
-		ADynArrConstIterator(const ADynArrConstIterator<T>& other) : ADynArrIterator<T>(other) { }
+		ADynArrConstIterator(const ADynArrConstIterator<T, Allocator>& other) : ADynArrIterator<T, Allocator>(other) { }
 
-		virtual ADynArrConstIterator<T>& operator++()
+		virtual ADynArrConstIterator<T, Allocator>& operator++()
 		{
-			ADynArrIterator<T>::operator++();
+			ADynArrIterator<T, Allocator>::operator++();
 			return *this;
 		}
 
-		virtual ADynArrConstIterator<T>& operator+=(size_t i)
+		virtual ADynArrConstIterator<T, Allocator>& operator+=(size_t i)
 		{
-			ADynArrIterator<T>::operator+=(i);
+			ADynArrIterator<T, Allocator>::operator+=(i);
 			return *this;
 		}
 
-		virtual ADynArrConstIterator<T> operator++(int)
+		virtual ADynArrConstIterator<T, Allocator> operator++(int)
 		{
-			ADynArrConstIterator<T> it = *this;
+			ADynArrConstIterator<T, Allocator> it = *this;
 			this->operator++();
 			return it;
 		}
 
-		virtual ADynArrConstIterator<T>& operator--()
+		virtual ADynArrConstIterator<T, Allocator>& operator--()
 		{
-			ADynArrIterator<T>::operator--();
+			ADynArrIterator<T, Allocator>::operator--();
 			return *this;
 		}
 
-		virtual ADynArrConstIterator<T>& operator-=(size_t i)
+		virtual ADynArrConstIterator<T, Allocator>& operator-=(size_t i)
 		{
-			ADynArrIterator<T>::operator-=(i);
+			ADynArrIterator<T, Allocator>::operator-=(i);
 			return *this;
 		}
 
-		virtual ADynArrConstIterator<T> operator--(int)
+		virtual ADynArrConstIterator<T, Allocator> operator--(int)
 		{
 			
-			ADynArrConstIterator<T> it = *this;
+			ADynArrConstIterator<T, Allocator> it = *this;
 			this->operator--();
 			return it;
 		}
 
-		virtual bool operator==(const ADynArrConstIterator<T>& other) const
+		virtual bool operator==(const ADynArrConstIterator<T, Allocator>& other) const
 		{
-			return ADynArrIterator<T>::operator==(other);
+			return ADynArrIterator<T, Allocator>::operator==(other);
 		}
 
-		virtual bool operator!=(const ADynArrConstIterator<T>& other) const
+		virtual bool operator!=(const ADynArrConstIterator<T, Allocator>& other) const
 		{
 			return !(*this == other);
 		}
 
 		const T& operator*() const
 		{
-			return ADynArrIterator<T>::operator*();
+			return ADynArrIterator<T, Allocator>::operator*();
 		}
 
 	private:
-		ADynArrConstIterator(size_t pos, const ADynArr<T>* arr) : ADynArrIterator<T>(pos, const_cast<ADynArr<T>*>(arr)) { }
+		ADynArrConstIterator(size_t pos, const ADynArr<T, Allocator>* arr) : ADynArrIterator<T, Allocator>(pos, const_cast<ADynArr<T, Allocator>*>(arr)) { }
 	};
 
-	template<typename T>
-	class ADynArr sealed
+	/*array which grows as elements are added, the elements are constructed in place in raw storage 
+	  obtained from Allocator so the unused capacity holds no constructed object
+	*/
+	template<typename T, typename Allocator>
+	class ADynArr sealed : private Allocator
 	{
-		friend class ADynArrIterator<T>;
+		friend class ADynArrIterator<T, Allocator>;
 	public:
-		using AIterator = ADynArrIterator<T>;
-		using AConstIterator = ADynArrConstIterator<T>;
+		using AIterator = ADynArrIterator<T, Allocator>;
+		using AConstIterator = ADynArrConstIterator<T, Allocator>;
 
-		ADynArr(const std::initializer_list<T>& list, size_t reserve = 0) : m_maxCount(list.size() + reserve), m_count(list.size())
+		ADynArr(const std::initializer_list<T>& list, size_t reserve = 0) : m_count(0)
 		{
-			m_arr = new T[list.size() + reserve];
+			m_maxCount = list.size() + reserve;
+			m_arr = AllocateStorage(m_maxCount);
 
-			size_t i = 0;
 			for (typename std::initializer_list<T>::iterator it = list.begin(); it != list.end(); it++)
 			{
-				m_arr[i] = *it;
-				i++;
+				new (&m_arr[m_count]) T(*it);
+				m_count++;
 			}
 		}
 		
-		ADynArr(size_t startMax = 5) : m_maxCount(startMax), m_count(0)
+		ADynArr(size_t startMax = s_defaultCapacity) : m_count(0), m_maxCount(startMax)
 		{
-			m_arr = new T[m_maxCount];
+			m_arr = AllocateStorage(m_maxCount);
 		}
 
-		ADynArr(const ADynArr<T>& other) : m_count(other.m_count), m_maxCount(other.m_maxCount)
+		ADynArr(const ADynArr<T, Allocator>& other) : Allocator(), m_count(0), m_maxCount(other.m_count)
 		{
-			m_arr = new T[m_maxCount];
+			m_arr = AllocateStorage(m_maxCount);
 
 			for (size_t i = 0; i < other.GetCount(); i++)
 			{
-				m_arr[i] = other[i];
+				new (&m_arr[i]) T(other[i]);
 			}
+			m_count = other.m_count;
 		}
 
-		ADynArr(ADynArr<T>&& other) : m_count(other.m_count), m_maxCount(other.m_maxCount)
+		ADynArr(ADynArr<T, Allocator>&& other) : Allocator(), m_arr(nullptr), m_count(0), m_maxCount(0)
 		{
-			m_arr = other.m_arr;
-
-			other.m_arr = nullptr;
-			other.m_count = 0;
+			TakeStorage(other);
 		}
 
 		~ADynArr()
 		{
-			delete[] m_arr;
+			DestroyElements(0, m_count);
+			Allocator::Deallocate(m_arr, m_maxCount);
 		}
 
 		size_t GetCount() const 
@@ -203,45 +209,28 @@ namespace AstralEngine
 
 		void Add(T&& element)
 		{
-			
-			CheckSize();
-			m_arr[m_count] = std::move(element);
-			m_count++;
+			EmplaceBack(std::move(element));
 		}
 
 		void Add(const T& element)
 		{
-			
-			CheckSize();
-			m_arr[m_count] = element;
-			m_count++;
+			EmplaceBack(element);
 		}
 
+		//constructs the element at the front of the array
 		template<typename... Args>
 		T& Emplace(Args&&... args)
 		{
-			
-			CheckSize();
-
-			for (size_t i = m_count; i > 0; i--)
-			{
-				m_arr[i] = m_arr[i - 1];
-			}
-			m_arr[0] = T(std::forward<Args>(args)...);
-			m_count++;
-
-			return m_arr[0];
+			return EmplaceAt(0, std::forward<Args>(args)...);
 		}
 
 		void AddFirst(T&& element)
 		{
-			
 			Insert(std::move(element), 0);
 		}
 
 		void AddFirst(const T& element) 
 		{
-			
 			Insert(element, 0);	
 		}
 
@@ -258,38 +247,44 @@ namespace AstralEngine
 		template<typename... Args>
 		T& EmplaceBack(Args&&... args)
 		{
-			
-			CheckSize();
-			m_arr[m_count] = T(std::forward<Args>(args)...);
+			if (m_count < m_maxCount)
+			{
+				new (&m_arr[m_count]) T(std::forward<Args>(args)...);
+			}
+			else
+			{
+				//the element is constructed before the old storage is released as the arguments can refer to it
+				size_t newMax = GetGrownCapacity();
+				T* newArr = AllocateStorage(newMax);
+				new (&newArr[m_count]) T(std::forward<Args>(args)...);
+				Relocate(newArr, newMax);
+			}
 			m_count++;
-
 			return m_arr[m_count - 1];
 		}
 
 		template<typename... Args>
 		T& EmplaceAt(size_t index, Args&&... args)
 		{
-			
-			CheckSize();
-
-			if (m_count == 0)
+			AE_DATASTRUCT_ASSERT(index <= m_count, "Invalid index provided");
+			//the slots past m_count are not constructed so an index past the end appends instead
+			if (index >= m_count)
 			{
-				AE_DATASTRUCT_ASSERT(index == 0, "Invalid index provided");
 				return EmplaceBack(std::forward<Args>(args)...);
 			}
 
-			for (size_t i = m_count - 1; i >= index; i--)
+			T element(std::forward<Args>(args)...);
+			EmplaceBack(std::move(m_arr[m_count - 1]));
+			for (size_t i = m_count - 2; i > index; i--)
 			{
-				m_arr[i + 1] = std::move(m_arr[i]);
+				m_arr[i] = std::move(m_arr[i - 1]);
 			}
-			m_arr[index] = T(std::forward<Args>(args)...);
-			m_count++;
+			m_arr[index] = std::move(element);
 			return m_arr[index];
 		}
 		
 		size_t Find(const T& element) const
 		{
-			
 			for (size_t i = 0; i < m_count; i++)
 			{
 				if (m_arr[i] == element)
@@ -312,57 +307,26 @@ namespace AstralEngine
 
 		void Insert(T&& element, size_t index)
 		{
-			
-			CheckSize();
-
-			if (m_count == 0)
-			{
-				AE_DATASTRUCT_ASSERT(index == 0, "Invalid index provided");
-				Add(element);
-				return;
-			}
-
-			for (size_t i = m_count - 1; i >= index; i--)
-			{
-				m_arr[i + 1] = std::move(m_arr[i]);
-			}
-			m_arr[index] = std::move(element);
-			m_count++;
+			EmplaceAt(index, std::move(element));
 		}
 
 		void Insert(const T& element, size_t index)
 		{
-			
-			CheckSize();
-			
-			if (m_count == 0)
-			{
-				AE_DATASTRUCT_ASSERT(index == 0, "Invalid index provided");
-				Add(element);
-				return;
-			}
-
-			for (size_t i = m_count - 1; i >= index; i--)
-			{
-				m_arr[i + 1] = std::move(m_arr[i]);
-			}
-			m_arr[index] = element;
-			m_count++;
+			EmplaceAt(index, element);
 		}
 
 		void Insert(T&& element, const AIterator& it)
 		{
-			Insert(std::forward(element), it.m_pos);
+			Insert(std::move(element), it.m_pos);
 		}
 
 		void Insert(T&& element, const AConstIterator& it)
 		{
-			Insert(std::forward(element), it.m_pos);
+			Insert(std::move(element), it.m_pos);
 		}
 
 		void Remove(const T& element)
 		{
-			
 			size_t index = Find(element);
 			if (index != -1)
 			{
@@ -370,65 +334,95 @@ namespace AstralEngine
 			}
 		}
 
+		//keeps the order of the elements by shifting the ones after index
 		void RemoveAt(size_t index)
 		{
-			
-			
-			if (index == m_count - 1)
+			AE_DATASTRUCT_ASSERT(index < m_count, "Index out of bounds");
+			for (size_t i = index + 1; i < m_count; i++)
 			{
-				m_count--;
-				return;
+				m_arr[i - 1] = std::move(m_arr[i]);
 			}
+			m_count--;
+			m_arr[m_count].~T();
+		}
 
-			for (size_t i = index; i < m_count; i++)
+		//moves the last element in place of the removed one, constant time but does not keep the order
+		void RemoveAtSwap(size_t index)
+		{
+			AE_DATASTRUCT_ASSERT(index < m_count, "Index out of bounds");
+			if (index != m_count - 1)
 			{
-				m_arr[i] = std::move(m_arr[i + 1]);
+				m_arr[index] = std::move(m_arr[m_count - 1]);
 			}
 			m_count--;
+			m_arr[m_count].~T();
 		}
 
-		void Remove(ADynArr<T>::AIterator iterator)
+		void Remove(AIterator iterator)
 		{
-			int index = (iterator.m_ptr - m_arr) / sizeof(T);
-			Remove(index);
+			RemoveAt(iterator.m_pos);
 		}
 
 		void ShrinkToFit()
 		{
-			T* newArr = new T[m_count];
-
-			for (size_t i = 0; i < m_count; i++)
+			//inline storage is not released by shrinking
+			if (m_count == m_maxCount || Allocator::IsInline(m_arr))
 			{
-				newArr[i] == m_arr[i];
+				return;
 			}
 
-			delete[] m_arr;
-			m_arr = newArr;
-			m_maxCount = m_count;
+			size_t newMax = m_count;
+			T* newArr = AllocateStorage(newMax);
+			Relocate(newArr, newMax);
 		}
 
+		//makes sure count more elements can be added without reallocating
 		void Reserve(size_t count)
 		{
-			
 			size_t currentCount = m_maxCount - m_count;
 			if (currentCount < count)
 			{
 				size_t newMax = m_maxCount + count - currentCount;
-				T* temp = new T[newMax];
+				T* newArr = AllocateStorage(newMax);
+				Relocate(newArr, newMax);
+			}
+		}
 
-				for (size_t i = 0; i < m_count; i++)
-				{
-					temp[i] = std::move(m_arr[i]);
-				}
-				
-				delete[] m_arr;
-				m_arr = temp;
-				m_maxCount = newMax;
+		//value initializes the added elements and destroys the removed ones
+		void Resize(size_t count)
+		{
+			ResizeStorage(count);
+			for (size_t i = m_count; i < count; i++)
+			{
+				new (&m_arr[i]) T();
 			}
+			m_count = count;
 		}
 
+		void Resize(size_t count, const T& value)
+		{
+			ResizeStorage(count);
+			for (size_t i = m_count; i < count; i++)
+			{
+				new (&m_arr[i]) T(value);
+			}
+			m_count = count;
+		}
+
+		/*changes the count without writing the added elements, for buffers which are
+		  filled through GetData right after (file reads, gpu readbacks...)
+		*/
+		void ResizeUninitialized(size_t count)
+		{
+			static_assert(std::is_trivial<T>::value, "Only arrays of trivial types can hold uninitialized elements");
+			ResizeStorage(count);
+			m_count = count;
+		}
+
+		//destroys the elements but keeps the storage
 		void Clear()
 		{
+			DestroyElements(0, m_count);
 			m_count = 0;
 		}
 
@@ -455,42 +449,42 @@ namespace AstralEngine
 		
 		AIterator begin()
 		{
-			return ADynArrIterator<T>(0, this); 
+			return AIterator(0, this); 
 		}
 		
 		AIterator end()
 		{
-			return ADynArrIterator<T>(m_count, this); 
+			return AIterator(m_count, this); 
 		}
 
 		AIterator rbegin() 
 		{
-			return ADynArrIterator<T>(m_count - 1, this);
+			return AIterator(m_count - 1, this);
 		}
 		
 		AIterator rend() 
 		{
-			return ADynArrIterator<T>(-1, this);
+			return AIterator(-1, this);
 		}
 
 		AConstIterator begin() const
 		{
-			return ADynArrConstIterator<T>(0, this);
+			return AConstIterator(0, this);
 		}
 
 		AConstIterator end() const
 		{
-			return ADynArrConstIterator<T>(m_count, this);
+			return AConstIterator(m_count, this);
 		}
 
 		AConstIterator rbegin() const
 		{
-			return ADynArrConstIterator<T>(m_count - 1, this);
+			return AConstIterator(m_count - 1, this);
 		}
 
 		AConstIterator rend() const
 		{
-			return ADynArrConstIterator<T>(-1, this);
+			return AConstIterator(-1, this);
 		}
 
 
@@ -506,9 +500,8 @@ namespace AstralEngine
 			return m_arr[index];
 		}
 
-		bool operator==(const ADynArr<T>& other) const
+		bool operator==(const ADynArr<T, Allocator>& other) const
 		{
-			
 			if (GetCount() != other.GetCount())
 			{
 				return false;
@@ -524,74 +517,152 @@ namespace AstralEngine
 			return true;
 		}
 
-		bool operator!=(const ADynArr<T>& other) const 
+		bool operator!=(const ADynArr<T, Allocator>& other) const 
 		{
-			 
 			return !(*this == other); 
 		}
 
-		ADynArr<T>& operator=(const ADynArr<T>& other) 
+		ADynArr<T, Allocator>& operator=(const ADynArr<T, Allocator>& other) 
 		{
-			if (m_maxCount != other.m_maxCount)
+			if (this == &other)
 			{
-				delete[] m_arr;
-				m_arr = new T[other.m_maxCount];
+				return *this;
 			}
 
-
-			for (size_t i = 0 ; i < other.GetCount(); i++)
+			Clear();
+			if (m_maxCount < other.m_count)
 			{
-				m_arr[i] = std::move(other[i]);
+				Allocator::Deallocate(m_arr, m_maxCount);
+				m_maxCount = other.m_count;
+				m_arr = AllocateStorage(m_maxCount);
 			}
 
+			for (size_t i = 0; i < other.GetCount(); i++)
+			{
+				new (&m_arr[i]) T(other[i]);
+			}
 			m_count = other.m_count;
-			m_maxCount = other.m_maxCount;
 			return *this;
 		}
 
-		ADynArr<T>& operator=(ADynArr<T>&& other)
+		ADynArr<T, Allocator>& operator=(ADynArr<T, Allocator>&& other)
 		{
-			delete[] m_arr;
-
-			m_arr = other.m_arr;
-			m_count = other.m_count;
-			m_maxCount = other.m_maxCount;
-
-			other.m_arr = nullptr;
-			other.m_count = 0;
+			if (this != &other)
+			{
+				Clear();
+				TakeStorage(other);
+			}
 			return *this;
 		}
 
 	private:
-		
-		void CheckSize()
+		//arrays with inline storage start with all of it so they do not reallocate before it is full
+		static constexpr size_t s_defaultCapacity = Allocator::s_inlineCount > 0 ? Allocator::s_inlineCount : 5;
+
+		//the allocator can hand out more than what was asked for when it uses its inline storage
+		T* AllocateStorage(size_t& capacity)
 		{
-			
-			if (m_count >= m_maxCount)
+			T* arr = Allocator::Allocate(capacity);
+			if (Allocator::IsInline(arr))
 			{
-				Resize();
+				capacity = Allocator::s_inlineCount;
 			}
+			return arr;
 		}
 
-		void Resize()
+		size_t GetGrownCapacity() const
 		{
-			
-			size_t newMax = (size_t)((float)m_maxCount * 1.5f) + (size_t)1;
-			T* temp = new T[newMax];
+			return (size_t)((float)m_maxCount * 1.5f) + (size_t)1;
+		}
 
-			for (size_t i = 0; i < m_count; i++)
+		//moves the elements to newArr and releases the current storage
+		void Relocate(T* newArr, size_t newMax)
+		{
+			if constexpr (std::is_trivially_copyable<T>::value)
+			{
+				if (m_count > 0)
+				{
+					std::memcpy(newArr, m_arr, m_count * sizeof(T));
+				}
+			}
+			else
 			{
-				temp[i] = std::move(m_arr[i]);
+				for (size_t i = 0; i < m_count; i++)
+				{
+					new (&newArr[i]) T(std::move(m_arr[i]));
+					m_arr[i].~T();
+				}
 			}
 
-			delete[] m_arr;
-			m_arr = temp;
+			Allocator::Deallocate(m_arr, m_maxCount);
+			m_arr = newArr;
 			m_maxCount = newMax;
 		}
 
+		void ResizeStorage(size_t count)
+		{
+			if (count < m_count)
+			{
+				DestroyElements(count, m_count);
+				m_count = count;
+			}
+			else if (count > m_maxCount)
+			{
+				T* newArr = AllocateStorage(count);
+				Relocate(newArr, count);
+			}
+		}
+
+		void DestroyElements(size_t start, size_t end)
+		{
+			if constexpr (!std::is_trivially_destructible<T>::value)
+			{
+				for (size_t i = start; i < end; i++)
+				{
+					m_arr[i].~T();
+				}
+			}
+		}
+
+		/*takes the elements of other which is left empty, inline storage cannot change owner 
+		  so its elements are moved one by one. Expects this array to hold no element
+		*/
+		void TakeStorage(ADynArr<T, Allocator>& other)
+		{
+			if (other.Allocator::IsInline(other.m_arr))
+			{
+				if (m_maxCount < other.m_count)
+				{
+					Allocator::Deallocate(m_arr, m_maxCount);
+					m_maxCount = other.m_count;
+					m_arr = AllocateStorage(m_maxCount);
+				}
+
+				for (size_t i = 0; i < other.m_count; i++)
+				{
+					new (&m_arr[i]) T(std::move(other.m_arr[i]));
+				}
+				m_count = other.m_count;
+				other.Clear();
+				return;
+			}
+
+			Allocator::Deallocate(m_arr, m_maxCount);
+			m_arr = other.m_arr;
+			m_count = other.m_count;
+			m_maxCount = other.m_maxCount;
+
+			other.m_arr = nullptr;
+			other.m_count = 0;
+			other.m_maxCount = 0;
+		}
+
 		T* m_arr;
 		size_t m_count;
 		size_t m_maxCount;
 	};
 
-}
\ No newline at end of file
+	//array holding up to N elements inside itself before it moves them to the heap
+	template<typename T, size_t N>
+	using ASmallArr = ADynArr<T, AInlineAllocator<T, N>>;
+}
@@ -11,6 +11,9 @@ namespace AstralEngine
 		AKeyElementPair(const AKeyElementPair<K, T>& other) : m_key(other.m_key),
 			m_element(other.m_element), m_equalsFunc(other.m_equalsFunc) { }
 
+		AKeyElementPair(AKeyElementPair<K, T>&& other) noexcept : m_key(std::move(other.m_key)),
+			m_element(std::move(other.m_element)), m_equalsFunc(other.m_equalsFunc) { }
+
 		AKeyElementPair(const K& k, ADelegate<bool(const K&, const K&)> equals = DefaultEquals)
 			: m_equalsFunc(equals), m_key(k) { }
 
@@ -31,6 +34,9 @@ namespace AstralEngine
 		AKeyElementPair(const K& k, Args... args, std::function<bool(const K&, const K&)> equals)
 			: m_equalsFunc(equals), m_key(k), m_element(std::forward<Args>(args)...) { }
 
+		AKeyElementPair<K, T>& operator=(const AKeyElementPair<K, T>& other) = default;
+		AKeyElementPair<K, T>& operator=(AKeyElementPair<K, T>&& other) = default;
+
 		bool operator==(const AKeyElementPair<K, T>& other) const
 		{
 			return m_equalsFunc(m_key, other.m_key);
@@ -0,0 +1,146 @@
+#pragma once
+#include "AstralEngine/Core/Core.h"
+#include "ADynArr.h"
+
+#include <new>
+
+namespace AstralEngine
+{
+	/*allocator which hands out memory by bumping an offset inside large blocks of memory.
+	  Allocations cannot be freed individually, Reset releases all of them at once while
+	  keeping the blocks so once the allocator reached the size it needs no more heap
+	  allocations are made
+
+	  destructors are never called so only use it for types which do not own any resource
+	*/
+	class ALinearAllocator
+	{
+	public:
+		ALinearAllocator(size_t blockSize = s_defaultBlockSize)
+			: m_blockSize(blockSize), m_currBlock(0), m_offset(0), m_numHeapAllocations(0) { }
+
+		ALinearAllocator(const ALinearAllocator&) = delete;
+		ALinearAllocator& operator=(const ALinearAllocator&) = delete;
+
+		~ALinearAllocator()
+		{
+			ReleaseBlocks();
+		}
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+		{
+			AE_DATASTRUCT_ASSERT((alignment & (alignment - 1)) == 0, "alignment must be a power of two");
+
+			while (m_currBlock < m_blocks.GetCount())
+			{
+				void* ptr = AllocateFromBlock(m_blocks[m_currBlock], size, alignment);
+				if (ptr != nullptr)
+				{
+					return ptr;
+				}
+				m_currBlock++;
+				m_offset = 0;
+			}
+
+			//none of the blocks can hold the allocation, add a block large enough for it
+			AddBlock((std::max)(m_blockSize, size + alignment));
+			m_currBlock = m_blocks.GetCount() - 1;
+			return AllocateFromBlock(m_blocks[m_currBlock], size, alignment);
+		}
+
+		template<typename T, typename... Args>
+		T* New(Args&&... args)
+		{
+			return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		//default constructs count elements in a contiguous array
+		template<typename T>
+		T* NewArray(size_t count)
+		{
+			T* arr = (T*)Allocate(sizeof(T) * count, alignof(T));
+			for (size_t i = 0; i < count; i++)
+			{
+				new (&arr[i]) T();
+			}
+			return arr;
+		}
+
+		/*invalidates every allocation made so far, if more than one block was needed
+		  they are merged into a single block so the memory stays contiguous
+		*/
+		void Reset()
+		{
+			m_numHeapAllocations = 0;
+			m_currBlock = 0;
+			m_offset = 0;
+
+			if (m_blocks.GetCount() > 1)
+			{
+				size_t totalSize = GetCapacity();
+				ReleaseBlocks();
+				AddBlock(totalSize);
+			}
+		}
+
+		//number of blocks allocated on the heap since the last reset
+		size_t GetNumHeapAllocations() const { return m_numHeapAllocations; }
+
+		size_t GetCapacity() const
+		{
+			size_t capacity = 0;
+			for (const Block& block : m_blocks)
+			{
+				capacity += block.size;
+			}
+			return capacity;
+		}
+
+	private:
+		struct Block
+		{
+			unsigned char* data = nullptr;
+			size_t size = 0;
+		};
+
+		static constexpr size_t s_defaultBlockSize = 1024 * 1024;
+
+		//returns nullptr if the block does not have enough space left
+		void* AllocateFromBlock(Block& block, size_t size, size_t alignment)
+		{
+			size_t address = (size_t)block.data + m_offset;
+			size_t alignedOffset = m_offset + ((alignment - (address & (alignment - 1))) & (alignment - 1));
+			if (alignedOffset + size > block.size)
+			{
+				return nullptr;
+			}
+
+			m_offset = alignedOffset + size;
+			return block.data + alignedOffset;
+		}
+
+		void AddBlock(size_t size)
+		{
+			Block block;
+			block.data = new unsigned char[size];
+			block.size = size;
+			m_blocks.Add(block);
+			m_numHeapAllocations++;
+		}
+
+		void ReleaseBlocks()
+		{
+			for (Block& block : m_blocks)
+			{
+				delete[] block.data;
+			}
+			m_blocks.Clear();
+		}
+
+		ADynArr<Block> m_blocks;
+		size_t m_blockSize;
+		size_t m_currBlock;
+		size_t m_offset;
+		size_t m_numHeapAllocations;
+	};
+}
@@ -1,51 +1,177 @@
 #pragma once
+#include "AstralEngine/Core/Core.h"
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace AstralEngine
 {
 	template<typename T>
-	class AWeakPtr;
+	class AReference;
+
+	template<typename T>
+	class AWeakRef;
+
+	/*specialize for types whose references are copied or released by several threads at once
+	  (resources created by the loading jobs...), their counts are then updated atomically
+	*/
+	template<typename T>
+	struct AAtomicRefCount : std::false_type { };
+
+	/*counts shared by the references to an object. The strong references hold a single weak count
+	  between them so the block is released once the object is destroyed and no weak reference is left
 
-	struct ControlBlock
+	  both counts are atomics so the same block type serves every policy, without the atomic policy
+	  they are updated with plain loads and stores which compile to regular increments
+	*/
+	class ControlBlock
 	{
-	private:
 		template<typename T>
 		friend class AReference;
 		template<typename T>
 		friend class AWeakRef;
-		int count;
-		int weakCount;
-		void* ptr;
-		ControlBlock(void* p) : ptr(p), count(1), weakCount(0) { }
 
-		void DecrementWeak()
+	public:
+		using ReleaseFunc = void(*)(ControlBlock* block, void* ptr);
+
+		ControlBlock() : m_count(1), m_weakCount(1), m_ptr(nullptr), m_destroy(nullptr),
+			m_release(nullptr), m_atomic(false) { }
+
+	private:
+		// m_destroy destroys the object and m_release frees the memory of the block
+		void Init(void* ptr, ReleaseFunc destroy, ReleaseFunc release, bool atomic)
 		{
-			weakCount--;
-			DecrementCheck();
+			m_ptr = ptr;
+			m_destroy = destroy;
+			m_release = release;
+			m_atomic = atomic;
 		}
 
-		void DecrementStrong()
+		void IncrementStrong() { Increment(m_count); }
+
+		void IncrementWeak() { Increment(m_weakCount); }
+
+		//used to get a strong reference from a weak one, fails once the object is destroyed
+		bool TryIncrementStrong()
 		{
-			count--;
-			DecrementCheck();
+			int count = m_count.load(std::memory_order_relaxed);
+			if (!m_atomic)
+			{
+				if (count == 0)
+				{
+					return false;
+				}
+				m_count.store(count + 1, std::memory_order_relaxed);
+				return true;
+			}
+
+			while (count != 0)
+			{
+				if (m_count.compare_exchange_weak(count, count + 1, std::memory_order_relaxed))
+				{
+					return true;
+				}
+			}
+			return false;
 		}
 
-		void DecrementCheck()
+		void DecrementStrong()
 		{
-			if (count == 0)
+			if (Decrement(m_count) == 0)
 			{
-				if (weakCount == 0)
+				//without weak references nothing else can reach the block so it is released right away
+				void* ptr = m_ptr;
+				ReleaseFunc release = m_release;
+				bool hasWeakRefs = m_weakCount.load(std::memory_order_acquire) != 1;
+				m_destroy(this, ptr);
+
+				if (hasWeakRefs)
 				{
-					delete this;
+					DecrementWeak();
 				}
 				else
 				{
-					delete ptr;
-					ptr = nullptr;
+					release(this, ptr);
 				}
 			}
 		}
+
+		void DecrementWeak()
+		{
+			if (Decrement(m_weakCount) == 0)
+			{
+				m_release(this, m_ptr);
+			}
+		}
+
+		size_t GetStrongCount() const
+		{
+			return (size_t)m_count.load(std::memory_order_relaxed);
+		}
+
+		//does not count the weak count held by the strong references
+		size_t GetWeakCount() const
+		{
+			int weakCount = m_weakCount.load(std::memory_order_relaxed);
+			return (size_t)(GetStrongCount() > 0 ? weakCount - 1 : weakCount);
+		}
+
+		void Increment(std::atomic<int>& count)
+		{
+			if (m_atomic)
+			{
+				count.fetch_add(1, std::memory_order_relaxed);
+			}
+			else
+			{
+				count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			}
+		}
+
+		//returns the new count, acq_rel makes every write to the object visible to the thread destroying it
+		int Decrement(std::atomic<int>& count)
+		{
+			if (m_atomic)
+			{
+				return count.fetch_sub(1, std::memory_order_acq_rel) - 1;
+			}
+
+			int newCount = count.load(std::memory_order_relaxed) - 1;
+			count.store(newCount, std::memory_order_relaxed);
+			return newCount;
+		}
+
+		std::atomic<int> m_count;
+		std::atomic<int> m_weakCount;
+		void* m_ptr;
+		ReleaseFunc m_destroy;
+		ReleaseFunc m_release;
+		bool m_atomic;
 	};
 
+	/*base of the types which know their control block so a reference can be made back from a raw 
+	  pointer to them (this...) with AReference(T*)
+
+	  the block is allocated in front of the object by AReference::Create like for the other types,
+	  the counts thus outlive the object as long as weak references to it are left
+	*/
+	class ARefCounted
+	{
+		template<typename T>
+		friend class AReference;
+
+	protected:
+		ARefCounted() : m_refBlock(nullptr) { }
+
+		//the references are to the original object, a copy starts without any
+		ARefCounted(const ARefCounted&) : m_refBlock(nullptr) { }
+		ARefCounted& operator=(const ARefCounted&) { return *this; }
+
+	private:
+		ControlBlock* m_refBlock;
+	};
 
 	template<typename T>
 	class AReference
@@ -53,7 +179,7 @@ namespace AstralEngine
 		template<typename Other>
 		friend class AReference;
 
-		template<typename T>
+		template<typename Other>
 		friend class AWeakRef;
 
 	public:
@@ -61,28 +187,52 @@ namespace AstralEngine
 
 		AReference(std::nullptr_t) : m_block(nullptr) {	}
 
+		//only valid for objects created with Create
+		explicit AReference(T* ptr) : m_block(nullptr)
+		{
+			static_assert(std::is_base_of<ARefCounted, T>::value, "Only ARefCounted types can be referenced from a raw pointer");
+			if (ptr != nullptr)
+			{
+				m_block = static_cast<ARefCounted*>(ptr)->m_refBlock;
+				AE_DATASTRUCT_ASSERT(m_block != nullptr, "Object was not created with AReference::Create");
+				m_block->IncrementStrong();
+			}
+		}
+
 		template<typename Derived>
 		AReference(const AReference<Derived>& other) : m_block(other.m_block)
 		{
 			if (m_block != nullptr)
 			{
-				m_block->count++;
+				m_block->IncrementStrong();
 			}
 		}
-		
+
+		template<typename Derived>
+		AReference(AReference<Derived>&& other) : m_block(other.m_block)
+		{
+			other.m_block = nullptr;
+		}
+
 		AReference(const AReference<T>& other) : m_block(other.m_block)
 		{
-			if (other.m_block != nullptr)
+			if (m_block != nullptr)
 			{
-				m_block->count++;
+				m_block->IncrementStrong();
 			}
 		}
 
-		AReference(const AWeakRef<T>& other) : m_block(other.m_block)
+		AReference(AReference<T>&& other) noexcept : m_block(other.m_block)
+		{
+			other.m_block = nullptr;
+		}
+
+		//null if the object was already destroyed
+		AReference(const AWeakRef<T>& other) : m_block(nullptr)
 		{
-			if (other.m_block != nullptr)
+			if (other.m_block != nullptr && other.m_block->TryIncrementStrong())
 			{
-				m_block->count++;
+				m_block = other.m_block;
 			}
 		}
 
@@ -94,13 +244,13 @@ namespace AstralEngine
 			}
 		}
 
-		size_t GetStrongCount() const 
+		size_t GetStrongCount() const
 		{
 			if (m_block == nullptr)
 			{
 				return 0;
 			}
-			return m_block->count;
+			return m_block->GetStrongCount();
 		}
 
 		size_t GetWeakCount() const
@@ -109,72 +259,76 @@ namespace AstralEngine
 			{
 				return 0;
 			}
-			return m_block->weakCount;
+			return m_block->GetWeakCount();
 		}
 
-		T* Get() const { return (T*)m_block->ptr; }
+		T* Get() const { return m_block != nullptr ? (T*)m_block->m_ptr : nullptr; }
 
 		T* operator->() const
 		{
-			return (T*)m_block->ptr;
+			return (T*)m_block->m_ptr;
 		}
 
 		T& operator*() const
 		{
-			return *((T*)m_block->ptr);
+			return *((T*)m_block->m_ptr);
 		}
 
 
 		AReference<T>& operator=(std::nullptr_t)
 		{
-			if (m_block != nullptr)
+			ControlBlock* oldBlock = m_block;
+			m_block = nullptr;
+
+			if (oldBlock != nullptr)
 			{
-				m_block->DecrementStrong();
-				m_block = nullptr;
+				oldBlock->DecrementStrong();
 			}
-
 			return *this;
 		}
 
 		AReference<T>& operator=(const AReference<T>& other)
 		{
-			if (m_block != nullptr)
+			//the new object is referenced first in case releasing the old one releases other as well
+			ControlBlock* block = other.m_block;
+			if (block != nullptr)
 			{
-				m_block->DecrementStrong();
+				block->IncrementStrong();
 			}
 
-			m_block = other.m_block;
-			
 			if (m_block != nullptr)
 			{
-				m_block->count++;
+				m_block->DecrementStrong();
 			}
+
+			m_block = block;
 			return *this;
 		}
 
-		AReference<T>& operator=(const AWeakRef<T>& other)
+		AReference<T>& operator=(AReference<T>&& other) noexcept
 		{
-			if (m_block != nullptr)
+			if (this != &other)
 			{
-				m_block->DecrementStrong();
-			}
-			m_block = other.m_block;
+				ControlBlock* oldBlock = m_block;
+				m_block = other.m_block;
+				other.m_block = nullptr;
 
-			if (m_block != nullptr)
-			{
-				m_block->count++;
+				if (oldBlock != nullptr)
+				{
+					oldBlock->DecrementStrong();
+				}
 			}
 			return *this;
 		}
 
-		bool operator==(std::nullptr_t n) const
+		AReference<T>& operator=(const AWeakRef<T>& other)
 		{
-			if (m_block == nullptr)
-			{
-				return true;
-			}
+			return *this = AReference<T>(other);
+		}
 
-			return ((T*)m_block->ptr) == nullptr;
+		bool operator==(std::nullptr_t n) const
+		{
+			return m_block == nullptr;
 		}
 
 		bool operator!=(std::nullptr_t n) const
@@ -184,46 +338,65 @@ namespace AstralEngine
 
 		bool operator==(const AReference<T>& other) const
 		{
-			if (m_block == nullptr)
+			if (m_block == nullptr || other.m_block == nullptr)
 			{
-				return other.m_block == nullptr;
+				return m_block == other.m_block;
 			}
 
-			return *((T*)m_block->ptr) == *((T*)other.m_block->ptr);
+			return *Get() == *other.Get();
 		}
 
 		bool operator==(const AWeakRef<T>& other) const
 		{
-			if (m_block == nullptr)
-			{
-				return other.m_block == nullptr;
-			}
-
-			return *((T*)m_block->ptr) == *((T*)other.m_block->ptr);
+			return *this == AReference<T>(other);
 		}
 
 		bool operator!=(const AReference<T>& other) const
 		{
-			
 			return !(*this == other);
 		}
 
 		bool operator!=(const AWeakRef<T>& other) const
 		{
-			
 			return !(*this == other);
 		}
 
+		/*allocates the object and its control block together, ARefCounted types are given a pointer
+		  to their block once they are constructed
+		*/
 		template<typename... Args>
-		static AReference<T> Create(Args... args)
+		static AReference<T> Create(Args&&... args)
 		{
 			AReference<T> ref;
-			T* ptr = new T(std::forward<Args>(args)...);
-			ref.m_block = new ControlBlock(ptr);
+			Storage* storage = new Storage;
+			T* ptr = new (storage->object) T(std::forward<Args>(args)...);
+			ref.m_block = &storage->block;
+			ref.m_block->Init(ptr, &DestroyObject, &ReleaseStorage, AAtomicRefCount<T>::value);
+
+			if constexpr (std::is_base_of<ARefCounted, T>::value)
+			{
+				static_cast<ARefCounted*>(ptr)->m_refBlock = ref.m_block;
+			}
 			return ref;
 		}
 
 	private:
+		//the block comes first so a pointer to it is a pointer to the storage
+		struct Storage
+		{
+			ControlBlock block;
+			alignas(T) unsigned char object[sizeof(T)];
+		};
+
+		static void DestroyObject(ControlBlock* block, void* ptr)
+		{
+			((T*)ptr)->~T();
+		}
+
+		static void ReleaseStorage(ControlBlock* block, void* ptr)
+		{
+			delete (Storage*)block;
+		}
 
 		ControlBlock* m_block;
 	};
@@ -246,4 +419,4 @@ namespace AstralEngine
 	template<typename T>
 	using RemoveRef_t = typename RemoveRef<T>::type;
 
-}
\ No newline at end of file
+}
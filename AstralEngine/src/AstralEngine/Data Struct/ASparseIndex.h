@@ -0,0 +1,56 @@
+#pragma once
+#include <type_traits>
+
+namespace AstralEngine
+{
+	/*converts an element of an ASparseSet to its position in the sparse array, 
+	  overload this function for types which cannot simply be casted to an integer
+	*/
+	template<typename T>
+	constexpr size_t ToInt(const T x)
+	{
+		return (size_t) x;
+	}
+
+	using IDType = size_t;
+
+	enum class BaseEntity : IDType { };
+
+	constexpr auto ToIntegral(const BaseEntity entity)
+	{
+		return static_cast<std::underlying_type_t<BaseEntity>>(entity);
+	}
+
+	/*an entity identifier holds the index of the entity in the registry in its lower bits 
+	  and a generation in its upper bits, the generation is incremented every time the index 
+	  is recycled so handles to destroyed entities do not alias the entities created after them
+	*/
+	struct EntityTraits
+	{
+		static constexpr IDType IndexMask = 0xFFFFFFFF;
+		static constexpr IDType GenerationMask = 0xFFFFFFFF;
+		static constexpr IDType GenerationShift = 32;
+	};
+
+	constexpr IDType GetEntityIndex(const BaseEntity entity)
+	{
+		return ToIntegral(entity) & EntityTraits::IndexMask;
+	}
+
+	constexpr IDType GetEntityGeneration(const BaseEntity entity)
+	{
+		return (ToIntegral(entity) >> EntityTraits::GenerationShift) & EntityTraits::GenerationMask;
+	}
+
+	constexpr BaseEntity ComposeEntity(const IDType index, const IDType generation)
+	{
+		return static_cast<BaseEntity>((index & EntityTraits::IndexMask) 
+			| ((generation & EntityTraits::GenerationMask) << EntityTraits::GenerationShift));
+	}
+
+	//sparse sets of entities are indexed by the index part of the entity only
+	constexpr size_t ToInt(const BaseEntity entity)
+	{
+		return GetEntityIndex(entity);
+	}
+}
@@ -1,23 +1,15 @@
 #pragma once
-#include "AstralEngine/ECS/ECS Core/ECSUtils.h"
+#include "ASparseIndex.h"
 #include "ADynArr.h"
 #include "AUniqueRef.h"
 #include "ADelegate.h"
 #include "AKeyElementPair.h"
 
+//size in bytes of a single page of the sparse array of an ASparseSet
 #define AE_PAGE_SIZE 16384
 
 namespace AstralEngine
 {
-	template<typename T>
-	static size_t ToInt(const T x)
-	{
-		return (size_t) x;
-	}
-
-	template<typename...>
-	class ASparseSet;
-
 	//Similar ADynArr but the data does not have to be contiguous and can be spread 
 	//throughout the array with indices that are unassigned in the middle of the array
 	template<typename T>
@@ -28,25 +20,31 @@ namespace AstralEngine
 		class AConstIterator;
 
 		ResizableArr(size_t startSize = 5) 
-			: m_arr(new T[startSize]), m_count(0), m_maxCount(startSize) { }
+			: m_arr(m_allocator.Allocate(startSize)), m_count(0), m_maxCount(startSize) { }
 
 		~ResizableArr()
 		{
-			delete[] m_arr;
+			DestroyElements();
+			m_allocator.Deallocate(m_arr, m_maxCount);
 		}
 
 		void Add(const T& element)
 		{
-			CheckSize();
-			m_arr[m_count] = element;
-			m_count++;
+			EmplaceBack(element);
 		}
 
 		void Add(T&& element)
+		{
+			EmplaceBack(std::move(element));
+		}
+
+		template<typename... Args>
+		T& EmplaceBack(Args&&... args)
 		{
 			CheckSize();
-			m_arr[m_count] = std::move(element);
+			new (&m_arr[m_count]) T(std::forward<Args>(args)...);
 			m_count++;
+			return m_arr[m_count - 1];
 		}
 
 		// Returns the index of the largest valid index
@@ -66,24 +64,35 @@ namespace AstralEngine
 
 		void RemoveAt(size_t index)
 		{
-			if (index == m_count - 1)
+			for (size_t i = index + 1; i < m_count; i++)
 			{
-				m_count--;
-				return;
+				m_arr[i - 1] = std::move(m_arr[i]);
 			}
+			m_count--;
+			m_arr[m_count].~T();
+		}
 
-			for (size_t i = index; i < m_count; i++)
+		//moves the last element in place of the removed one
+		void RemoveAtSwap(size_t index)
+		{
+			if (index != m_count - 1)
 			{
-				m_arr[i] = std::move(m_arr[i + 1]);
+				m_arr[index] = std::move(m_arr[m_count - 1]);
 			}
 			m_count--;
+			m_arr[m_count].~T();
 		}
 
+		//accessing an index past the end default constructs the elements up to it
 		T& operator[](size_t index)
 		{
 			if (index >= m_count)
 			{
 				Reserve(index + 2);
+				for (size_t i = m_count; i <= index; i++)
+				{
+					new (&m_arr[i]) T();
+				}
 				m_count = index + 1;
 			}
 			return m_arr[index];
@@ -99,20 +108,17 @@ namespace AstralEngine
 			size_t currentCount = m_maxCount - m_count;
 			if (currentCount < count)
 			{
-				size_t newMax = m_maxCount + count - currentCount;
-				T* temp = new T[newMax];
-
-				for (size_t i = 0; i < m_count; i++)
-				{
-					temp[i] = std::move(m_arr[i]);
-				}
-
-				delete[] m_arr;
-				m_arr = temp;
-				m_maxCount = newMax;
+				Reallocate(m_maxCount + count - currentCount);
 			}
 		}
 
+		//destroys the elements so the resources they hold are released without reallocating the array
+		void Clear()
+		{
+			DestroyElements();
+			m_count = 0;
+		}
+
 		ResizableArr<T>::AIterator begin()
 		{
 			return AIterator(0, m_arr);
@@ -289,15 +295,18 @@ namespace AstralEngine
 
 		ResizableArr<T>& operator=(const ResizableArr<T>& other)
 		{
-			delete[] m_arr;
-			m_arr = new T[other.m_maxCount];
-			for (int i = 0; i < other.m_count; i++)
+			if (this == &other)
 			{
-				m_arr[i] = other.m_arr[i];
+				return *this;
 			}
 
+			Clear();
+			Reserve(other.m_count);
+			for (size_t i = 0; i < other.m_count; i++)
+			{
+				new (&m_arr[i]) T(other.m_arr[i]);
+			}
 			m_count = other.m_count;
-			m_maxCount = other.m_maxCount;
 			return *this;
 		}
 
@@ -306,306 +315,275 @@ namespace AstralEngine
 		{
 			if (m_count >= m_maxCount)
 			{
-				Resize();
+				Reallocate((size_t)((float)m_maxCount * 1.5f) + 1);
 			}
 		}
 
-		void Resize()
+		void Reallocate(size_t newMax)
 		{
-			size_t newMax = (size_t)((float)m_maxCount * 1.5f) + 1;
-			T* temp = new T[newMax];
+			T* temp = m_allocator.Allocate(newMax);
 
 			for (size_t i = 0; i < m_count; i++)
 			{
-				temp[i] = std::move(m_arr[i]);
+				new (&temp[i]) T(std::move(m_arr[i]));
+				m_arr[i].~T();
 			}
 
-			delete[] m_arr;
+			m_allocator.Deallocate(m_arr, m_maxCount);
 			m_arr = temp;
 			m_maxCount = newMax;
 		}
 
+		void DestroyElements()
+		{
+			for (size_t i = 0; i < m_count; i++)
+			{
+				m_arr[i].~T();
+			}
+		}
 
+		AHeapAllocator<T> m_allocator;
 		T* m_arr;
 		size_t m_count;
 		size_t m_maxCount;
 	};
 
-	template<typename T>
-	class ASparseSet<T>
+
+	/*Set of unique elements stored contiguously which provides constant time insertion, 
+	  removal and lookup. The sparse array maps an element to its position in the packed 
+	  array and is split in pages which are only allocated while an element maps to them.
+
+	  PageSize is the number of entries per page (must be a power of two) and IndexType is 
+	  the type used to store positions in the packed array which bounds the number of 
+	  elements the set can hold
+	*/
+	template<typename T, size_t PageSize = AE_PAGE_SIZE / sizeof(unsigned int), typename IndexType = unsigned int>
+	class ASparseSet
 	{
-		static constexpr size_t ElementPerPage = AE_PAGE_SIZE / sizeof(T);
-		using PageType = typename AUniqueRef<T[]>;
+		static_assert(PageSize != 0 && (PageSize & (PageSize - 1)) == 0, "ASparseSet page size must be a power of two");
+		static_assert(std::is_unsigned_v<IndexType>, "ASparseSet index type must be an unsigned integer");
+
+		static constexpr IndexType NullIndex = (std::numeric_limits<IndexType>::max)();
+
+		struct SparsePage
+		{
+			AUniqueRef<IndexType[]> indices;
+			size_t count = 0;
+		};
 
-		using ToIntFunc = ADelegate<size_t(const T)>;
-		
 	public:
 		using AIterator = typename ADynArr<T>::AIterator;
 		using AConstIterator = typename ADynArr<T>::AConstIterator;
 
-		ASparseSet(ToIntFunc func = ToIntFunc(&ToInt<T>)) : m_toInt(func) { }
+		ASparseSet() { }
 
-		ASparseSet(const ASparseSet<T>& other) 
-			: m_packed(other.m_packed), m_sparse(other.m_sparse), m_toInt(other.m_toInt) { }
+		ASparseSet(const ASparseSet& other) : m_packed(other.m_packed)
+		{
+			CopyPages(other);
+		}
 
 		virtual ~ASparseSet() { }
 
-		bool Contains(const T& e) const
+		bool Contains(const T e) const
 		{
-			
-			size_t page = Page(e);
-			if (!(page < m_sparse.GetCount()) || m_sparse[page] == nullptr)
+			size_t page = PageOf(e);
+			if (!(page < m_sparse.GetCount()) || m_sparse[page].indices == nullptr)
 			{
 				return false;
 			}
-			
-			//use m_sparse[page][offset] to get actual index of e in the packed array
-			size_t offset = Offset(e);
-			return (size_t)m_sparse[page][offset] < m_packed.GetCount() 
-				&& m_packed[(size_t)m_sparse[page][offset]] == e;
+
+			//NullIndex is always out of bounds of the packed array
+			size_t index = (size_t)m_sparse[page].indices[OffsetOf(e)];
+			return index < m_packed.GetCount() && m_packed[index] == e;
 		}
 
 		void Clear()
 		{
 			m_sparse.Clear();
+			m_spare = nullptr;
 			m_packed.Clear();
 		}
 
+		//empty pages are released on removal so only the packed array needs to be shrunk
 		void ShrinkToFit()
 		{
+			m_spare = nullptr;
 			m_packed.ShrinkToFit();
-			m_sparse.ShrinkToFit();
-		}
-
-		size_t GetCount() const { return m_packed.GetCount(); }
-
-		bool IsEmpty() const { return m_packed.IsEmpty(); }
-
-		AIterator begin() { return m_packed.begin(); }
-
-		AIterator end() { return m_packed.end(); }
-
-		AConstIterator begin() const { return m_packed.begin(); }
-
-		AConstIterator end() const { return m_packed.end(); }
-
-		void Add(const T e)
-		{
-			
-			AE_DATASTRUCT_ASSERT(!Contains(e), "Cannot add the same element twice");
-			Assure(Page(e))[Offset(e)] = (T)m_packed.GetCount();
-			m_packed.Add(e);
 		}
 
-		void Remove(const T e)
+		size_t GetCount() const
 		{
-			
-			AE_DATASTRUCT_ASSERT(Contains(e), "Cannot remove an element that is not contained in the SparseSet");
-			
-			size_t page = Page(e);
-			size_t offset = Offset(e);
-			
-			/*move last element to the position of the element to remove
-			  so that removing the element is more efficient
-			  (also need to move the element in the sparse set)
-			*/
-			T lastElement = m_packed[m_packed.GetCount() - 1];
-
-			m_packed[m_toInt(m_sparse[page][offset])] = lastElement;
-			m_sparse[Page(lastElement)][Offset(lastElement)] = m_sparse[page][offset];
-			m_sparse[page][offset] = Null;
-			m_packed.RemoveAt(m_packed.GetCount() - 1);
+			return m_packed.GetCount();
 		}
 
-		size_t GetIndex(const T e) const
+		bool IsEmpty() const
 		{
-			
-			AE_DATASTRUCT_ASSERT(Contains(e), "Trying to get index of an object not in the sparse set");
-			return size_t(m_sparse[Page(e)][Offset(e)]);
+			return m_packed.IsEmpty();
 		}
 
-		void Swap(const T lhs, const T rhs)
+		//memory held by the pages of the sparse side, including the spare page
+		size_t GetSparseMemory() const
 		{
-			auto& left = m_sparse[Page(lhs)][Offset(lhs)];
-			auto& right = m_sparse[Page(rhs)][Offset(rhs)];
-			std::swap(m_packed[size_t(left)], m_packed[size_t(right)]);
-			std::swap(left, right);
+			size_t numPages = m_spare != nullptr ? 1 : 0;
+			for (size_t i = 0; i < m_sparse.GetCount(); i++)
+			{
+				numPages += m_sparse[i].indices != nullptr ? 1 : 0;
+			}
+			return numPages * PageSize * sizeof(IndexType);
 		}
 
-		const T* GetData() const
+		AIterator begin()
 		{
-			return m_packed.GetData();
+			return m_packed.begin();
 		}
 
-		ASparseSet<T>& operator=(const ASparseSet<T>& other)
+		AIterator end()
 		{
-			m_sparse = other.m_sparse;
-			m_packed = other.m_packed;
-			m_toInt = other.m_toInt;
-			return *this;
+			return m_packed.end();
 		}
 
-	private:
-		size_t Page(const T e) const
+		AConstIterator begin() const
 		{
-			return size_t{ m_toInt(e) / ElementPerPage };
+			return m_packed.begin();
 		}
 
-		size_t Offset(const T e) const
+		AConstIterator end() const
 		{
-			return size_t{ m_toInt(e) & (ElementPerPage - 1) };
+			return m_packed.end();
 		}
 
-		PageType& Assure(const size_t pos)
+		void Add(const T e)
 		{
-			
-			if (!(pos < m_sparse.GetCount()))
-			{
-				m_sparse.Reserve(pos);
-			}
-
-			if (m_sparse[pos] == nullptr)
-			{
-				//create a new page where every AUniqueRef is nullptr
-				m_sparse[pos] = AUniqueRef<T[]>::Create(ElementPerPage);
-			}
-
-			return m_sparse[pos];
+			AE_DATASTRUCT_ASSERT(!Contains(e), "Element already in the sparse set");
+			AE_DATASTRUCT_ASSERT(m_packed.GetCount() < (size_t)NullIndex, "Index type of the sparse set is too small to hold more elements");
+			SparsePage& page = AssurePage(PageOf(e));
+			page.indices[OffsetOf(e)] = (IndexType)m_packed.GetCount();
+			page.count++;
+			m_packed.Add(e);
 		}
 
-		ResizableArr<PageType> m_sparse;
-		ADynArr<T> m_packed;
-		ToIntFunc m_toInt;
-	};
-
-	template<typename K, typename T>
-	class ASparseSet<K, T>
-	{
-		static constexpr auto ElementPerPage = AE_PAGE_SIZE / sizeof(T);
-		using PageType = typename AUniqueRef<K[]>;
-
-	public:
-		using AIterator = typename ADynArr<AKeyElementPair<K, T>>::AIterator;
-		using AConstIterator = typename ADynArr<AKeyElementPair<K, T>>::AConstIterator;
-
-		ASparseSet() { }
-
-		virtual ~ASparseSet() { }
-
-		bool Contains(const K& key) const
+		//makes room for count more elements in the packed array, the pages are still allocated as elements map to them
+		void Reserve(size_t count)
 		{
-			
-			size_t page = Page(key);
-			//use GetIndex to get actual index of T in packed
-			return page < m_sparse.GetCount() && m_sparse[page] != nullptr
-				&& (GetIndex(key) < m_packed.GetCount() && m_packed[GetIndex(key)] == key);
+			m_packed.Reserve(count);
 		}
 
-		void Clear()
+		//swaps the element with the last one of the packed array before removing it
+		void Remove(const T e)
 		{
-			m_sparse.Clear();
-			m_packed.Clear();
-		}
+			AE_DATASTRUCT_ASSERT(Contains(e), "Element not found in the sparse set");
+			size_t page = PageOf(e);
+			size_t offset = OffsetOf(e);
+			IndexType index = m_sparse[page].indices[offset];
+			T last = m_packed[m_packed.GetCount() - 1];
 
-		void ShrinkToFit()
-		{
-			m_packed.ShrinkToFit();
-			m_sparse.ShrinkToFit();
+			m_sparse[PageOf(last)].indices[OffsetOf(last)] = index;
+			m_sparse[page].indices[offset] = NullIndex;
+			m_packed.RemoveAtSwap((size_t)index);
+			ReleasePage(page);
 		}
 
-		size_t GetCount() const { return m_packed.GetCount(); }
-
-		bool IsEmpty() const { return m_packed.IsEmpty(); }
-
-		AIterator begin() { return m_packed.begin(); }
-
-		AIterator end() { return m_packed.end(); }
-
-		AConstIterator begin() const { return m_packed.begin(); }
-
-		AConstIterator end() const { return m_packed.end(); }
-
-		void Add(const AKeyElementPair<K, T>& pair)
+		size_t GetIndex(const T e) const
 		{
-			
-			AE_DATASTRUCT_ASSERT(!Contains(pair.GetKey()), "Cannot add the same T twice");
-			Assure(Page(pair.GetKey()))[Offset(pair.GetKey())] = (K)m_packed.GetCount();
-			m_packed.Add(pair);
+			AE_DATASTRUCT_ASSERT(Contains(e), "Element not found in the sparse set");
+			return (size_t)m_sparse[PageOf(e)].indices[OffsetOf(e)];
 		}
 
-		void Add(const K key, const T element)
+		void Swap(const T lhs, const T rhs)
 		{
-			AKeyElementPair<K, T> pair = AKeyElementPair<K, T>(key, element);
-			Add(pair);
+			IndexType& lhsIndex = m_sparse[PageOf(lhs)].indices[OffsetOf(lhs)];
+			IndexType& rhsIndex = m_sparse[PageOf(rhs)].indices[OffsetOf(rhs)];
+			std::swap(m_packed[(size_t)lhsIndex], m_packed[(size_t)rhsIndex]);
+			std::swap(lhsIndex, rhsIndex);
 		}
 
-		void Remove(const K key)
-		{
-			
-			AE_DATASTRUCT_ASSERT(Contains(key), "Cannot remove an element that is not contained in the SparseSet");
+		T* GetData() { return m_packed.GetData(); }
 
-			size_t page = Page(key);
-			size_t offset = Offset(key);
-
-			/*move last element to the position of the element to remove
-			  so that removing the element is more efficient
-			  (will also need to move the element in the sparse set)
-			*/
-			m_packed[m_sparse[page][offset]] = T(m_packed[m_packed.GetCount() - 1]);
-			m_sparse[Page(m_packed[m_packed.GetCount() - 1].GetKey())][Offset(m_packed[m_packed.GetCount() - 1].GetKey())] = m_sparse[page][offset];
-			m_sparse[page][offset] = Null;
-			m_packed.Remove(m_packed.GetCount() - 1);
-		}
+		const T* GetData() const { return m_packed.GetData(); }
 
-		size_t GetIndex(const K key) const
+		ASparseSet& operator=(const ASparseSet& other)
 		{
-			return (size_t)m_sparse[Page(key)][Offset(key)];
-		}
-
-		void Swap(const K lhs, const K rhs)
-		{
-			auto& left = m_sparse[Page(lhs)][Offset(lhs)];
-			auto& right = m_sparse[Page(rhs)][Offset(rhs)];
-			std::swap(m_packed[size_t(left)], m_packed[size_t(right)]);
-			std::swap(left, right);
+			if (this != &other)
+			{
+				m_packed = other.m_packed;
+				m_sparse.Clear();
+				m_spare = nullptr;
+				CopyPages(other);
+			}
+			return *this;
 		}
 
-		const AKeyElementPair<K, T>* GetData() const
+	private:
+		static constexpr size_t PageOf(const T e)
 		{
-			return m_packed.GetData();
+			return ToInt(e) / PageSize;
 		}
 
-	private:
-
-		size_t Page(const K key) const
+		static constexpr size_t OffsetOf(const T e)
 		{
-			return size_t{ key / ElementPerPage };
+			return ToInt(e) & (PageSize - 1);
 		}
 
-		size_t Offset(const K key) const
+		SparsePage& AssurePage(size_t pos)
 		{
-			return size_t{ key & (ElementPerPage - 1) };
+			SparsePage& page = m_sparse[pos];
+			if (page.indices == nullptr)
+			{
+				//a released page only holds null indices so it can be reused as is
+				if (m_spare != nullptr)
+				{
+					page.indices = std::move(m_spare);
+				}
+				else
+				{
+					page.indices = AUniqueRef<IndexType[]>::Create(PageSize);
+					for (size_t i = 0; i < PageSize; i++)
+					{
+						page.indices[i] = NullIndex;
+					}
+				}
+			}
+			return page;
 		}
 
-		PageType& Assure(const size_t pos)
+		/*frees the page once no element maps to it anymore, one empty page is 
+		  kept aside to avoid reallocating when an element is added and removed 
+		  repeatedly on an otherwise empty page
+		*/
+		void ReleasePage(size_t pos)
 		{
-			
-			if (!(pos < m_sparse.GetCount()))
+			SparsePage& page = m_sparse[pos];
+			page.count--;
+			if (page.count == 0)
 			{
-				m_sparse.Reserve(pos);
+				if (m_spare == nullptr)
+				{
+					m_spare = std::move(page.indices);
+				}
+				page.indices = nullptr;
 			}
+		}
 
-			if (m_sparse[pos] == nullptr)
+		void CopyPages(const ASparseSet& other)
+		{
+			for (size_t i = 0; i < other.m_sparse.GetCount(); i++)
 			{
-				//create a new page where every AUniqueRef is nullptr
-				m_sparse[pos] = AUniqueRef<T[]>::Create(ElementPerPage);
+				const SparsePage& otherPage = other.m_sparse[i];
+				SparsePage& page = m_sparse[i];
+				page.count = otherPage.count;
+				if (otherPage.indices != nullptr)
+				{
+					page.indices = AUniqueRef<IndexType[]>::Create(PageSize);
+					for (size_t j = 0; j < PageSize; j++)
+					{
+						page.indices[j] = otherPage.indices[j];
+					}
+				}
 			}
-
-			return m_sparse[pos];
 		}
 
-		ADynArr<PageType> m_sparse;
-		ADynArr<AKeyElementPair<K, T>> m_packed;
+		ResizableArr<SparsePage> m_sparse;
+		AUniqueRef<IndexType[]> m_spare;
+		ADynArr<T> m_packed;
 	};
-
-}
\ No newline at end of file
+}
@@ -12,7 +12,8 @@ namespace AstralEngine
 
 		void Push(T& element) { m_list.Add(element); }
 		
-		T& Pop() 
+		//returned by value since the element is removed from the stack
+		T Pop() 
 		{
 			AE_ASSERT(!m_list.IsEmpty(), "");
 			T popped = std::move(m_list[0]);
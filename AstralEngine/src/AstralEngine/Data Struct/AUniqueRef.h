@@ -24,6 +24,11 @@ namespace AstralEngine
 			other.m_ptr = nullptr;
 		}
 
+		AUniqueRef(AUniqueRef<T>&& other) noexcept : m_ptr(other.m_ptr)
+		{
+			other.m_ptr = nullptr;
+		}
+
 		template<typename Other>
 		AUniqueRef(AUniqueRef<Other>& other) : m_ptr((T*)other.m_ptr)
 		{
@@ -146,6 +151,11 @@ namespace AstralEngine
 			other.m_ptr = nullptr;
 		}
 
+		AUniqueRef(AUniqueRef<T[]>&& other) noexcept : m_ptr(other.m_ptr)
+		{
+			other.m_ptr = nullptr;
+		}
+
 		~AUniqueRef() { delete[] m_ptr; }
 
 		T* const Get() const { return m_ptr; }
@@ -225,6 +235,11 @@ namespace AstralEngine
 			other.m_ptr = nullptr;
 		}
 
+		AUniqueRef(AUniqueRef<void>&& other) noexcept : m_ptr(other.m_ptr)
+		{
+			other.m_ptr = nullptr;
+		}
+
 		template<typename Other>
 		AUniqueRef(AUniqueRef<Other>& other) : m_ptr((void*)other.m_ptr)
 		{
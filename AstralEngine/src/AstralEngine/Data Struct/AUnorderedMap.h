@@ -1,14 +1,100 @@
 #pragma once
 #include "AstralEngine/Core/Core.h"
-#include "AstralEngine/Math/AMath.h"
-#include "ASinglyLinkedList.h"
 #include "AKeyElementPair.h"
+
 #include <functional>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef AE_SIMD_SSE
+	#include <emmintrin.h>
+#endif
 
-#define UNORDERED_MAP_MAX_LOAD_FACTOR 10
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
 
 namespace AstralEngine
 {
+	/*hash used by AUnorderedMap, forwards to std::hash by default
+
+	  hashes which define IsTransparent can hash other types than the key, the map then accepts
+	  those types when searching so a key does not need to be constructed for every lookup
+	*/
+	template<typename K>
+	struct AMapHash
+	{
+		size_t operator()(const K& key) const { return std::hash<K>()(key); }
+	};
+
+	//std::string keys can be searched with string literals and std::string_view without allocating
+	template<>
+	struct AMapHash<std::string>
+	{
+		using IsTransparent = void;
+		size_t operator()(std::string_view key) const { return std::hash<std::string_view>()(key); }
+	};
+
+	/*control bytes of s_size consecutive slots of an AUnorderedMap, the control byte of a slot is
+	  s_emptyControl when the slot is empty and the 7 lower bits of the hash of its key otherwise so
+	  most keys which differ are rejected without being compared
+	*/
+	class AMapGroup
+	{
+	public:
+		static constexpr size_t s_size = 16;
+		static constexpr signed char s_emptyControl = -128;
+
+		AMapGroup(const signed char* controls)
+		{
+#ifdef AE_SIMD_SSE
+			m_controls = _mm_loadu_si128((const __m128i*)controls);
+#else
+			m_controls = controls;
+#endif
+		}
+
+		//bit i of the mask is set when the control byte of the slot i of the group is control
+		unsigned int Match(signed char control) const
+		{
+#ifdef AE_SIMD_SSE
+			return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(m_controls, _mm_set1_epi8(control)));
+#else
+			unsigned int mask = 0;
+			for (size_t i = 0; i < s_size; i++)
+			{
+				if (m_controls[i] == control)
+				{
+					mask |= 1u << i;
+				}
+			}
+			return mask;
+#endif
+		}
+
+		unsigned int MatchEmpty() const { return Match(s_emptyControl); }
+
+		static unsigned int LowestBit(unsigned int mask)
+		{
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return (unsigned int)index;
+#else
+			return (unsigned int)__builtin_ctz(mask);
+#endif
+		}
+
+	private:
+#ifdef AE_SIMD_SSE
+		__m128i m_controls;
+#else
+		const signed char* m_controls;
+#endif
+	};
+
 	template<typename K, typename T>
 	class AUnorderedMap;
 
@@ -20,34 +106,19 @@ namespace AstralEngine
 	{
 		friend class AUnorderedMap<K, T>;
 		friend class AUnorderedMapConstIterator<K, T>;
-		
-		using Bucket = ASinglyLinkedList<AKeyElementPair<K, T>>;
-		using BucketAIterator = ASinglyLinkedListIterator<AKeyElementPair<K, T>>;
 	public:
 		AUnorderedMapIterator(const AUnorderedMapIterator<K, T>& other)
-			: m_bucketArr(other.m_bucketArr), m_currBucket(other.m_currBucket),
-			m_currIt(other.m_currIt), m_maxCount(other.m_maxCount) { }
+			: m_slots(other.m_slots), m_controls(other.m_controls),
+			m_index(other.m_index), m_capacity(other.m_capacity) { }
 
 		virtual ~AUnorderedMapIterator() { }
 
 		AUnorderedMapIterator<K, T>& operator++()
 		{
-			
-			
-			m_currIt++;
-
-			if (m_currIt == m_bucketArr[m_currBucket].end())
+			do
 			{
-				for (size_t i = m_currBucket + 1; i < m_maxCount; i++)
-				{
-					if (m_bucketArr[i].GetCount() != 0)
-					{
-						m_currBucket = i;
-						m_currIt = m_bucketArr[m_currBucket].begin();
-						break;
-					}
-				}
-			}
+				m_index++;
+			} while (m_index < m_capacity && m_controls[m_index] == AMapGroup::s_emptyControl);
 
 			return *this;
 		}
@@ -61,7 +132,7 @@ namespace AstralEngine
 
 		bool operator==(const AUnorderedMapIterator<K, T>& other) const
 		{
-			return m_currIt == other.m_currIt;
+			return m_index == other.m_index;
 		}
 
 		bool operator!=(const AUnorderedMapIterator<K, T>& other) const
@@ -71,18 +142,18 @@ namespace AstralEngine
 
 		AKeyElementPair<K, T>& operator*()
 		{
-			return *m_currIt;
+			return m_slots[m_index];
 		}
 
 	private:
-		AUnorderedMapIterator(Bucket* bucketArr,
-			size_t currBucket, BucketAIterator& currIt, size_t maxCount)
-			: m_bucketArr(bucketArr), m_currBucket(currBucket), m_currIt(currIt), m_maxCount(maxCount) { }
-
-		Bucket* m_bucketArr;
-		size_t m_currBucket;
-		size_t m_maxCount;
-		BucketAIterator m_currIt;
+		AUnorderedMapIterator(AKeyElementPair<K, T>* slots, const signed char* controls,
+			size_t index, size_t capacity)
+			: m_slots(slots), m_controls(controls), m_index(index), m_capacity(capacity) { }
+
+		AKeyElementPair<K, T>* m_slots;
+		const signed char* m_controls;
+		size_t m_index;
+		size_t m_capacity;
 	};
 
 	template<typename K, typename T>
@@ -106,20 +177,6 @@ namespace AstralEngine
 			return it;
 		}
 
-		AUnorderedMapConstIterator<K, T>& operator--()
-		{
-			AUnorderedMapIterator<K, T>::operator--();
-			return *this;
-		}
-
-		AUnorderedMapConstIterator<K, T> operator--(int)
-		{
-			
-			AUnorderedMapConstIterator<K, T> it = *this;
-			this->operator--();
-			return it;
-		}
-
 		bool operator==(const AUnorderedMapConstIterator<K, T>& other) const
 		{
 			return AUnorderedMapIterator<K, T>::operator==(other);
@@ -132,18 +189,25 @@ namespace AstralEngine
 
 		const AKeyElementPair<K, T>& operator*() const
 		{
-			AUnorderedMapIterator<K, T>* thisIt = const_cast<AUnorderedMapIterator<K, T>*>
-				((const AUnorderedMapIterator<K, T>*)this);
-			return thisIt->operator*();
+			return this->m_slots[this->m_index];
 		}
 
 	private:
-		AUnorderedMapConstIterator(ASinglyLinkedList<AKeyElementPair<K, T>>* bucketArr,
-			size_t currBucket, ASinglyLinkedListIterator<AKeyElementPair<K, T>>& currIt, size_t numBuckets)
-			: AUnorderedMapIterator<K, T>(bucketArr, currBucket, currIt, numBuckets) { }
-
+		AUnorderedMapConstIterator(AKeyElementPair<K, T>* slots, const signed char* controls,
+			size_t index, size_t capacity)
+			: AUnorderedMapIterator<K, T>(slots, controls, index, capacity) { }
 	};
 
+	/*open addressing hash map storing its pairs in a single array of slots
+
+	  keys are placed in the first empty slot following the slot their hash maps to (linear probing),
+	  the control bytes of the slots are scanned AMapGroup::s_size at a time using SSE2 when it is
+	  available. Removing a key shifts the keys following it back towards their ideal slot instead of
+	  leaving a tombstone so lookups never slow down after many removals
+
+	  adding keys can move the pairs of the map so references to its elements are invalidated,
+	  removing keys while iterating over the map is not supported
+	*/
 	template<typename K, typename T>
 	class AUnorderedMap
 	{
@@ -151,68 +215,53 @@ namespace AstralEngine
 		using AIterator = AUnorderedMapIterator<K, T>;
 		using AConstIterator = AUnorderedMapConstIterator<K, T>;
 
-		AUnorderedMap(size_t bucketCount = 5, std::function<bool(const K&, const K&)> equalsFunc
-			= &AUnorderedMap<K, T>::DefaultEquals, std::function<int(long, size_t)> compressFunc
-			= &AUnorderedMap<K, T>::DefaultCompress)
-			: m_bucketCount(bucketCount), m_equalsFunc(equalsFunc), m_compressFunc(compressFunc), m_count(0)
+		//reserves enough space to add count keys without rehashing
+		AUnorderedMap(size_t count = 0) : m_slots(nullptr), m_controls(nullptr), m_capacity(0), m_count(0)
 		{
-			m_bucketArr = new ASinglyLinkedList<AKeyElementPair<K, T>>[m_bucketCount];
+			Allocate(GetCapacityFor(count));
 		}
 
-		AUnorderedMap(std::function<bool(const K&, const K&)> equalsFunc) : m_bucketCount(5),
-			m_equalsFunc(equalsFunc), m_compressFunc(&AUnorderedMap<K, T>::DefaultCompress), m_count(0)
+		AUnorderedMap(const AUnorderedMap<K, T>& other) : m_slots(nullptr), m_controls(nullptr),
+			m_capacity(0), m_count(0)
 		{
-			m_bucketArr = new ASinglyLinkedList<AKeyElementPair<K, T>>[m_bucketCount];
+			CopyFrom(other);
 		}
 
-		AUnorderedMap(std::function<int(long, size_t)> compressFunc) : m_bucketCount(5),
-			m_equalsFunc(&AUnorderedMap<K, T>::DefaultEquals), m_compressFunc(compressFunc), m_count(0)
+		AUnorderedMap(AUnorderedMap<K, T>&& other) noexcept : m_slots(other.m_slots),
+			m_controls(other.m_controls), m_capacity(other.m_capacity), m_count(other.m_count)
 		{
-			m_bucketArr = new ASinglyLinkedList<AKeyElementPair<K, T>>[m_bucketCount];
+			other.m_slots = nullptr;
+			other.m_controls = nullptr;
+			other.m_capacity = 0;
+			other.m_count = 0;
 		}
 
-		AUnorderedMap(const AUnorderedMap<K, T>& other) : m_bucketCount(other.m_bucketCount), m_count(other.m_count),
-			m_equalsFunc(other.m_equalsFunc), m_compressFunc(other.m_compressFunc)
+		~AUnorderedMap()
 		{
-			m_bucketArr = new ASinglyLinkedList<AKeyElementPair<K, T>>[m_bucketCount];
-			for (size_t i = 0; i < m_bucketCount; i++)
-			{
-				m_bucketArr[i] = other.m_bucketArr[i];
-			}
+			delete[] m_slots;
+			delete[] m_controls;
 		}
 
-		AUnorderedMap(AUnorderedMap<K, T>&& other) noexcept : m_bucketCount(other.m_bucketCount),
-			m_equalsFunc(other.m_equalsFunc), m_compressFunc(other.m_compressFunc), m_count(other.m_count)
+		size_t GetCount() const
 		{
-			
-			m_bucketArr = other.m_bucketArr;
-
-			other.m_bucketArr = nullptr;
-			other.m_bucketCount = 0;
-			other.m_count = 0;
+			return m_count;
 		}
 
-		~AUnorderedMap()
+		size_t GetCapacity() const
 		{
-			delete[] m_bucketArr;
+			return m_capacity;
 		}
 
-
-		size_t GetCount() const
+		bool IsEmpty() const
 		{
-			return m_count;
+			return m_count == 0;
 		}
 
 		void Add(const K& key, const T& element)
 		{
-			
 			AE_DATASTRUCT_ASSERT(!ContainsKey(key), "Key Already contained");
-			size_t bucketIndex = GetBucketIndex(key);
-
-			AKeyElementPair<K, T> pair = AKeyElementPair<K, T>(key, element, m_equalsFunc);
-			m_bucketArr[bucketIndex].Add(pair);
-			m_count++;
-			CheckLoadFactor();
+			size_t index = Insert(key, Hash(key));
+			m_slots[index].GetElement() = element;
 		}
 
 		void Set(const K& key, const T& element)
@@ -222,23 +271,13 @@ namespace AstralEngine
 
 		void Remove(const K& key)
 		{
-			
-			if (!ContainsKey(key))
-			{
-				return;
-			}
+			RemoveKey(key);
+		}
 
-			size_t bucketIndex = GetBucketIndex(key);
-			
-			for (auto it = m_bucketArr[bucketIndex].begin(); it != m_bucketArr[bucketIndex].end(); it++)
-			{
-				if (m_equalsFunc(key, (*it).GetKey()))
-				{
-					m_bucketArr[bucketIndex].Remove(it);
-					m_count--;
-					break;
-				}
-			}
+		template<typename KeyLike, typename H = AMapHash<K>, typename = typename H::IsTransparent>
+		void Remove(const KeyLike& key)
+		{
+			RemoveKey(key);
 		}
 
 		T& Get(const K& key)
@@ -251,288 +290,400 @@ namespace AstralEngine
 			return this->operator[](key);
 		}
 
+		template<typename KeyLike, typename H = AMapHash<K>, typename = typename H::IsTransparent>
+		const T& Get(const KeyLike& key) const
+		{
+			return this->operator[](key);
+		}
+
 		bool ContainsKey(const K& key) const
 		{
-			int bucketIndex = GetBucketIndex(key);
-			for (AKeyElementPair<K, T>& pair : m_bucketArr[bucketIndex])
+			return Find(key) != s_notFound;
+		}
+
+		template<typename KeyLike, typename H = AMapHash<K>, typename = typename H::IsTransparent>
+		bool ContainsKey(const KeyLike& key) const
+		{
+			return Find(key) != s_notFound;
+		}
+
+		//makes sure count keys can be stored without rehashing
+		void Reserve(size_t count)
+		{
+			size_t capacity = GetCapacityFor(count);
+			if (capacity > m_capacity)
 			{
-				if (m_equalsFunc(pair.GetKey(), key))
-				{
-					return true;
-				}
+				Rehash(capacity);
 			}
-			return false;
 		}
 
+		//removes every key but keeps the memory of the map
 		void Clear()
 		{
-			
-			for (size_t i = 0; i < m_bucketCount; i++)
+			for (size_t i = 0; i < m_capacity && m_count > 0; i++)
 			{
-				m_bucketArr[i].Clear();
+				if (m_controls[i] != AMapGroup::s_emptyControl)
+				{
+					m_slots[i] = AKeyElementPair<K, T>();
+					m_count--;
+				}
 			}
+			ResetControls();
 		}
 
 		T& operator[](const K& key)
 		{
-			
-			size_t bucketIndex = GetBucketIndex(key);
+			return FindOrInsert(key);
+		}
 
-			//try to find existing key
-			for (AKeyElementPair<K, T>& pair : m_bucketArr[bucketIndex])
-			{
-				if (m_equalsFunc(pair.GetKey(), key))
-				{
-					return pair.GetElement();
-				}
-			}
+		template<typename KeyLike, typename H = AMapHash<K>, typename = typename H::IsTransparent>
+		T& operator[](const KeyLike& key)
+		{
+			return FindOrInsert(key);
+		}
 
-			//if no existing key was created found create one and add it to the AUnorderedMap
-			AKeyElementPair<K, T> pair = AKeyElementPair<K, T>(key, m_equalsFunc);
-			m_bucketArr[bucketIndex].Add(pair);
-			m_count++;
+		const T& operator[](const K& key) const
+		{
+			return GetExisting(key);
+		}
 
-			if (CheckLoadFactor())
-			{
-				bucketIndex = GetBucketIndex(key);
-			}
+		template<typename KeyLike, typename H = AMapHash<K>, typename = typename H::IsTransparent>
+		const T& operator[](const KeyLike& key) const
+		{
+			return GetExisting(key);
+		}
 
-			//find the newly added key and return it's element
-			for (AKeyElementPair<K, T>& pair : m_bucketArr[bucketIndex])
-			{
-				if (pair.GetKey() == key)
-				{
-					return pair.GetElement();
-				}
-			}
+		AUnorderedMap<K, T>::AIterator begin()
+		{
+			return AIterator(m_slots, m_controls, GetFirstIndex(), m_capacity);
+		}
 
-			AE_CORE_ERROR("AUnorderedMap could not find new added key");
-			return pair.GetElement();
+		AUnorderedMap<K, T>::AIterator end()
+		{
+			return AIterator(m_slots, m_controls, m_capacity, m_capacity);
 		}
 
-		const T& operator[](const K& key) const
+		AUnorderedMap<K, T>::AConstIterator begin() const
+		{
+			return AConstIterator(m_slots, m_controls, GetFirstIndex(), m_capacity);
+		}
+
+		AUnorderedMap<K, T>::AConstIterator end() const
 		{
-			
-			AE_DATASTRUCT_ASSERT(ContainsKey(key), "AUnorderedMap could not find the provided key");
-			size_t bucketIndex = GetBucketIndex(key);
+			return AConstIterator(m_slots, m_controls, m_capacity, m_capacity);
+		}
 
-			for (AKeyElementPair<K, T>& pair : m_bucketArr[bucketIndex])
+		AUnorderedMap<K, T>& operator=(const AUnorderedMap<K, T>& other)
+		{
+			if (this == &other)
 			{
-				if (m_equalsFunc(pair.GetKey(), key))
-				{
-					return pair.GetElement();
-				}
+				return *this;
 			}
 
-			return m_bucketArr[bucketIndex][0].GetElement();
+			CopyFrom(other);
+			return *this;
 		}
 
-		AUnorderedMap<K, T>::AIterator begin()
+		AUnorderedMap<K, T>& operator=(AUnorderedMap<K, T>&& other) noexcept
 		{
-			size_t bucketIndex = m_bucketCount - 1;
-			for (size_t i = 0; i < m_bucketCount; i++)
+			if (this == &other)
 			{
-				if (!m_bucketArr[i].IsEmpty())
-				{
-					bucketIndex = i;
-					break;
-				}
+				return *this;
 			}
 
-			return AUnorderedMapIterator<K, T>(m_bucketArr, bucketIndex, m_bucketArr[bucketIndex].begin(), m_bucketCount);
+			delete[] m_slots;
+			delete[] m_controls;
+			m_slots = other.m_slots;
+			m_controls = other.m_controls;
+			m_capacity = other.m_capacity;
+			m_count = other.m_count;
+
+			other.m_slots = nullptr;
+			other.m_controls = nullptr;
+			other.m_capacity = 0;
+			other.m_count = 0;
+			return *this;
 		}
 
-		AUnorderedMap<K, T>::AIterator end()
+		//maps are equal when they contain the same keys associated with equal elements
+		bool operator==(const AUnorderedMap<K, T>& other) const
 		{
-			size_t bucketIndex = m_bucketCount - 1;
-			for (int i = m_bucketCount - 1; i >= 0; i--)
+			if (m_count != other.m_count)
 			{
-				if (!m_bucketArr[i].IsEmpty())
-				{
-					bucketIndex = (size_t)i;
-					break;
-				}
+				return false;
 			}
-			return AUnorderedMapIterator<K, T>(m_bucketArr, bucketIndex, m_bucketArr[bucketIndex].end(), m_bucketCount);
-		}
 
-		AUnorderedMap<K, T>::AConstIterator begin() const
-		{
-			size_t bucketIndex;
-			for (size_t i = 0; i < m_bucketCount; i++)
+			for (const AKeyElementPair<K, T>& pair : *this)
 			{
-				if (m_bucketArr[i].GetCount() != 0)
+				size_t index = other.Find(pair.GetKey());
+				if (index == s_notFound || !(other.m_slots[index].GetElement() == pair.GetElement()))
 				{
-					bucketIndex = i;
-					break;
+					return false;
 				}
 			}
-			return AUnorderedMapConstIterator<K, T>(m_bucketArr, bucketIndex, m_bucketArr[bucketIndex].begin(), m_bucketCount);
+			return true;
 		}
 
-		AUnorderedMap<K, T>::AConstIterator end() const
+		bool operator!=(const AUnorderedMap<K, T>& other) const
+		{
+			return !(operator==(other));
+		}
+
+	private:
+		static constexpr size_t s_notFound = MAXSIZE_T;
+
+		//the map is rehashed once more than s_maxLoadNumerator / s_maxLoadDenominator of the slots are used
+		static constexpr size_t s_maxLoadNumerator = 3;
+		static constexpr size_t s_maxLoadDenominator = 4;
+
+		//number of bits of the hash stored in the control bytes
+		static constexpr size_t s_controlBits = 7;
+
+		template<typename KeyLike>
+		static size_t Hash(const KeyLike& key)
+		{
+			//std::hash is the identity for integers on some platforms, the bits are mixed so the
+			//lower bits stored in the control bytes and the upper bits selecting the slot are independent
+			std::uint64_t hash = (std::uint64_t)AMapHash<K>()(key) * 0x9E3779B97F4A7C15ull;
+			return (size_t)(hash ^ (hash >> 32));
+		}
+
+		static signed char GetControl(size_t hash)
+		{
+			return (signed char)(hash & ((1 << s_controlBits) - 1));
+		}
+
+		size_t GetIdealIndex(size_t hash) const
 		{
-			size_t bucketIndex = 0;
-			for (size_t i = m_bucketCount - 1; i > 0; i--)
+			return (hash >> s_controlBits) & (m_capacity - 1);
+		}
+
+		static size_t GetCapacityFor(size_t count)
+		{
+			size_t capacity = AMapGroup::s_size;
+			while (capacity * s_maxLoadNumerator < (count + 1) * s_maxLoadDenominator)
 			{
-				if (m_bucketArr[i].GetCount() != 0)
-				{
-					bucketIndex = i;
-					break;
-				}
+				capacity *= 2;
 			}
-			return AUnorderedMapConstIterator<K, T>(m_bucketArr, bucketIndex, 
-				m_bucketArr[bucketIndex].end(), m_bucketCount);
+			return capacity;
 		}
 
-		AUnorderedMap<K, T>::AConstIterator rbegin() const
+		template<typename KeyLike>
+		size_t Find(const KeyLike& key) const
 		{
-			size_t bucketIndex;
-			for (size_t i = m_bucketCount - 1; i >= 0; i--)
+			if (m_count == 0)
 			{
-				if (m_bucketArr[i].GetCount() != 0)
-				{
-					bucketIndex = i;
-					break;
-				}
+				return s_notFound;
 			}
-			return AUnorderedMapConstIterator<K, T>(m_bucketArr, bucketIndex, m_bucketArr[bucketIndex].rbegin(), m_bucketCount);
+			return Find(key, Hash(key));
 		}
 
-		AUnorderedMap<K, T>::AConstIterator rend() const
+		template<typename KeyLike>
+		size_t Find(const KeyLike& key, size_t hash) const
 		{
-			size_t bucketIndex;
-			for (size_t i = 0; i < m_bucketCount; i++)
+			if (m_count == 0)
 			{
-				if (m_bucketArr[i].GetCount() != 0)
+				return s_notFound;
+			}
+
+			signed char control = GetControl(hash);
+			size_t mask = m_capacity - 1;
+			size_t index = GetIdealIndex(hash);
+
+			//the load factor guarantees an empty slot is eventually reached
+			while (true)
+			{
+				AMapGroup group(m_controls + index);
+				unsigned int matches = group.Match(control);
+				while (matches != 0)
 				{
-					bucketIndex = i;
-					break;
+					size_t slot = (index + AMapGroup::LowestBit(matches)) & mask;
+					if (m_slots[slot].GetKey() == key)
+					{
+						return slot;
+					}
+					matches &= matches - 1;
+				}
+
+				if (group.MatchEmpty() != 0)
+				{
+					return s_notFound;
 				}
+				index = (index + AMapGroup::s_size) & mask;
 			}
-			return AUnorderedMapConstIterator<K, T>(m_bucketArr, bucketIndex, m_bucketArr[bucketIndex].rend(), m_bucketCount);
 		}
 
-
-		AUnorderedMap<K, T>& operator=(const AUnorderedMap<K, T>& other)
+		template<typename KeyLike>
+		T& FindOrInsert(const KeyLike& key)
 		{
-			if (other == *this)
+			size_t hash = Hash(key);
+			size_t index = Find(key, hash);
+			if (index == s_notFound)
 			{
-				return *this;
+				index = Insert(K(key), hash);
 			}
+			return m_slots[index].GetElement();
+		}
 
-			delete[] m_bucketArr;
-			m_bucketArr = other.m_bucketArr;
-			other.m_equalsFunc = other.m_equalsFunc;
-			m_hash = other.m_hash;
-			return *this;
+		template<typename KeyLike>
+		const T& GetExisting(const KeyLike& key) const
+		{
+			size_t index = Find(key);
+			AE_DATASTRUCT_ASSERT(index != s_notFound, "AUnorderedMap could not find the provided key");
+			return m_slots[index].GetElement();
 		}
 
-		AUnorderedMap<K, T>& operator=(AUnorderedMap<K, T>&& other)
+		//adds a key which is not in the map yet, returns the slot it was placed in
+		size_t Insert(const K& key, size_t hash)
 		{
-			
-			if(other == *this)
+			if ((m_count + 1) * s_maxLoadDenominator > m_capacity * s_maxLoadNumerator)
 			{
-				return *this;
+				Rehash(GetCapacityFor(m_count + 1));
 			}
 
-			delete[] m_bucketArr;
-			m_bucketArr = other.m_bucketArr;
-
-			other.m_bucketArr = nullptr;
-			other.m_bucketCount = 0;
-			other.m_count = 0;
-			return *this;
+			size_t slot = GetEmptySlot(hash);
+			SetControl(slot, GetControl(hash));
+			m_slots[slot].GetKey() = key;
+			m_count++;
+			return slot;
 		}
-		
-		bool operator==(const AUnorderedMap<K, T>& other) const
+
+		size_t GetEmptySlot(size_t hash) const
 		{
-			for (size_t i = 0; i < m_bucketCount; i++)
+			size_t mask = m_capacity - 1;
+			size_t index = GetIdealIndex(hash);
+			while (true)
 			{
-				if (m_bucketArr[i] != other.m_bucketArr[i])
+				unsigned int empty = AMapGroup(m_controls + index).MatchEmpty();
+				if (empty != 0)
 				{
-					return false;
+					return (index + AMapGroup::LowestBit(empty)) & mask;
 				}
+				index = (index + AMapGroup::s_size) & mask;
 			}
-
-			return true;
 		}
 
-		bool operator!=(const AUnorderedMap<K, T>& other) const
+		template<typename KeyLike>
+		void RemoveKey(const KeyLike& key)
 		{
-			return !(operator==(other));
-		}
+			size_t hole = Find(key);
+			if (hole == s_notFound)
+			{
+				return;
+			}
 
-	private:
+			/*backward shift deletion, every key following the hole up to the next empty slot which
+			  can be placed in the hole (its ideal slot is not between the hole and itself) is moved
+			  to it, the slot it leaves becomes the new hole
+			*/
+			size_t mask = m_capacity - 1;
+			size_t slot = hole;
+			while (true)
+			{
+				slot = (slot + 1) & mask;
+				if (m_controls[slot] == AMapGroup::s_emptyControl)
+				{
+					break;
+				}
 
-		static bool DefaultEquals(const K& e1, const K& e2)
-		{
-			return e1 == e2;
+				size_t ideal = GetIdealIndex(Hash(m_slots[slot].GetKey()));
+				if (((slot - ideal) & mask) >= ((slot - hole) & mask))
+				{
+					m_slots[hole] = std::move(m_slots[slot]);
+					SetControl(hole, m_controls[slot]);
+					hole = slot;
+				}
+			}
+
+			m_slots[hole] = AKeyElementPair<K, T>();
+			SetControl(hole, AMapGroup::s_emptyControl);
+			m_count--;
 		}
 
-		static int DefaultCompress(long hash, size_t size)
+		//the control bytes of the first slots are repeated after the last slot so groups can be loaded at any slot
+		void SetControl(size_t slot, signed char control)
 		{
-			return (7l * hash + 31l) % size;
+			m_controls[slot] = control;
+			if (slot < AMapGroup::s_size - 1)
+			{
+				m_controls[m_capacity + slot] = control;
+			}
 		}
 
-		int GetBucketIndex(const K& key) const
+		void ResetControls()
 		{
-			
-			return m_compressFunc((int)m_hash(key), m_bucketCount);
+			if (m_controls == nullptr)
+			{
+				return;
+			}
+
+			for (size_t i = 0; i < m_capacity + AMapGroup::s_size - 1; i++)
+			{
+				m_controls[i] = AMapGroup::s_emptyControl;
+			}
 		}
 
-		void AddAKeyElementPair(AKeyElementPair<K, T> pair, int index)
+		void Allocate(size_t capacity)
 		{
-			m_bucketArr[index].Add(pair);
+			m_capacity = capacity;
+			m_slots = new AKeyElementPair<K, T>[m_capacity];
+			m_controls = new signed char[m_capacity + AMapGroup::s_size - 1];
+			ResetControls();
 		}
 
-		//returns true if rehashed hash map
-		bool CheckLoadFactor()
+		void Rehash(size_t capacity)
 		{
-			size_t loadFactor = m_count / m_bucketCount;
+			AKeyElementPair<K, T>* oldSlots = m_slots;
+			signed char* oldControls = m_controls;
+			size_t oldCapacity = m_capacity;
 
-			if (loadFactor >= UNORDERED_MAP_MAX_LOAD_FACTOR)
+			Allocate(capacity);
+			for (size_t i = 0; i < oldCapacity; i++)
 			{
-				Rehash();
-				return true;
+				if (oldControls[i] != AMapGroup::s_emptyControl)
+				{
+					size_t hash = Hash(oldSlots[i].GetKey());
+					size_t slot = GetEmptySlot(hash);
+					SetControl(slot, GetControl(hash));
+					m_slots[slot] = std::move(oldSlots[i]);
+				}
 			}
 
-			return false;
+			delete[] oldSlots;
+			delete[] oldControls;
 		}
 
-		void Rehash()
+		void CopyFrom(const AUnorderedMap<K, T>& other)
 		{
-			size_t numBuckets = (size_t)((float)m_bucketCount * 1.5f);
-
-			if (numBuckets == m_bucketCount)
-			{
-				numBuckets += 5;
-			}
+			delete[] m_slots;
+			delete[] m_controls;
+			Allocate(other.m_capacity == 0 ? GetCapacityFor(0) : other.m_capacity);
 
-			size_t oldBucketCount = m_bucketCount;
-			ASinglyLinkedList<AKeyElementPair<K, T>>* oldBuckets = m_bucketArr;
-			m_bucketArr = new ASinglyLinkedList<AKeyElementPair<K, T>>[numBuckets];
-			m_count = 0;
-			m_bucketCount = numBuckets;
-
-			for (size_t i = 0; i < oldBucketCount; i++)
+			for (size_t i = 0; i < other.m_capacity; i++)
 			{
-				for (AKeyElementPair<K, T>& pair : oldBuckets[i])
+				if (other.m_controls[i] != AMapGroup::s_emptyControl)
 				{
-					Add(pair.GetKey(), pair.GetElement());
+					SetControl(i, other.m_controls[i]);
+					m_slots[i] = other.m_slots[i];
 				}
 			}
-
-			delete[] oldBuckets;
+			m_count = other.m_count;
 		}
 
+		size_t GetFirstIndex() const
+		{
+			size_t index = 0;
+			while (index < m_capacity && m_controls[index] == AMapGroup::s_emptyControl)
+			{
+				index++;
+			}
+			return index;
+		}
 
-		ADelegate<bool(const K&, const K&)> m_equalsFunc;
-		ADelegate<int(long, size_t)> m_compressFunc;
-		std::hash<K> m_hash;
-		ASinglyLinkedList<AKeyElementPair<K, T>>* m_bucketArr;
-		size_t m_bucketCount;
+		AKeyElementPair<K, T>* m_slots;
+		signed char* m_controls;
+		size_t m_capacity;
 		size_t m_count;
 	};
-	
-}
\ No newline at end of file
+
+}
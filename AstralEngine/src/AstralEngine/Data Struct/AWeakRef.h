@@ -6,33 +6,27 @@ namespace AstralEngine
 	template<typename T>
 	class AWeakRef
 	{
-		template<typename T>
+		template<typename Other>
 		friend class AReference;
 
 	public:
-		AWeakRef()
-		{
-			m_block = nullptr;
-		}
+		AWeakRef() : m_block(nullptr) { }
 
-		AWeakRef(std::nullptr_t null)
-		{
-			m_block = nullptr;
-		}
+		AWeakRef(std::nullptr_t null) : m_block(nullptr) { }
 
-		AWeakRef(const AWeakRef<T>& other) : m_block(other.m_block) 
+		AWeakRef(const AWeakRef<T>& other) : m_block(other.m_block)
 		{
 			if (m_block != nullptr)
 			{
-				m_block->weakCount++;
+				m_block->IncrementWeak();
 			}
 		}
-		
+
 		AWeakRef(const AReference<T>& other) : m_block(other.m_block)
 		{
 			if (m_block != nullptr)
 			{
-				m_block->weakCount++;
+				m_block->IncrementWeak();
 			}
 		}
 
@@ -44,7 +38,8 @@ namespace AstralEngine
 			}
 		}
 
-		T* Get() const { return (T*)m_block->ptr; }
+		//null once the object is destroyed, use AReference(weakRef) to keep the object alive while using it
+		T* Get() const { return m_block == nullptr || IsExpired() ? nullptr : (T*)m_block->m_ptr; }
 
 		size_t GetStrongCount() const
 		{
@@ -52,7 +47,7 @@ namespace AstralEngine
 			{
 				return 0;
 			}
-			return m_block->count;
+			return m_block->GetStrongCount();
 		}
 
 		size_t GetWeakCount() const
@@ -61,89 +56,79 @@ namespace AstralEngine
 			{
 				return 0;
 			}
-			return m_block->weakCount;
+			return m_block->GetWeakCount();
 		}
 
 		T* operator->() const
 		{
-			return (T*)m_block->ptr;
+			return Get();
 		}
 
 		T& operator*() const
 		{
-			return *((T*)m_block->ptr);
+			return *Get();
 		}
 
 		void operator=(const AWeakRef<T>& other)
 		{
-			if (m_block != nullptr)
+			if (other.m_block != nullptr)
 			{
-				m_block->DecrementWeak();
+				other.m_block->IncrementWeak();
 			}
-			m_block = other.m_block;
 
 			if (m_block != nullptr)
 			{
-				m_block->weakCount++;
+				m_block->DecrementWeak();
 			}
+			m_block = other.m_block;
 		}
 
 		void operator=(const AReference<T>& other)
 		{
-			if (m_block != nullptr)
+			if (other.m_block != nullptr)
 			{
-				m_block->DecrementWeak();
+				other.m_block->IncrementWeak();
 			}
-			m_block = other.m_block;
-			
+
 			if (m_block != nullptr)
 			{
-				m_block->weakCount++;
+				m_block->DecrementWeak();
 			}
+			m_block = other.m_block;
 		}
-		
+
 		bool operator==(const AWeakRef<T>& other) const
 		{
-			if (m_block == nullptr)
-			{
-				return other.m_block == nullptr;
-			}
-
-			return *((T*)m_block->ptr) == *((T*)other.m_block->ptr);
+			return AReference<T>(*this) == AReference<T>(other);
 		}
 
 		bool operator==(const AReference<T>& other) const
 		{
-			if (m_block == nullptr)
-			{
-				return other.m_block == nullptr;
-			}
-
-			return *((T*)m_block->ptr) == *((T*)other.m_block->ptr);
+			return AReference<T>(*this) == other;
 		}
 
 		bool operator!=(const AWeakRef<T>& other) const
 		{
-			
+
 			return !(*this == other);
 		}
-		
+
 		bool operator!=(const AReference<T>& other) const
 		{
-			
+
 			return !(*this == other);
 		}
 
-		bool IsExpired() const 
-		{ 
+		bool IsExpired() const
+		{
 			if (m_block == nullptr)
 			{
 				return false;
 			}
-			return m_block->ptr == nullptr;
+			return m_block->GetStrongCount() == 0;
 		}
 
 	private:
 		ControlBlock* m_block;
 	};
-}
\ No newline at end of file
+}
@@ -5,6 +5,7 @@
 #include <string>
 #include <fstream>
 #include <algorithm>
+#include <mutex>
 #include "AstralEngine/Core/Core.h"
 
 #ifdef AE_PROFILE
@@ -41,6 +42,7 @@ namespace AstralEngine
 
 		static void BeginSession(const std::string& name, const std::string& filepath = "results.json")
 		{
+			std::lock_guard<std::mutex> lock(Get().m_mutex);
 			Get().m_outputStream.open(filepath);
 			Get().WriteHeader();
 			Get().m_currentSession = new InstrumentationSession(name);
@@ -48,14 +50,17 @@ namespace AstralEngine
 
 		static void EndSession()
 		{
+			std::lock_guard<std::mutex> lock(Get().m_mutex);
 			Get().WriteFooter();
 			Get().m_outputStream.close();
 			delete Get().m_currentSession;
 			Get().m_profileCount = 0;
 		}
 
+		//profiled scopes can end on the worker threads of the JobSystem
 		static void WriteProfile(const ProfileResult& result)
 		{
+			std::lock_guard<std::mutex> lock(Get().m_mutex);
 			if (Get().m_profileCount > 0)
 			{
 				Get().m_outputStream << ",";
@@ -103,6 +108,7 @@ namespace AstralEngine
 		InstrumentationSession* m_currentSession;
 		std::ofstream m_outputStream;
 		int m_profileCount;
+		std::mutex m_mutex;
 	};
 
 	class ATimer
@@ -0,0 +1,408 @@
+#include "aepch.h"
+#include "AABBTree.h"
+#include "AstralEngine/Renderer/Frustum.h"
+
+namespace AstralEngine
+{
+	AABBTree::AABBTree() : m_root(s_nullNode), m_freeList(s_nullNode), m_count(0) { }
+
+	int AABBTree::Insert(const AABB& box, BaseEntity e)
+	{
+		int proxy = AllocateNode();
+		Node& node = m_nodes[proxy];
+		node.box = Fatten(box);
+		node.entity = e;
+		node.height = 0;
+
+		InsertLeaf(proxy);
+		m_count++;
+		return proxy;
+	}
+
+	void AABBTree::Remove(int proxy)
+	{
+		AE_CORE_ASSERT(proxy >= 0 && proxy < (int)m_nodes.GetCount() && m_nodes[proxy].IsLeaf(),
+			"invalid proxy removed from AABBTree");
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		m_count--;
+	}
+
+	bool AABBTree::Move(int proxy, const AABB& box)
+	{
+		AE_CORE_ASSERT(proxy >= 0 && proxy < (int)m_nodes.GetCount() && m_nodes[proxy].IsLeaf(),
+			"invalid proxy moved in AABBTree");
+		if (m_nodes[proxy].box.Contains(box))
+		{
+			return false;
+		}
+
+		RemoveLeaf(proxy);
+		m_nodes[proxy].box = Fatten(box);
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	void AABBTree::Query(const Frustum& frustum, ADynArr<BaseEntity>& outEntities) const
+	{
+		AE_PROFILE_FUNCTION();
+		if (m_root == s_nullNode)
+		{
+			return;
+		}
+
+		ASmallArr<int, 64> stack;
+		stack.Add(m_root);
+		while (!stack.IsEmpty())
+		{
+			int index = stack[stack.GetCount() - 1];
+			stack.RemoveAtSwap(stack.GetCount() - 1);
+
+			const Node& node = m_nodes[index];
+			FrustumOverlap overlap = frustum.Classify(node.box);
+			if (overlap == FrustumOverlap::Outside)
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				outEntities.Add(node.entity);
+			}
+			else if (overlap == FrustumOverlap::Inside)
+			{
+				GatherLeaves(index, outEntities);
+			}
+			else
+			{
+				stack.Add(node.child1);
+				stack.Add(node.child2);
+			}
+		}
+	}
+
+	const AABB& AABBTree::GetFatAABB(int proxy) const { return m_nodes[proxy].box; }
+	BaseEntity AABBTree::GetEntity(int proxy) const { return m_nodes[proxy].entity; }
+
+	size_t AABBTree::GetCount() const { return m_count; }
+
+	int AABBTree::GetHeight() const
+	{
+		if (m_root == s_nullNode)
+		{
+			return 0;
+		}
+		return m_nodes[m_root].height;
+	}
+
+	void AABBTree::Clear()
+	{
+		m_nodes.Clear();
+		m_root = s_nullNode;
+		m_freeList = s_nullNode;
+		m_count = 0;
+	}
+
+	AABB AABBTree::Fatten(const AABB& box)
+	{
+		Vector3 extents = box.GetExtents();
+		return box.Expand(Vector3(Math::Max(extents.x * s_fatMargin, s_minFatMargin),
+			Math::Max(extents.y * s_fatMargin, s_minFatMargin), Math::Max(extents.z * s_fatMargin, s_minFatMargin)));
+	}
+
+	int AABBTree::AllocateNode()
+	{
+		int index;
+		if (m_freeList != s_nullNode)
+		{
+			index = m_freeList;
+			m_freeList = m_nodes[index].parent;
+		}
+		else
+		{
+			index = (int)m_nodes.GetCount();
+			m_nodes.Add(Node());
+		}
+
+		Node& node = m_nodes[index];
+		node.parent = s_nullNode;
+		node.child1 = s_nullNode;
+		node.child2 = s_nullNode;
+		node.height = 0;
+		node.entity = Null;
+		return index;
+	}
+
+	void AABBTree::FreeNode(int node)
+	{
+		m_nodes[node].parent = m_freeList;
+		m_nodes[node].height = -1;
+		m_freeList = node;
+	}
+
+	void AABBTree::InsertLeaf(int leaf)
+	{
+		if (m_root == s_nullNode)
+		{
+			m_root = leaf;
+			m_nodes[leaf].parent = s_nullNode;
+			return;
+		}
+
+		//descend towards the sibling which makes the surface area of the tree grow the least
+		AABB leafBox = m_nodes[leaf].box;
+		int index = m_root;
+		while (!m_nodes[index].IsLeaf())
+		{
+			const Node& node = m_nodes[index];
+			float area = node.box.GetSurfaceArea();
+			float combinedArea = AABB::Merge(node.box, leafBox).GetSurfaceArea();
+
+			//cost of pairing the leaf with this node and the cost the ancestors pay to go down any further
+			float cost = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto descendCost = [this, &leafBox, inheritanceCost](int child)
+			{
+				const Node& c = m_nodes[child];
+				float mergedArea = AABB::Merge(c.box, leafBox).GetSurfaceArea();
+				if (c.IsLeaf())
+				{
+					return mergedArea + inheritanceCost;
+				}
+				return mergedArea - c.box.GetSurfaceArea() + inheritanceCost;
+			};
+
+			float cost1 = descendCost(node.child1);
+			float cost2 = descendCost(node.child2);
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+			index = cost1 < cost2 ? node.child1 : node.child2;
+		}
+
+		//replace the sibling by a new parent holding both the sibling and the leaf
+		int sibling = index;
+		int oldParent = m_nodes[sibling].parent;
+		int newParent = AllocateNode();
+
+		Node& parentNode = m_nodes[newParent];
+		parentNode.parent = oldParent;
+		parentNode.box = AABB::Merge(leafBox, m_nodes[sibling].box);
+		parentNode.height = m_nodes[sibling].height + 1;
+		parentNode.child1 = sibling;
+		parentNode.child2 = leaf;
+
+		if (oldParent != s_nullNode)
+		{
+			if (m_nodes[oldParent].child1 == sibling)
+			{
+				m_nodes[oldParent].child1 = newParent;
+			}
+			else
+			{
+				m_nodes[oldParent].child2 = newParent;
+			}
+		}
+		else
+		{
+			m_root = newParent;
+		}
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+
+		RefitAncestors(m_nodes[leaf].parent);
+	}
+
+	void AABBTree::RemoveLeaf(int leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = s_nullNode;
+			return;
+		}
+
+		//the parent of the leaf is replaced by the sibling of the leaf
+		int parent = m_nodes[leaf].parent;
+		int grandParent = m_nodes[parent].parent;
+		int sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+		m_nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		if (grandParent == s_nullNode)
+		{
+			m_root = sibling;
+			return;
+		}
+
+		if (m_nodes[grandParent].child1 == parent)
+		{
+			m_nodes[grandParent].child1 = sibling;
+		}
+		else
+		{
+			m_nodes[grandParent].child2 = sibling;
+		}
+		RefitAncestors(grandParent);
+	}
+
+	void AABBTree::RefitAncestors(int node)
+	{
+		int index = node;
+		while (index != s_nullNode)
+		{
+			index = Balance(index);
+
+			Node& n = m_nodes[index];
+			const Node& child1 = m_nodes[n.child1];
+			const Node& child2 = m_nodes[n.child2];
+			n.height = 1 + (std::max)(child1.height, child2.height);
+			n.box = AABB::Merge(child1.box, child2.box);
+
+			index = n.parent;
+		}
+	}
+
+	int AABBTree::Balance(int iA)
+	{
+		Node& a = m_nodes[iA];
+		if (a.IsLeaf() || a.height < 2)
+		{
+			return iA;
+		}
+
+		int iB = a.child1;
+		int iC = a.child2;
+		Node& b = m_nodes[iB];
+		Node& c = m_nodes[iC];
+		int balance = c.height - b.height;
+
+		//rotate c up, c keeps its tallest child and a takes the other one
+		if (balance > 1)
+		{
+			int iF = c.child1;
+			int iG = c.child2;
+			Node& f = m_nodes[iF];
+			Node& g = m_nodes[iG];
+
+			c.child1 = iA;
+			c.parent = a.parent;
+			a.parent = iC;
+
+			if (c.parent != s_nullNode)
+			{
+				if (m_nodes[c.parent].child1 == iA)
+				{
+					m_nodes[c.parent].child1 = iC;
+				}
+				else
+				{
+					m_nodes[c.parent].child2 = iC;
+				}
+			}
+			else
+			{
+				m_root = iC;
+			}
+
+			if (f.height > g.height)
+			{
+				c.child2 = iF;
+				a.child2 = iG;
+				g.parent = iA;
+				a.box = AABB::Merge(b.box, g.box);
+				c.box = AABB::Merge(a.box, f.box);
+				a.height = 1 + (std::max)(b.height, g.height);
+				c.height = 1 + (std::max)(a.height, f.height);
+			}
+			else
+			{
+				c.child2 = iG;
+				a.child2 = iF;
+				f.parent = iA;
+				a.box = AABB::Merge(b.box, f.box);
+				c.box = AABB::Merge(a.box, g.box);
+				a.height = 1 + (std::max)(b.height, f.height);
+				c.height = 1 + (std::max)(a.height, g.height);
+			}
+			return iC;
+		}
+
+		//rotate b up
+		if (balance < -1)
+		{
+			int iD = b.child1;
+			int iE = b.child2;
+			Node& d = m_nodes[iD];
+			Node& e = m_nodes[iE];
+
+			b.child1 = iA;
+			b.parent = a.parent;
+			a.parent = iB;
+
+			if (b.parent != s_nullNode)
+			{
+				if (m_nodes[b.parent].child1 == iA)
+				{
+					m_nodes[b.parent].child1 = iB;
+				}
+				else
+				{
+					m_nodes[b.parent].child2 = iB;
+				}
+			}
+			else
+			{
+				m_root = iB;
+			}
+
+			if (d.height > e.height)
+			{
+				b.child2 = iD;
+				a.child1 = iE;
+				e.parent = iA;
+				a.box = AABB::Merge(c.box, e.box);
+				b.box = AABB::Merge(a.box, d.box);
+				a.height = 1 + (std::max)(c.height, e.height);
+				b.height = 1 + (std::max)(a.height, d.height);
+			}
+			else
+			{
+				b.child2 = iE;
+				a.child1 = iD;
+				d.parent = iA;
+				a.box = AABB::Merge(c.box, d.box);
+				b.box = AABB::Merge(a.box, e.box);
+				a.height = 1 + (std::max)(c.height, d.height);
+				b.height = 1 + (std::max)(a.height, e.height);
+			}
+			return iB;
+		}
+
+		return iA;
+	}
+
+	void AABBTree::GatherLeaves(int node, ADynArr<BaseEntity>& outEntities) const
+	{
+		ASmallArr<int, 64> stack;
+		stack.Add(node);
+		while (!stack.IsEmpty())
+		{
+			int index = stack[stack.GetCount() - 1];
+			stack.RemoveAtSwap(stack.GetCount() - 1);
+
+			const Node& n = m_nodes[index];
+			if (n.IsLeaf())
+			{
+				outEntities.Add(n.entity);
+			}
+			else
+			{
+				stack.Add(n.child1);
+				stack.Add(n.child2);
+			}
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "ECS Core/ECSUtils.h"
+#include "AstralEngine/Math/AMath.h"
+#include "AstralEngine/Data Struct/ADynArr.h"
+
+namespace AstralEngine
+{
+	class Frustum;
+
+	/* dynamic bounding volume hierarchy over the boxes of the entities of a scene
+
+	   leaves store the box of an entity enlarged by a margin so entities moving by small amounts do not
+	   need to be reinserted. A new leaf is paired with the node which increases the surface area of the
+	   tree the least and the ancestors of the leaf are rebalanced with rotations on the way back up
+	   (same approach as Box2D's dynamic tree)
+	*/
+	class AABBTree
+	{
+	public:
+		static constexpr int s_nullNode = -1;
+
+		AABBTree();
+
+		//returns the proxy of the entity in the tree, used to move or remove it
+		int Insert(const AABB& box, BaseEntity e);
+		void Remove(int proxy);
+
+		//updates the box of a proxy, returns true if the proxy had to be reinserted
+		bool Move(int proxy, const AABB& box);
+
+		/* adds the entities whose boxes intersect the frustum to outEntities, subtrees entirely
+		   inside the frustum are added without testing their boxes
+		*/
+		void Query(const Frustum& frustum, ADynArr<BaseEntity>& outEntities) const;
+
+		const AABB& GetFatAABB(int proxy) const;
+		BaseEntity GetEntity(int proxy) const;
+
+		size_t GetCount() const;
+		int GetHeight() const;
+
+		void Clear();
+
+	private:
+		struct Node
+		{
+			bool IsLeaf() const { return child1 == s_nullNode; }
+
+			AABB box;
+			BaseEntity entity;
+
+			//next free node when the node is not used
+			int parent;
+			int child1;
+			int child2;
+
+			//0 for leaves and -1 for free nodes
+			int height;
+		};
+
+		static AABB Fatten(const AABB& box);
+
+		int AllocateNode();
+		void FreeNode(int node);
+
+		void InsertLeaf(int leaf);
+		void RemoveLeaf(int leaf);
+
+		//rotates the subtree rooted at node if it is imbalanced, returns the new root of the subtree
+		int Balance(int node);
+
+		//recomputes the boxes and heights of the ancestors of node starting from node
+		void RefitAncestors(int node);
+
+		void GatherLeaves(int node, ADynArr<BaseEntity>& outEntities) const;
+
+		//fraction of the size of a box added on every side of it, s_minFatMargin is used for flat boxes
+		static constexpr float s_fatMargin = 0.1f;
+		static constexpr float s_minFatMargin = 0.05f;
+
+		ADynArr<Node> m_nodes;
+		int m_root;
+		int m_freeList;
+		size_t m_count;
+	};
+}
@@ -179,6 +179,7 @@ namespace AstralEngine
 	class AEntityLinkedComponent
 	{
 		friend class AEntity;
+		friend class Scene;
 	public:
 		AEntity GetAEntity() const;
 
@@ -243,6 +244,9 @@ namespace AstralEngine
 			return !(*this == other);
 		}
 
+	protected:
+		Scene* GetScene() const { return m_entity.m_scene; }
+
 	private:
 		AEntity m_entity;
 	};
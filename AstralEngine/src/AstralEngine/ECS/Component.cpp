@@ -2,9 +2,21 @@
 #include "Components.h"
 #include "AstralEngine/Renderer/Renderer.h"
 #include "AstralEngine/Renderer/RendererInternals.h"
+#include "AstralEngine/Renderer/Mesh.h"
 
 namespace AstralEngine
 {
+	// Renderable ///////////////////////////////////////////////////////
+	void Renderable::OnBoundsChanged()
+	{
+		//the component is not linked to an entity until it is emplaced in a scene
+		Scene* scene = GetScene();
+		if (scene != nullptr)
+		{
+			scene->OnRenderableBoundsChanged(GetAEntity());
+		}
+	}
+
 	// SpriteRenderer ///////////////////////////////////////////////////
 	SpriteRenderer::SpriteRenderer()
 		: m_color(1.0f, 1.0f, 1.0f, 1.0f),
@@ -113,6 +125,11 @@ namespace AstralEngine
 		return !(*this == other);
 	}
 
+	AABB SpriteRenderer::GetLocalBounds() const
+	{
+		return ResourceHandler::BorrowMesh(Mesh::QuadMesh())->GetBounds();
+	}
+
 	void SpriteRenderer::SendDataToRenderer(const Transform& transform) const
 	{
 		Renderer::DrawSprite(transform, *this);
@@ -125,7 +142,11 @@ namespace AstralEngine
 	MeshRenderer::MeshRenderer(MeshHandle mesh, MaterialHandle mat) : m_mesh(mesh), m_material(mat) { }
 
 	MeshHandle MeshRenderer::GetMesh() const { return m_mesh; }
-	void MeshRenderer::SetMesh(MeshHandle mesh) { m_mesh = mesh; }
+	void MeshRenderer::SetMesh(MeshHandle mesh) 
+	{ 
+		m_mesh = mesh; 
+		OnBoundsChanged();
+	}
 
 	MaterialHandle MeshRenderer::GetMaterial() const { return m_material; }
 
@@ -141,6 +162,15 @@ namespace AstralEngine
 		return !(*this == other);
 	}
 
+	AABB MeshRenderer::GetLocalBounds() const
+	{
+		if (!ResourceHandler::MeshIsValid(m_mesh))
+		{
+			return AABB();
+		}
+		return ResourceHandler::BorrowMesh(m_mesh)->GetBounds();
+	}
+
 	void MeshRenderer::SendDataToRenderer(const Transform& transform) const
 	{
 		Renderer::DrawMesh(transform, *this);
@@ -149,45 +179,43 @@ namespace AstralEngine
 
 	// Transform //////////////////////////////////////////////////////
 
-	Transform::Transform() : m_scale(1.0f, 1.0f, 1.0f), m_dirty(true), m_hasChanged(false) { }
+	Transform::Transform() : m_scale(1.0f, 1.0f, 1.0f), m_dirty(true), m_hasChanged(false), 
+		m_matrixVersion(0), m_parentVersion(0) { }
+
 	Transform::Transform(const Vector3& translation)
-		: m_position(translation), m_scale(1.0f, 1.0f, 1.0f), m_dirty(true), m_hasChanged(false) { }
+		: m_position(translation), m_scale(1.0f, 1.0f, 1.0f), m_dirty(true), m_hasChanged(false), 
+		m_matrixVersion(0), m_parentVersion(0) { }
 
 	Transform::Transform(const Vector3& pos, const Quaternion& rotation, const Vector3& scale)
-		: m_position(pos), m_rotation(rotation), m_scale(scale), m_dirty(true), m_hasChanged(false) { }
+		: m_position(pos), m_rotation(rotation), m_scale(scale), m_dirty(true), m_hasChanged(false), 
+		m_matrixVersion(0), m_parentVersion(0) { }
 
 	Transform::Transform(const Vector3& pos, const Vector3& euler, const Vector3& scale)
-		: m_position(pos), m_rotation(euler), m_scale(scale), m_dirty(true), m_hasChanged(false) { }
-
+		: m_position(pos), m_rotation(euler), m_scale(scale), m_dirty(true), m_hasChanged(false), 
+		m_matrixVersion(0), m_parentVersion(0) { }
 
+	/*the world matrices are normally updated in bulk once per frame by the TransformHierarchy of the scene,
+	  this recomputes the matrix on demand when the transform or one of its parents was modified since then
+	*/
 	Mat4 Transform::GetTransformMatrix() const
 	{
-		bool parentDirty = false;
-		if (m_parent != NullEntity)
+		if (m_parent.IsValid())
 		{
 			const Transform& parent = m_parent.GetTransform();
-			parentDirty = parent.m_dirty || parent.HasChanged();
+			Mat4 parentMatrix = parent.GetTransformMatrix();
+			if (m_dirty || parent.m_matrixVersion != m_parentVersion)
+			{
+				m_transformMatrix = parentMatrix * ComputeLocalMatrix();
+				m_parentVersion = parent.m_matrixVersion;
+				m_matrixVersion++;
+				m_dirty = false;
+			}
 		}
-
-		if (m_dirty || parentDirty)
+		else if (m_dirty)
 		{
-			m_hasChanged = true;
+			m_transformMatrix = ComputeLocalMatrix();
+			m_matrixVersion++;
 			m_dirty = false;
-			if (m_rotation == Quaternion::Identity())
-			{
-				m_transformMatrix = Mat4::Translate(Mat4::Identity(), m_position) * Mat4::Scale(Mat4::Identity(), m_scale);
-			}
-			else
-			{
-				Mat4 rotationMatrix = m_rotation.ComputeRotationMatrix();
-				m_transformMatrix = Mat4::Translate(Mat4::Identity(), m_position)
-					* rotationMatrix * Mat4::Scale(Mat4::Identity(), m_scale);
-			}
-
-			if (m_parent.IsValid())
-			{
-				m_transformMatrix = m_parent.GetTransform().GetTransformMatrix() * m_transformMatrix;
-			}
 		}
 		return m_transformMatrix;
 	}
@@ -197,13 +225,13 @@ namespace AstralEngine
 	void Transform::SetLocalPosition(const Vector3& position)
 	{ 
 		m_position = position;
-		m_dirty = true;
+		MarkDirty();
 	}
 
 	void Transform::SetLocalPosition(float x, float y, float z)
 	{
 		m_position = Vector3(x, y, z);
-		m_dirty = true;
+		MarkDirty();
 	}
 
 	const Quaternion& Transform::GetRotation() const { return m_rotation; }
@@ -211,19 +239,19 @@ namespace AstralEngine
 	void Transform::SetRotation(const Quaternion& rotation)
 	{
 		m_rotation = rotation;
-		m_dirty = true;
+		MarkDirty();
 	}
 
 	void Transform::SetRotation(const Vector3& euler)
 	{
 		m_rotation.SetEulerAngles(euler);
-		m_dirty = true;
+		MarkDirty();
 	}
 
 	void Transform::SetRotation(float x, float y, float z)
 	{
 		m_rotation.SetEulerAngles(x, y, z);
-		m_dirty = true;
+		MarkDirty();
 	}
 
 	const Vector3& Transform::GetScale() const { return m_scale; }
@@ -231,13 +259,19 @@ namespace AstralEngine
 	void Transform::SetScale(const Vector3& scale)
 	{
 		m_scale = scale;
-		m_dirty = true;
+		MarkDirty();
 	}
 
 	void Transform::SetParent(AEntity parent)
 	{
 		m_parent = parent;
-		m_dirty = true;
+		MarkDirty();
+
+		Scene* scene = GetScene();
+		if (scene != nullptr)
+		{
+			scene->m_transformHierarchy.OnHierarchyChanged();
+		}
 	}
 
 	void Transform::LookAt(const Transform& target, const Vector3& up)
@@ -248,7 +282,7 @@ namespace AstralEngine
 	void Transform::LookAt(const Vector3& target, const Vector3& up)
 	{
 		m_rotation = Quaternion::LookRotation(target - m_position, up);
-		m_dirty = true;
+		MarkDirty();
 	}
 
 	void Transform::RotateAround(const Vector3& point, float angle, const Vector3& axis)
@@ -258,15 +292,13 @@ namespace AstralEngine
 		Vector3 resultPosPivotSpace = rot * pivotSpacePos;
 		m_rotation = rot * m_rotation;
 		m_position = resultPosPivotSpace + point;
-		m_dirty = true;
+		MarkDirty();
 	}
 
+	unsigned int Transform::GetMatrixVersion() const { return m_matrixVersion; }
+
 	bool Transform::HasChanged() const 
 	{
-		if (m_parent != NullEntity)
-		{
-			return m_hasChanged || m_parent.GetTransform().HasChanged();
-		}
 		return m_hasChanged; 
 	}
 
@@ -285,6 +317,29 @@ namespace AstralEngine
 		return m_rotation * Vector3::Up();
 	}
 
+	void Transform::MarkDirty()
+	{
+		//the transform is already reported when it is dirty
+		Scene* scene = GetScene();
+		if (!m_dirty && scene != nullptr)
+		{
+			scene->m_transformHierarchy.OnTransformModified(GetAEntity());
+		}
+		m_dirty = true;
+	}
+
+	Mat4 Transform::ComputeLocalMatrix() const
+	{
+		if (m_rotation == Quaternion::Identity())
+		{
+			return Mat4::Translate(Mat4::Identity(), m_position) * Mat4::Scale(Mat4::Identity(), m_scale);
+		}
+		
+		Mat4 rotationMatrix = m_rotation.ComputeRotationMatrix();
+		return Mat4::Translate(Mat4::Identity(), m_position) 
+			* rotationMatrix * Mat4::Scale(Mat4::Identity(), m_scale);
+	}
+
 	bool Transform::operator==(const Transform& other) const
 	{
 		return m_position == other.m_position
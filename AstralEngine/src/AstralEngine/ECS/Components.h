@@ -10,10 +10,17 @@
 namespace AstralEngine
 {
 	// Base class used to
-	class Renderable : public ToggleableComponent
+	class Renderable : public ToggleableComponent, public AEntityLinkedComponent
 	{
+	public:
+		//box enclosing what is rendered in the local space of the entity
+		virtual AABB GetLocalBounds() const = 0;
+
 	protected:
 		virtual void SendDataToRenderer(const Transform& transform) const = 0;
+
+		//called when the renderable changes what it renders so the scene refreshes the bounds of its entity
+		void OnBoundsChanged();
 	};
 
 	class SpriteRenderer : public Renderable
@@ -34,6 +41,8 @@ namespace AstralEngine
 		Texture2DHandle GetSprite() const { return m_sprite; }
 		void SetSprite(Texture2DHandle sprite);
 
+		virtual AABB GetLocalBounds() const override;
+
 		bool operator==(const SpriteRenderer& other) const;
 		bool operator!=(const SpriteRenderer& other) const;
 
@@ -59,6 +68,8 @@ namespace AstralEngine
 		MaterialHandle GetMaterial() const;
 		void SetMaterial(MaterialHandle mat);
 
+		virtual AABB GetLocalBounds() const override;
+
 		bool operator==(const MeshRenderer& other) const;
 		bool operator!=(const MeshRenderer& other) const;
 
@@ -72,6 +83,7 @@ namespace AstralEngine
 
 	class Transform : public AEntityLinkedComponent
 	{
+		friend class TransformHierarchy;
 	public:
 		Transform();
 		Transform(const Vector3& translation);
@@ -102,9 +114,12 @@ namespace AstralEngine
 		// Note that this function does affects both the internal rotation of the transform and it's position
 		void RotateAround(const Vector3& point, float angle, const Vector3& axis = Vector3(0.0f, 1.0f, 0.0f));
 
-		// returns true if the transform has changed since last frame, false otherwise
+		// returns true if the world matrix of the transform changed since last frame, false otherwise
 		bool HasChanged() const;
 
+		// incremented every time the world matrix is recomputed, unlike HasChanged it can be compared across any number of frames
+		unsigned int GetMatrixVersion() const;
+
 		Vector3 Forward() const;
 		Vector3 Right() const;
 		Vector3 Up() const;
@@ -114,6 +129,11 @@ namespace AstralEngine
 
 
 	private:
+		Mat4 ComputeLocalMatrix() const;
+
+		//reports the transform to the TransformHierarchy of its scene the first time it is modified since its last update
+		void MarkDirty();
+
 		Vector3 m_position;
 		Quaternion m_rotation;
 		Vector3 m_scale;
@@ -122,7 +142,12 @@ namespace AstralEngine
 		
 		mutable Mat4 m_transformMatrix;
 		mutable bool m_dirty;
-		mutable bool m_hasChanged;
+		bool m_hasChanged;
+
+		//incremented every time the matrix is recomputed, a child is outdated 
+		//when the version of its parent differs from the one it was computed with
+		mutable unsigned int m_matrixVersion;
+		mutable unsigned int m_parentVersion;
 	};
 
 	class Camera sealed : public AEntityLinkedComponent, public CallbackComponent
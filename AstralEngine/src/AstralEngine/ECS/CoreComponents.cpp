@@ -57,6 +57,11 @@ namespace AstralEngine
 		return m_renderable->IsActive();
 	}
 
+	AABB RenderData::GetLocalBounds() const
+	{
+		return m_renderable->GetLocalBounds();
+	}
+
 	RenderData& RenderData::operator=(RenderData&& other) noexcept
 	{
 		delete m_renderable;
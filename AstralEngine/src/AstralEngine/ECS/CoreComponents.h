@@ -1,5 +1,6 @@
 #pragma once
 #include "AstralEngine/ECS/ECS Core/ECSUtils.h"
+#include "AstralEngine/Math/AMath.h"
 
 namespace AstralEngine
 {
@@ -32,6 +33,7 @@ namespace AstralEngine
 		
 		virtual void SendToRenderer(const Transform& transform) const = 0;
 		virtual bool IsActive() const = 0;
+		virtual AABB GetLocalBounds() const = 0;
 	};
 
 	template<typename Component>
@@ -49,6 +51,11 @@ namespace AstralEngine
 			return m_entity.GetComponent<Component>().IsActive();
 		}
 
+		virtual AABB GetLocalBounds() const override
+		{
+			return m_entity.GetComponent<Component>().GetLocalBounds();
+		}
+
 	private:
 		AEntity m_entity;
 	};
@@ -63,6 +70,7 @@ namespace AstralEngine
 
 		void SendToRenderer(const Transform& transform) const;
 		bool IsActive() const;
+		AABB GetLocalBounds() const;
 
 		RenderData& operator=(RenderData&& other) noexcept;
 		bool operator==(const RenderData& other) const;
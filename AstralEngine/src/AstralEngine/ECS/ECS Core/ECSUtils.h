@@ -1,17 +1,12 @@
 #pragma once
+#include "AstralEngine/Core/JobSystem.h"
+#include "AstralEngine/Data Struct/ASparseIndex.h"
+
 #include <type_traits>
+#include <algorithm>
 
 namespace AstralEngine
 {
-	using IDType = size_t;
-
-	enum class BaseEntity : IDType { };
-
-	constexpr auto ToIntegral(const BaseEntity entity)
-	{
-		return static_cast<std::underlying_type_t<BaseEntity>>(entity);
-	}
-
 	//Null Entity object
 	class NullObj
 	{
@@ -143,4 +138,82 @@ namespace AstralEngine
 	template<typename Type>
 	struct HasIndex<Type, std::void_t<decltype(IndexProvider<Type>::GetIndex())>> : std::true_type {};
 
+	// Parallel Iteration ////////////////////////////////////////////
+
+	//number of entities processed by a single task of a ParallelForEach
+	constexpr size_t ParallelChunkSize = 1024;
+
+	//provides the argument types of functions and callable objects with a non templated call operator
+	template<typename Func>
+	struct FunctionTraits : public FunctionTraits<decltype(&Func::operator())> { };
+
+	template<typename Return, typename... Args>
+	struct FunctionTraits<Return(*)(Args...)>
+	{
+		using Arguments = TypeList<Args...>;
+	};
+
+	template<typename Return, typename Class, typename... Args>
+	struct FunctionTraits<Return(Class::*)(Args...)>
+	{
+		using Arguments = TypeList<Args...>;
+	};
+
+	template<typename Return, typename Class, typename... Args>
+	struct FunctionTraits<Return(Class::*)(Args...) const>
+	{
+		using Arguments = TypeList<Args...>;
+	};
+
+	//false for generic lambdas and callables with an overloaded or templated call operator
+	template<typename Func, typename = void>
+	struct HasDeducibleArguments : std::false_type {};
+
+	template<typename Func>
+	struct HasDeducibleArguments<Func, std::void_t<decltype(&Func::operator())>> : std::true_type {};
+
+	template<typename Return, typename... Args>
+	struct HasDeducibleArguments<Return(*)(Args...)> : std::true_type {};
+
+	//a system writes to a component when it takes it by non-const reference
+	template<typename Comp, typename... Args>
+	constexpr bool WritesComponent(TypeList<Args...>)
+	{
+		return (std::is_same_v<Args, Comp&> || ...);
+	}
+
+	template<typename Comp, typename... Args>
+	constexpr bool AccessesComponent(TypeList<Args...>)
+	{
+		return (std::is_same_v<std::remove_cv_t<std::remove_reference_t<Args>>, Comp> || ...);
+	}
+
+	//true if a system writes to the component while another system running alongside it accesses it
+	template<typename Comp, typename... Func>
+	constexpr bool HasComponentConflict()
+	{
+		constexpr size_t writers = ((WritesComponent<Comp>(typename FunctionTraits<Func>::Arguments{}) ? 1 : 0) + ...);
+		constexpr size_t accessors = ((AccessesComponent<Comp>(typename FunctionTraits<Func>::Arguments{}) ? 1 : 0) + ...);
+		return writers > 1 || (writers == 1 && accessors > 1);
+	}
+
+	/*checks at compile time that the systems provided can safely run at the same time on the same entities, 
+	  a single system never conflicts with itself since every entity is only visited once
+	  
+	  the argument types of generic lambdas cannot be deduced, ParallelForEach rejects them with its own 
+	  static_assert when several systems are provided so no conflict is reported for them here
+	*/
+	template<typename... Func, typename... Comp>
+	constexpr bool HasAccessConflict(TypeList<Comp...>)
+	{
+		if constexpr (sizeof...(Func) < 2 || !(HasDeducibleArguments<Func>::value && ...))
+		{
+			return false;
+		}
+		else
+		{
+			return (HasComponentConflict<std::remove_const_t<Comp>, Func...>() || ...);
+		}
+	}
+
 }	
\ No newline at end of file
@@ -80,6 +80,40 @@ namespace AstralEngine
 			Traverse(std::move(function), ComponentTypeList{});
 		}
 
+		/*same as ForEach but the entities of the group are split in chunks which are processed concurrently, 
+		  when multiple systems are provided they all run over the group at the same time thus, 
+		  a component taken by non-const reference in one system cannot be accessed by the others.
+		  This is checked at compile time so the systems must then declare the types of their 
+		  parameters (no auto parameters)
+
+		  every chunk is processed by its own copy of the system so state kept in a system is not 
+		  shared between threads, the systems must not add or remove components nor create or delete entities
+		*/
+		template<typename... Func>
+		void ParallelForEach(Func... systems)
+		{
+			static_assert(sizeof...(Func) > 0, "ParallelForEach requires at least one system");
+			static_assert(sizeof...(Func) == 1 || (HasDeducibleArguments<Func>::value && ...), 
+				"Systems running in parallel must declare the types of their parameters (no auto) so their accesses can be checked");
+			static_assert(!HasAccessConflict<Func...>(TypeList<Component...>{}), 
+				"A component taken by non-const reference in a system cannot be accessed by another system running in parallel");
+
+			using ComponentTypeList = typename TypeListCat<std::conditional_t<std::is_empty_v<Component>, TypeList<>, TypeList<Component>>...>::Type;
+
+			const Entity* entities = m_handler->GetData();
+			size_t count = m_handler->GetCount();
+			size_t numChunks = (count + ParallelChunkSize - 1) / ParallelChunkSize;
+
+			JobSystem::ParallelFor(numChunks * sizeof...(Func), [&](size_t task)
+				{
+					size_t first = (task % numChunks) * ParallelChunkSize;
+					size_t last = (std::min)(first + ParallelChunkSize, count);
+					size_t system = task / numChunks;
+					size_t current = 0;
+					((current++ == system ? TraverseRange(systems, entities + first, entities + last, ComponentTypeList{}) : void()), ...);
+				});
+		}
+
 	private:
 		Group(ASparseSet<Entity>& ref, Storage<Entity, std::remove_const_t<Component>>&... gpool)
 			: m_handler(&ref), m_pools(gpool...) { }
@@ -101,6 +135,23 @@ namespace AstralEngine
 			}
 		}
 
+		template<typename Func, typename... Weak>
+		void TraverseRange(Func function, const Entity* first, const Entity* last, TypeList<Weak...>) const
+		{
+			for (; first != last; first++)
+			{
+				const Entity e = *first;
+				if constexpr (std::is_invocable_v<Func&, decltype(Get<Weak>({}))...>)
+				{
+					function(std::get<PoolType<Weak>*>(m_pools)->Get(e)...);
+				}
+				else
+				{
+					function(e, std::get<PoolType<Weak>*>(m_pools)->Get(e)...);
+				}
+			}
+		}
+
 		ASparseSet<Entity>* m_handler;
 		const std::tuple<PoolType<Component>*...> m_pools;
 	};
@@ -196,6 +247,35 @@ namespace AstralEngine
 			Traverse(std::move(function), OwnedTypeList{}, ComponentTypeList{});
 		}
 
+		/*same as ForEach but the entities of the group are split in chunks which are processed concurrently, 
+		  see the non-owning group for the restrictions on the systems provided
+		*/
+		template<typename... Func>
+		void ParallelForEach(Func... systems) const
+		{
+			static_assert(sizeof...(Func) > 0, "ParallelForEach requires at least one system");
+			static_assert(sizeof...(Func) == 1 || (HasDeducibleArguments<Func>::value && ...), 
+				"Systems running in parallel must declare the types of their parameters (no auto) so their accesses can be checked");
+			static_assert(!HasAccessConflict<Func...>(TypeList<Owned..., Component...>{}), 
+				"A component taken by non-const reference in a system cannot be accessed by another system running in parallel");
+
+			using OwnedTypeList = typename TypeListCat<std::conditional_t<std::is_empty_v<Owned>, TypeList<>, TypeList<Owned>>...>::Type;
+			using ComponentTypeList = typename TypeListCat<std::conditional_t<std::is_empty_v<Component>,
+				TypeList<>, TypeList<Component>>...>::Type;
+
+			size_t count = *m_length;
+			size_t numChunks = (count + ParallelChunkSize - 1) / ParallelChunkSize;
+
+			JobSystem::ParallelFor(numChunks * sizeof...(Func), [&](size_t task)
+				{
+					size_t first = (task % numChunks) * ParallelChunkSize;
+					size_t last = (std::min)(first + ParallelChunkSize, count);
+					size_t system = task / numChunks;
+					size_t current = 0;
+					((current++ == system ? TraverseRange(systems, first, last, OwnedTypeList{}, ComponentTypeList{}) : void()), ...);
+				});
+		}
+
 	private:
 		Group(const size_t& extend, Storage<Entity, std::remove_const_t<Owned>>&... ownedPool,
 			Storage<Entity, std::remove_const_t<Component>>&... componentPool)
@@ -232,6 +312,31 @@ namespace AstralEngine
 			}
 		}
 
+		/*the owned pools are sorted so the entities of the group occupy the same positions 
+		  in every one of them, which lets owned components be accessed by position
+		*/
+		template<typename Func, typename... Strong, typename... Weak>
+		void TraverseRange(Func function, size_t first, size_t last, TypeList<Strong...>, TypeList<Weak...>) const
+		{
+			auto it = std::make_tuple((std::get<PoolType<Strong>*>(m_pools)->begin() += first)...);
+			const Entity* entities = std::get<0>(m_pools)->ASparseSet<Entity>::GetData();
+
+			for (size_t i = first; i < last; i++)
+			{
+				const Entity entity = entities[i];
+				if constexpr (std::is_invocable_v<Func&, decltype(Get<Strong>({}))..., decltype(Get<Weak>({}))...>)
+				{
+					function(*(std::get<ComponentIterator<Strong>>(it)++)...,
+						std::get<PoolType<Weak>*>(m_pools)->Get(entity)...);
+				}
+				else
+				{
+					function(entity, *(std::get<ComponentIterator<Strong>>(it)++)...,
+						std::get<PoolType<Weak>*>(m_pools)->Get(entity)...);
+				}
+			}
+		}
+
 		const std::tuple<PoolType<Owned>*..., PoolType<Component>*...> m_pools;
 		const size_t* m_length;
 		const size_t* m_super;
@@ -23,36 +23,68 @@ namespace AstralEngine
 	{
 		using Entity = E;
 	public:
+		/*destroyed entities form an implicit free list threaded through m_entities, the slot of 
+		  a destroyed entity stores the index of the next free slot along with the generation 
+		  the entity will have once its index is recycled
+		*/
 		Entity CreateEntity()
 		{
-			if (m_destroyedPos.IsEmpty())
+			if (m_freeList == EntityTraits::IndexMask)
 			{
-				Entity e = (Entity) m_entities.GetCount();
+				AE_ECS_ASSERT(m_entities.GetCount() < EntityTraits::IndexMask, "Maximum number of entities reached");
+				Entity e = (Entity)ComposeEntity(m_entities.GetCount(), 0);
 				m_entities.Add(e);
-				return m_entities[m_entities.GetCount() - 1];
+				return e;
 			}
 
-			Entity e = { m_destroyedPos[0] };
-			m_entities[ToIntegral(m_destroyedPos[0])] = e;
-			m_destroyedPos.RemoveAt(0);
+			IDType index = m_freeList;
+			m_freeList = GetEntityIndex(m_entities[index]);
+			Entity e = (Entity)ComposeEntity(index, GetEntityGeneration(m_entities[index]));
+			m_entities[index] = e;
 			return e;
 		}
 
+		/*creates count entities and writes them to out, the recycled indices are used first and 
+		  the entity list grows once for the rest
+		*/
+		void CreateEntities(size_t count, Entity* out)
+		{
+			for (; count > 0 && m_freeList != EntityTraits::IndexMask; count--)
+			{
+				*out++ = CreateEntity();
+			}
+
+			AE_ECS_ASSERT(m_entities.GetCount() + count <= EntityTraits::IndexMask, "Maximum number of entities reached");
+			m_entities.Reserve(count);
+			for (; count > 0; count--)
+			{
+				Entity e = (Entity)ComposeEntity(m_entities.GetCount(), 0);
+				m_entities.Add(e);
+				*out++ = e;
+			}
+		}
+
+		//appends the created entities to outEntities
+		void CreateEntities(size_t count, ADynArr<Entity>& outEntities)
+		{
+			size_t first = outEntities.GetCount();
+			outEntities.ResizeUninitialized(first + count);
+			CreateEntities(count, outEntities.GetData() + first);
+		}
+
 		void DeleteEntity(const Entity e)
 		{
-			
 			AE_ECS_ASSERT(IsValid(e), "Invalid entity provided");
 			RemoveAllComponents(e);
 
-			//store old entity to recycle it's index and set that entity in the ADynArr to Null
-			m_destroyedPos.AddFirst(e);
-			m_entities[ToIntegral(e)] = Null;
+			IDType index = GetEntityIndex(e);
+			m_entities[index] = (Entity)ComposeEntity(m_freeList, GetEntityGeneration(e) + 1);
+			m_freeList = index;
 		}
 
 		bool IsValid(const Entity& e) const
 		{
-			
-			size_t index = ToIntegral(e);
+			IDType index = GetEntityIndex(e);
 			return index < m_entities.GetCount() && m_entities[index] == e;
 		}
 
@@ -65,6 +97,38 @@ namespace AstralEngine
 			return comp;
 		}
 		
+		/*adds a copy of value to each entity of [first, last), the pool grows once for the whole 
+		  range and the OnCreate delegates are called once all the components are added
+		*/
+		template<typename Component>
+		void Insert(const Entity* first, const Entity* last, const Component& value = {})
+		{
+			AE_ECS_ASSERT(std::all_of(first, last, [this](const Entity e) { return IsValid(e); }), 
+				"Invalid Entity provided to Registry");
+			Assure<Component>().Insert(*this, first, last, value);
+		}
+
+		//values holds the component of each entity of [first, last)
+		template<typename Component>
+		void Insert(const Entity* first, const Entity* last, const Component* values)
+		{
+			AE_ECS_ASSERT(std::all_of(first, last, [this](const Entity e) { return IsValid(e); }), 
+				"Invalid Entity provided to Registry");
+			Assure<Component>().Insert(*this, first, last, values);
+		}
+
+		/*removes the component of each entity of [first, last), the OnDestroy delegates are called 
+		  for the whole range before the components are removed. The range cannot be the entities 
+		  of the pool itself (from a view...), use Clear<Component> to remove all of them
+		*/
+		template<typename Component>
+		void Remove(const Entity* first, const Entity* last)
+		{
+			AE_ECS_ASSERT(std::all_of(first, last, [this](const Entity e) { return IsValid(e); }), 
+				"Invalid Entity provided to Registry");
+			Assure<Component>().Remove(*this, first, last);
+		}
+
 		template<typename Component>
 		void RemoveComponent(const Entity& e)
 		{
@@ -137,7 +201,7 @@ namespace AstralEngine
 			{
 				auto lambda = [this](auto&& pool)
 					{
-						pool.Remove(*this, pool.SparseSet<Entity>::begin(), pool.SparseSet<Entity>::end());
+						pool.RemoveAll(*this);
 					};
 				(lambda(Assure<Component>()), ...);
 			}
@@ -149,9 +213,14 @@ namespace AstralEngine
 		{
 			
 			static_assert(std::is_invocable_v<Func, Entity>);
-			for (Entity e : m_entities)
+			for (size_t i = 0; i < m_entities.GetCount(); i++)
 			{
-				function(e);
+				//slots of destroyed entities hold the index of the next free slot
+				Entity e = m_entities[i];
+				if (GetEntityIndex(e) == i)
+				{
+					function(e);
+				}
 			}
 		}
 
@@ -362,17 +431,47 @@ namespace AstralEngine
 			{
 				
 				auto& comp = Storage<Entity, Component>::Emplace(e, std::forward<Args>(args)...);
-				m_create.CallDelagates(owner, e);
+				m_create.CallDelegates(owner, e);
 				return comp;
 
 			}
 
+			void Insert(Registry<Entity>& owner, const Entity* first, const Entity* last, const Component& value)
+			{
+				Storage<Entity, Component>::Insert(first, last, value);
+				m_create.CallDelegates(owner, first, (size_t)(last - first));
+			}
+
+			void Insert(Registry<Entity>& owner, const Entity* first, const Entity* last, const Component* values)
+			{
+				Storage<Entity, Component>::Insert(first, last, values);
+				m_create.CallDelegates(owner, first, (size_t)(last - first));
+			}
+
 			void Remove(Registry<Entity>& owner, const Entity& e)
 			{
 				m_destroy(owner, e);
 				Storage<Entity, Component>::Remove(e);
 			}
 
+			void Remove(Registry<Entity>& owner, const Entity* first, const Entity* last)
+			{
+				m_destroy.CallDelegates(owner, first, (size_t)(last - first));
+				Storage<Entity, Component>::Remove(first, last);
+			}
+
+			/*the entities are visited from the back since the group handlers only move the one being 
+			  discarded towards the end of the pool, then the pool is cleared at once
+			*/
+			void RemoveAll(Registry<Entity>& owner)
+			{
+				for (size_t i = ASparseSet<Entity>::GetCount(); i > 0; i--)
+				{
+					m_destroy(owner, ASparseSet<Entity>::GetData()[i - 1]);
+				}
+				Storage<Entity, Component>::Clear();
+			}
+
 			template<typename Comp>
 			void RemoveComponent(Registry<Entity>& owner, const Entity& e)
 			{	
@@ -541,11 +640,10 @@ namespace AstralEngine
 			{
 				//make sure that the index fits in the pool list (pool list can be cleared)
 				unsigned int index = IndexProvider<Component>::GetIndex();
-				if (!(index < m_pools.GetCount()))
+				if (index >= m_pools.GetCount())
 				{
-					//if not enough space for the index we reserve that space
-					m_pools.Reserve(index + 1);
-					m_pools.EmplaceAt((size_t)index);
+					//indices are shared by every registry so the slots before index can be missing as well
+					m_pools.Resize(index + 1);
 				}
 
 				PoolData& data = m_pools[index];
@@ -628,6 +726,10 @@ namespace AstralEngine
 
 			void (*remove)(ASparseSet<Entity>&, Registry<Entity>&, const Entity) {};
 
+			//defaulted so PoolData stays an aggregate, ADynArr move constructs its elements when growing
+			PoolData() = default;
+			PoolData(PoolData&& other) noexcept = default;
+
 			PoolData& operator=(const PoolData& other)
 			{
 				return *this;
@@ -659,6 +761,6 @@ namespace AstralEngine
 		ADoublyLinkedList<GroupData> m_groups;
 		ADynArr<PoolData> m_pools;
 		ADynArr<Entity> m_entities;
-		ASinglyLinkedList<Entity> m_destroyedPos;
+		IDType m_freeList = EntityTraits::IndexMask;
 	};
 }
\ No newline at end of file
@@ -19,7 +19,7 @@ namespace AstralEngine
 		using AIterator = typename ResizableArr<Component>::AIterator;
 		using AConstIterator = typename ResizableArr<Component>::AConstIterator;
 	
-		Storage() : ASparseSet<Entity>(ADelegate<size_t(const Entity)>(&ToIntegral)) { }
+		Storage() { }
 	
 		virtual ~Storage() { }
 	
@@ -28,19 +28,55 @@ namespace AstralEngine
 		{
 			AE_ECS_ASSERT(!ASparseSet<Entity>::Contains(e), "Entity already contains the provided component type");
 
+			//the entity is added at the end of the packed array so its component goes at the end as well
 			ASparseSet<Entity>::Add(e);
-			m_components[ASparseSet<Entity>::GetIndex(e)] = Component(std::forward<Args>(args)...);
-
-			return m_components[ASparseSet<Entity>::GetIndex(e)];
+			return m_components.EmplaceBack(std::forward<Args>(args)...);
 		}
 	
+		//adds a copy of value to each entity of [first, last), the storage grows once for the whole range
+		void Insert(const Entity* first, const Entity* last, const Component& value)
+		{
+			Reserve((size_t)(last - first));
+			for (; first != last; first++)
+			{
+				AE_ECS_ASSERT(!ASparseSet<Entity>::Contains(*first), "Entity already contains the provided component type");
+				ASparseSet<Entity>::Add(*first);
+				m_components.EmplaceBack(value);
+			}
+		}
+
+		//values holds the component of each entity of [first, last)
+		void Insert(const Entity* first, const Entity* last, const Component* values)
+		{
+			Reserve((size_t)(last - first));
+			for (; first != last; first++, values++)
+			{
+				AE_ECS_ASSERT(!ASparseSet<Entity>::Contains(*first), "Entity already contains the provided component type");
+				ASparseSet<Entity>::Add(*first);
+				m_components.EmplaceBack(*values);
+			}
+		}
+
+		//makes room for count more components
+		void Reserve(size_t count)
+		{
+			ASparseSet<Entity>::Reserve(count);
+			m_components.Reserve(count);
+		}
+
+		void Remove(const Entity* first, const Entity* last)
+		{
+			for (; first != last; first++)
+			{
+				Remove(*first);
+			}
+		}
+
 		void Remove(const Entity& e)
 		{
 			AE_ECS_ASSERT(ASparseSet<Entity>::Contains(e), "Storage does not contain provided Entity");
-			//take last component and move it to the index to remove then remove the last element to be more efficient
-			Component last = std::move(m_components[m_components.GetCount() - 1]);
-			m_components[ASparseSet<Entity>::GetIndex(e)] = std::move(last);
-			m_components.RemoveAt(m_components.GetCount() - 1);
+			//the last component takes the place of the removed one like the entities do in the sparse set
+			m_components.RemoveAtSwap(ASparseSet<Entity>::GetIndex(e));
 			ASparseSet<Entity>::Remove(e);
 		}
 	
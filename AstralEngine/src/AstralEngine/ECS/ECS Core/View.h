@@ -152,6 +152,41 @@ namespace AstralEngine
 			Traverse<Comp>(std::move(function), NonEmptyType{});
 		}
 
+		/*same as ForEach but the candidate pool is split in chunks which are processed concurrently, 
+		  when multiple systems are provided they all run over the view at the same time thus, 
+		  a component taken by non-const reference in one system cannot be accessed by the others.
+		  This is checked at compile time so the systems must then declare the types of their 
+		  parameters (no auto parameters)
+
+		  every chunk is processed by its own copy of the system so state kept in a system is not 
+		  shared between threads, the systems must not add or remove components nor create or delete entities
+		*/
+		template<typename... Func>
+		void ParallelForEach(Func... systems)
+		{
+			static_assert(sizeof...(Func) > 0, "ParallelForEach requires at least one system");
+			static_assert(sizeof...(Func) == 1 || (HasDeducibleArguments<Func>::value && ...), 
+				"Systems running in parallel must declare the types of their parameters (no auto) so their accesses can be checked");
+			static_assert(!HasAccessConflict<Func...>(TypeList<Component...>{}), 
+				"A component taken by non-const reference in a system cannot be accessed by another system running in parallel");
+
+			using NonEmptyType = typename TypeListCat<std::conditional_t<std::is_empty_v<Component>, TypeList<>, TypeList<Component>>...>::Type;
+
+			const ASparseSet<Entity>& view = GetCanditate();
+			const Entity* entities = view.GetData();
+			size_t count = view.GetCount();
+			size_t numChunks = (count + ParallelChunkSize - 1) / ParallelChunkSize;
+
+			JobSystem::ParallelFor(numChunks * sizeof...(Func), [&](size_t task)
+				{
+					size_t first = (task % numChunks) * ParallelChunkSize;
+					size_t last = (std::min)(first + ParallelChunkSize, count);
+					size_t system = task / numChunks;
+					size_t current = 0;
+					((current++ == system ? TraverseRange(systems, entities + first, entities + last, NonEmptyType{}) : void()), ...);
+				});
+		}
+
 	private:
 
 		class ViewIterator
@@ -368,6 +403,28 @@ namespace AstralEngine
 		}
 
 
+		//calls the function on the entities of [first, last) which are part of the view
+		template<typename Func, typename... Type>
+		void TraverseRange(Func function, const Entity* first, const Entity* last, TypeList<Type...>) const
+		{
+			for (; first != last; first++)
+			{
+				const Entity entity = *first;
+				if ((std::get<PoolType<Component>*>(m_pools)->Contains(entity) && ...)
+					&& (!std::get<PoolType<Exclude>*>(m_pools)->Contains(entity) && ...))
+				{
+					if constexpr (std::is_invocable_v<Func&, decltype(Get<Type>({}))...>)
+					{
+						function(std::get<PoolType<Type>*>(m_pools)->Get(entity)...);
+					}
+					else
+					{
+						function(entity, std::get<PoolType<Type>*>(m_pools)->Get(entity)...);
+					}
+				}
+			}
+		}
+
 		const std::tuple<PoolType<Component>*..., PoolType<Exclude>*...> m_pools;
 	};
 
@@ -450,9 +507,71 @@ namespace AstralEngine
 			}
 		}
 
+		/*same as ForEach but the pool is split in chunks which are processed concurrently, 
+		  see the multi component view for the restrictions on the systems provided
+		*/
+		template<typename... Func>
+		void ParallelForEach(Func... systems) const
+		{
+			static_assert(sizeof...(Func) > 0, "ParallelForEach requires at least one system");
+			static_assert(sizeof...(Func) == 1 || (HasDeducibleArguments<Func>::value && ...), 
+				"Systems running in parallel must declare the types of their parameters (no auto) so their accesses can be checked");
+			static_assert(!HasAccessConflict<Func...>(TypeList<Component>{}), 
+				"A component taken by non-const reference in a system cannot be accessed by another system running in parallel");
+
+			size_t count = m_pool->GetCount();
+			size_t numChunks = (count + ParallelChunkSize - 1) / ParallelChunkSize;
+
+			JobSystem::ParallelFor(numChunks * sizeof...(Func), [&](size_t task)
+				{
+					size_t first = (task % numChunks) * ParallelChunkSize;
+					size_t last = (std::min)(first + ParallelChunkSize, count);
+					size_t system = task / numChunks;
+					size_t current = 0;
+					((current++ == system ? TraverseRange(systems, first, last) : void()), ...);
+				});
+		}
+
 	private:
 		View(PoolType& ref) : m_pool(&ref) { }
 
+		//calls the function on the entities stored at the positions [first, last) of the pool
+		template<typename Func>
+		void TraverseRange(Func function, size_t first, size_t last) const
+		{
+			const Entity* entities = m_pool->ASparseSet<Entity>::GetData();
+			if constexpr (std::is_empty_v<Component>)
+			{
+				for (size_t i = first; i < last; i++)
+				{
+					if constexpr (std::is_invocable_v<Func&>)
+					{
+						function();
+					}
+					else
+					{
+						function(entities[i]);
+					}
+				}
+			}
+			else
+			{
+				auto it = m_pool->begin();
+				it += first;
+				for (size_t i = first; i < last; i++)
+				{
+					if constexpr (std::is_invocable_v<Func&, decltype(Get({}))>)
+					{
+						function(*(it++));
+					}
+					else
+					{
+						function(entities[i], *(it++));
+					}
+				}
+			}
+		}
+
 		PoolType* m_pool;
 	};
 
@@ -4,6 +4,7 @@
 #include "AstralEngine/Data Struct/AReference.h"
 #include "AstralEngine/Renderer/Renderer.h"
 #include "AstralEngine/Renderer/RenderCommand.h"
+#include "AstralEngine/Renderer/Frustum.h"
 #include "AstralEngine/Core/Application.h"
 #include "Scene.h"
 #include "AEntity.h"
@@ -134,6 +135,15 @@ namespace AstralEngine
 
 	Scene::Scene(bool rotation)
 	{
+		m_registry.OnCreate<RenderData>().AddDelegate(ADelegate<void(Registry<BaseEntity>&, const BaseEntity)>()
+			.BindFunction<&Scene::OnRenderDataCreated>(this));
+		m_registry.OnDestroy<RenderData>().AddDelegate(ADelegate<void(Registry<BaseEntity>&, const BaseEntity)>()
+			.BindFunction<&Scene::OnRenderDataDestroyed>(this));
+		m_registry.OnCreate<Transform>().AddDelegate(ADelegate<void(Registry<BaseEntity>&, const BaseEntity)>()
+			.BindFunction<&TransformHierarchy::OnTransformCreated>(&m_transformHierarchy));
+		m_registry.OnDestroy<Transform>().AddDelegate(ADelegate<void(Registry<BaseEntity>&, const BaseEntity)>()
+			.BindFunction<&TransformHierarchy::OnTransformDestroyed>(&m_transformHierarchy));
+
 		AEntity camera = CreateAEntity();
 		camera.GetTransform().SetLocalPosition(0.0f, 0.0f, -8.0f);
 		camera.EmplaceComponent<Camera>().SetAsMain(true);
@@ -152,6 +162,27 @@ namespace AstralEngine
 		return e;
 	}
 
+	void Scene::CreateAEntities(size_t count, ADynArr<AEntity>& outEntities)
+	{
+		AE_PROFILE_FUNCTION();
+		ADynArr<BaseEntity> entities(count);
+		m_registry.CreateEntities(count, entities);
+
+		//the pools grow once and the groups are updated in a single pass
+		const BaseEntity* first = entities.GetData();
+		const BaseEntity* last = first + entities.GetCount();
+		m_registry.Insert<Transform>(first, last);
+		m_registry.Insert<AEntityData>(first, last);
+
+		outEntities.Reserve(count);
+		for (BaseEntity e : entities)
+		{
+			AEntity entity = AEntity(e, this);
+			m_registry.GetComponent<Transform>(e).m_entity = entity;
+			outEntities.Add(entity);
+		}
+	}
+
 	//destroys an entity at the end of the frame
 	void Scene::DestroyAEntity(AEntity e)
 	{
@@ -173,6 +204,10 @@ namespace AstralEngine
 		}
 		////////////////////////////////////////////
 
+		//update the world matrices of every transform before they are used for rendering
+		m_transformHierarchy.Update(m_registry);
+		UpdateCullingTree();
+
 		Camera* mainCamera = nullptr;
 		Transform* cameraTransform;
 		
@@ -195,12 +230,14 @@ namespace AstralEngine
 			AE_PROFILE_SCOPE("Rendering");
 
 			Renderer::BeginScene(*mainCamera, *cameraTransform);
-			
-			auto group = m_registry.GetGroup<AEntityData, Transform, RenderData>();
 
-			for (BaseEntity e : group)
+			//only the renderables whose bounds intersect the frustum of the camera are sent to the renderer
+			m_visibleEntities.Clear();
+			m_cullingTree.Query(Frustum(Renderer::GetViewProjMatrix()), m_visibleEntities);
+
+			for (BaseEntity e : m_visibleEntities)
 			{
-				auto [data, transform, render] = group.Get<AEntityData, Transform, RenderData>(e);
+				auto [data, transform, render] = m_registry.GetComponent<AEntityData, Transform, RenderData>(e);
 				if (data.IsActive())
 				{
 					if (render.IsActive())
@@ -268,6 +305,123 @@ namespace AstralEngine
 		}
 	}
 
+	//the proxy is created during the next update once the world matrix of the entity is known
+	void Scene::OnRenderDataCreated(Registry<BaseEntity>& registry, const BaseEntity e)
+	{
+		m_proxiesToCreate.Add(e);
+	}
+
+	void Scene::OnRenderDataDestroyed(Registry<BaseEntity>& registry, const BaseEntity e)
+	{
+		int proxy = GetCullingProxy(e);
+		if (proxy != AABBTree::s_nullNode)
+		{
+			m_cullingTree.Remove(proxy);
+			m_cullingProxies[GetEntityIndex(e)] = AABBTree::s_nullNode;
+		}
+	}
+
+	void Scene::OnRenderableBoundsChanged(BaseEntity e)
+	{
+		m_boundsChanged.Add(e);
+	}
+
+	void Scene::UpdateCullingTree()
+	{
+		AE_PROFILE_FUNCTION();
+
+		for (BaseEntity e : m_proxiesToCreate)
+		{
+			//the entity or its RenderData could have been destroyed before the update
+			if (!m_registry.IsValid(e) || !m_registry.HasComponent<RenderData>(e) 
+				|| !m_registry.HasComponent<Transform>(e) || !m_registry.HasComponent<AEntityData>(e)
+				|| GetCullingProxy(e) != AABBTree::s_nullNode)
+			{
+				continue;
+			}
+
+			size_t index = GetEntityIndex(e);
+			while (m_cullingProxies.GetCount() <= index)
+			{
+				m_cullingProxies.Add(AABBTree::s_nullNode);
+			}
+			m_cullingProxies[index] = m_cullingTree.Insert(ComputeWorldBounds(e), e);
+			TrackMeshLoad(e);
+		}
+		m_proxiesToCreate.Clear();
+
+		for (BaseEntity e : m_boundsChanged)
+		{
+			int proxy = GetCullingProxy(e);
+			if (m_registry.IsValid(e) && proxy != AABBTree::s_nullNode)
+			{
+				m_cullingTree.Move(proxy, ComputeWorldBounds(e));
+				TrackMeshLoad(e);
+			}
+		}
+		m_boundsChanged.Clear();
+
+		//only the entities which were rendering the placeholder of a mesh which was just loaded are refitted
+		for (MeshHandle mesh : ResourceHandler::GetFinalizedMeshes())
+		{
+			if (!m_entitiesAwaitingMesh.ContainsKey(mesh))
+			{
+				continue;
+			}
+
+			for (BaseEntity e : m_entitiesAwaitingMesh[mesh])
+			{
+				//the entity could have been destroyed or could render another mesh since it was tracked
+				int proxy = GetCullingProxy(e);
+				if (m_registry.IsValid(e) && proxy != AABBTree::s_nullNode && m_registry.HasComponent<MeshRenderer>(e)
+					&& m_registry.GetComponent<MeshRenderer>(e).GetMesh() == mesh)
+				{
+					m_cullingTree.Move(proxy, ComputeWorldBounds(e));
+				}
+			}
+			m_entitiesAwaitingMesh.Remove(mesh);
+		}
+
+		for (BaseEntity e : m_transformHierarchy.GetChangedEntities())
+		{
+			int proxy = GetCullingProxy(e);
+			if (proxy != AABBTree::s_nullNode)
+			{
+				m_cullingTree.Move(proxy, ComputeWorldBounds(e));
+			}
+		}
+	}
+
+	void Scene::TrackMeshLoad(BaseEntity e)
+	{
+		if (!m_registry.HasComponent<MeshRenderer>(e))
+		{
+			return;
+		}
+
+		MeshHandle mesh = m_registry.GetComponent<MeshRenderer>(e).GetMesh();
+		if (ResourceHandler::MeshIsLoading(mesh))
+		{
+			m_entitiesAwaitingMesh[mesh].Add(e);
+		}
+	}
+
+	int Scene::GetCullingProxy(BaseEntity e) const
+	{
+		size_t index = GetEntityIndex(e);
+		if (index >= m_cullingProxies.GetCount())
+		{
+			return AABBTree::s_nullNode;
+		}
+		return m_cullingProxies[index];
+	}
+
+	AABB Scene::ComputeWorldBounds(BaseEntity e)
+	{
+		auto [transform, render] = m_registry.GetComponent<Transform, RenderData>(e);
+		return AABB::Transform(render.GetLocalBounds(), transform.GetTransformMatrix());
+	}
+
 	void Scene::DestroyEntitiesToDestroy()
 	{
 		for (AEntity& e : m_entitiesToDestroy)
@@ -1,5 +1,8 @@
 #pragma once
 #include "ECS Core/Registry.h"
+#include "TransformHierarchy.h"
+#include "AABBTree.h"
+#include "AstralEngine/Core/Resource.h"
 
 
 namespace AstralEngine
@@ -8,11 +11,16 @@ namespace AstralEngine
 	class Scene
 	{
 		friend class AEntity;
+		friend class Renderable;
+		friend class Transform;
 	public:
 		Scene(bool rotation = true);
 
 		AEntity CreateAEntity();
 
+		//creates count entities at once and appends them to outEntities (used when loading large levels)
+		void CreateAEntities(size_t count, ADynArr<AEntity>& outEntities);
+
 		void DestroyAEntity(AEntity e);
 
 		void OnUpdate();
@@ -25,7 +33,37 @@ namespace AstralEngine
 		void CallOnLateUpdate();
 		void DestroyEntitiesToDestroy();
 
+		void OnRenderDataCreated(Registry<BaseEntity>& registry, const BaseEntity e);
+		void OnRenderDataDestroyed(Registry<BaseEntity>& registry, const BaseEntity e);
+
+		//the bounds of the entity are refreshed during the next update of the culling tree
+		void OnRenderableBoundsChanged(BaseEntity e);
+
+		/*inserts the renderables created since the last update in the culling tree and moves the ones 
+		  whose transform or local bounds changed along with the ones rendering a mesh which was just loaded
+		*/
+		void UpdateCullingTree();
+
+		//remembers the entity if it renders a mesh which is still loading so its bounds are refreshed once it is loaded
+		void TrackMeshLoad(BaseEntity e);
+		int GetCullingProxy(BaseEntity e) const;
+		AABB ComputeWorldBounds(BaseEntity e);
+
 		Registry<BaseEntity> m_registry;
+		TransformHierarchy m_transformHierarchy;
+
+		//renderables of the scene, queried against the frustum of the camera before they are sent to the renderer
+		AABBTree m_cullingTree;
+
+		//proxy of every entity in the culling tree indexed by the index part of the entity
+		ADynArr<int> m_cullingProxies;
+		ADynArr<BaseEntity> m_proxiesToCreate;
+		ADynArr<BaseEntity> m_visibleEntities;
+		ADynArr<BaseEntity> m_boundsChanged;
+
+		//entities rendering each mesh which is still loading
+		AUnorderedMap<MeshHandle, ADynArr<BaseEntity>> m_entitiesAwaitingMesh;
+
 		ADynArr<AEntity> m_entitiesToDestroy;
 		unsigned int m_viewportWidth;
 		unsigned int m_viewportHeight;
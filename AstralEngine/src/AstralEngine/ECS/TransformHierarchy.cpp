@@ -0,0 +1,412 @@
+#include "aepch.h"
+#include "TransformHierarchy.h"
+#include "Components.h"
+#include "AstralEngine/Core/JobSystem.h"
+
+#include <algorithm>
+
+#ifdef AE_SIMD_SSE
+	#include <xmmintrin.h>
+#endif
+
+namespace AstralEngine
+{
+	//number of transforms handled by a single job when computing local matrices
+	static constexpr size_t s_localMatrixBatchSize = 1024;
+
+	TransformHierarchy::TransformHierarchy() : m_needsRebuild(false) { }
+
+	void TransformHierarchy::Update(Registry<BaseEntity>& registry)
+	{
+		AE_PROFILE_FUNCTION();
+
+		//HasChanged only reports the changes of the last update
+		auto view = registry.GetView<Transform>();
+		for (BaseEntity e : m_changedEntities)
+		{
+			if (registry.IsValid(e) && view.Contains(e))
+			{
+				view.Get(e).m_hasChanged = false;
+			}
+		}
+		m_changedEntities.Clear();
+
+		if (m_needsRebuild)
+		{
+			RebuildOrder(registry);
+		}
+
+		GatherDirty(registry);
+		if (m_updateSlots.IsEmpty())
+		{
+			return;
+		}
+
+		//only the groups of four slots holding a modified transform have their local matrices recomputed
+		constexpr size_t groupsPerBatch = s_localMatrixBatchSize / 4;
+		size_t numBatches = (m_dirtyGroups.GetCount() + groupsPerBatch - 1) / groupsPerBatch;
+		JobSystem::ParallelFor(numBatches, [this, groupsPerBatch](size_t batch)
+			{
+				size_t first = batch * groupsPerBatch;
+				size_t last = (std::min)(first + groupsPerBatch, m_dirtyGroups.GetCount());
+				for (size_t i = first; i < last; i++)
+				{
+					ComputeLocalMatrices(m_dirtyGroups[i] * 4, m_dirtyGroups[i] * 4 + 4);
+				}
+			});
+
+		ComputeWorldMatrices(registry);
+	}
+
+	void TransformHierarchy::OnTransformModified(BaseEntity e)
+	{
+		m_modified.Add(e);
+	}
+
+	void TransformHierarchy::RebuildOrder(Registry<BaseEntity>& registry)
+	{
+		AE_PROFILE_FUNCTION();
+		auto view = registry.GetView<Transform>();
+		size_t count = view.GetCount();
+
+		//depth of every entity indexed by the index part of its id
+		constexpr size_t unknownDepth = MAXSIZE_T;
+		ADynArr<size_t> depthOf;
+		ASmallArr<BaseEntity, 16> chain;
+		size_t maxDepth = 0;
+
+		auto getParent = [&registry, &view](BaseEntity e) -> BaseEntity
+		{
+			BaseEntity parent = (BaseEntity)view.Get(e).m_parent;
+			if (parent == Null || !registry.IsValid(parent) || !view.Contains(parent))
+			{
+				return Null;
+			}
+			return parent;
+		};
+
+		for (BaseEntity e : view)
+		{
+			Transform& t = view.Get(e);
+
+			//the parent of the transform was destroyed, its world matrix must drop the parent's contribution
+			if (t.m_parent != NullEntity && getParent(e) == Null)
+			{
+				t.m_dirty = true;
+			}
+
+			//walk up the hierarchy until an entity with a known depth is found then assign the depths on the way back
+			BaseEntity curr = e;
+			while (curr != Null && (GetEntityIndex(curr) >= depthOf.GetCount() || depthOf[GetEntityIndex(curr)] == unknownDepth))
+			{
+				AE_CORE_ASSERT(chain.GetCount() <= count, "Cycle detected in the Transform hierarchy");
+				chain.Add(curr);
+				curr = getParent(curr);
+			}
+
+			size_t depth = curr == Null ? 0 : depthOf[GetEntityIndex(curr)] + 1;
+			for (size_t i = chain.GetCount(); i > 0; i--)
+			{
+				size_t index = GetEntityIndex(chain[i - 1]);
+				while (depthOf.GetCount() <= index)
+				{
+					depthOf.Add(unknownDepth);
+				}
+				depthOf[index] = depth;
+				maxDepth = (std::max)(maxDepth, depth);
+				depth++;
+			}
+			chain.Clear();
+		}
+
+		//counting sort of the entities by depth so parents always come before their children
+		ADynArr<size_t> depthStart;
+		depthStart.Resize(maxDepth + 2, 0);
+
+		for (BaseEntity e : view)
+		{
+			depthStart[depthOf[GetEntityIndex(e)] + 1]++;
+		}
+
+		for (size_t i = 1; i < depthStart.GetCount(); i++)
+		{
+			depthStart[i] += depthStart[i - 1];
+		}
+
+		m_order.Clear();
+		m_order.Resize(count, Null);
+
+		m_slotOf.Clear();
+		m_slotOf.Resize(depthOf.GetCount(), s_noSlot);
+
+		for (BaseEntity e : view)
+		{
+			size_t slot = depthStart[depthOf[GetEntityIndex(e)]]++;
+			m_order[slot] = e;
+			m_slotOf[GetEntityIndex(e)] = slot;
+		}
+
+		m_parentSlot.Clear();
+		m_parentSlot.Reserve(count);
+		m_childStart.Clear();
+		m_childStart.Resize(count + 1, 0);
+		for (BaseEntity e : m_order)
+		{
+			BaseEntity parent = getParent(e);
+			size_t parentSlot = parent == Null ? s_noSlot : m_slotOf[GetEntityIndex(parent)];
+			m_parentSlot.Add(parentSlot);
+			if (parentSlot != s_noSlot)
+			{
+				m_childStart[parentSlot + 1]++;
+			}
+		}
+
+		//the children of every slot are stored contiguously
+		for (size_t i = 1; i < m_childStart.GetCount(); i++)
+		{
+			m_childStart[i] += m_childStart[i - 1];
+		}
+
+		ADynArr<size_t> childEnd = m_childStart;
+		m_children.Clear();
+		m_children.ResizeUninitialized(count);
+		for (size_t slot = 0; slot < count; slot++)
+		{
+			if (m_parentSlot[slot] != s_noSlot)
+			{
+				m_children[childEnd[m_parentSlot[slot]]++] = slot;
+			}
+		}
+
+		//the slots moved so the local matrices of the whole hierarchy are stored again, padded with identity transforms
+		size_t paddedCount = (count + 3) & ~(size_t)3;
+		m_posX.Clear(); m_posY.Clear(); m_posZ.Clear();
+		m_rotX.Clear(); m_rotY.Clear(); m_rotZ.Clear(); m_rotW.Clear();
+		m_scaleX.Clear(); m_scaleY.Clear(); m_scaleZ.Clear();
+		m_posX.Resize(paddedCount, 0.0f); m_posY.Resize(paddedCount, 0.0f); m_posZ.Resize(paddedCount, 0.0f);
+		m_rotX.Resize(paddedCount, 0.0f); m_rotY.Resize(paddedCount, 0.0f); 
+		m_rotZ.Resize(paddedCount, 0.0f); m_rotW.Resize(paddedCount, 1.0f);
+		m_scaleX.Resize(paddedCount, 1.0f); m_scaleY.Resize(paddedCount, 1.0f); m_scaleZ.Resize(paddedCount, 1.0f);
+		m_localMatrices.Resize(paddedCount);
+
+		for (size_t slot = 0; slot < count; slot++)
+		{
+			Transform& t = view.Get(m_order[slot]);
+			StoreLocalTransform(slot, t);
+
+			//new transforms and the ones which lost their parent are reported here
+			if (t.m_dirty)
+			{
+				m_modified.Add(m_order[slot]);
+			}
+		}
+
+		size_t numBatches = (paddedCount + s_localMatrixBatchSize - 1) / s_localMatrixBatchSize;
+		JobSystem::ParallelFor(numBatches, [this, paddedCount](size_t batch)
+			{
+				size_t first = batch * s_localMatrixBatchSize;
+				ComputeLocalMatrices(first, (std::min)(first + s_localMatrixBatchSize, paddedCount));
+			});
+
+		m_willUpdate.Clear();
+		m_willUpdate.Resize(count, false);
+		m_groupIsDirty.Clear();
+		m_groupIsDirty.Resize(paddedCount / 4, false);
+		m_needsRebuild = false;
+	}
+
+	void TransformHierarchy::GatherDirty(Registry<BaseEntity>& registry)
+	{
+		AE_PROFILE_FUNCTION();
+		auto view = registry.GetView<Transform>();
+		m_updateSlots.Clear();
+		m_dirtyGroups.Clear();
+
+		for (BaseEntity e : m_modified)
+		{
+			//the entity could have been destroyed or reported more than once
+			size_t index = GetEntityIndex(e);
+			size_t slot = index < m_slotOf.GetCount() ? m_slotOf[index] : s_noSlot;
+			if (slot == s_noSlot || m_order[slot] != e || m_willUpdate[slot])
+			{
+				continue;
+			}
+
+			StoreLocalTransform(slot, view.Get(e));
+			m_willUpdate[slot] = true;
+			m_updateSlots.Add(slot);
+
+			size_t group = slot / 4;
+			if (!m_groupIsDirty[group])
+			{
+				m_groupIsDirty[group] = true;
+				m_dirtyGroups.Add(group);
+			}
+		}
+		m_modified.Clear();
+
+		//the descendants of the modified transforms keep their local matrix but their world matrix changes
+		for (size_t i = 0; i < m_updateSlots.GetCount(); i++)
+		{
+			size_t slot = m_updateSlots[i];
+			for (size_t c = m_childStart[slot]; c < m_childStart[slot + 1]; c++)
+			{
+				size_t child = m_children[c];
+				if (!m_willUpdate[child])
+				{
+					m_willUpdate[child] = true;
+					m_updateSlots.Add(child);
+				}
+			}
+		}
+
+		//slots are sorted by depth so a parent is always updated before its children
+		std::sort(m_updateSlots.GetData(), m_updateSlots.GetData() + m_updateSlots.GetCount());
+	}
+
+	void TransformHierarchy::StoreLocalTransform(size_t slot, const Transform& t)
+	{
+		m_posX[slot] = t.m_position.x;
+		m_posY[slot] = t.m_position.y;
+		m_posZ[slot] = t.m_position.z;
+		m_rotX[slot] = t.m_rotation.GetX();
+		m_rotY[slot] = t.m_rotation.GetY();
+		m_rotZ[slot] = t.m_rotation.GetZ();
+		m_rotW[slot] = t.m_rotation.GetW();
+		m_scaleX[slot] = t.m_scale.x;
+		m_scaleY[slot] = t.m_scale.y;
+		m_scaleZ[slot] = t.m_scale.z;
+	}
+
+	/*computes translation * rotation * scale for four transforms at a time,
+	  matches Quaternion::ComputeRotationMatrix for the rotation part
+	*/
+	void TransformHierarchy::ComputeLocalMatrices(size_t first, size_t last)
+	{
+#ifdef AE_SIMD_SSE
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 zero = _mm_setzero_ps();
+
+		for (size_t i = first; i < last; i += 4)
+		{
+			__m128 x = _mm_loadu_ps(m_rotX.GetData() + i);
+			__m128 y = _mm_loadu_ps(m_rotY.GetData() + i);
+			__m128 z = _mm_loadu_ps(m_rotZ.GetData() + i);
+			__m128 w = _mm_loadu_ps(m_rotW.GetData() + i);
+
+			__m128 twoX = _mm_add_ps(x, x);
+			__m128 twoY = _mm_add_ps(y, y);
+			__m128 twoZ = _mm_add_ps(z, z);
+			__m128 x2 = _mm_mul_ps(x, twoX);
+			__m128 y2 = _mm_mul_ps(y, twoY);
+			__m128 z2 = _mm_mul_ps(z, twoZ);
+			__m128 xy = _mm_mul_ps(x, twoY);
+			__m128 xz = _mm_mul_ps(x, twoZ);
+			__m128 yz = _mm_mul_ps(y, twoZ);
+			__m128 xw = _mm_mul_ps(twoX, w);
+			__m128 yw = _mm_mul_ps(twoY, w);
+			__m128 zw = _mm_mul_ps(twoZ, w);
+
+			__m128 scaleX = _mm_loadu_ps(m_scaleX.GetData() + i);
+			__m128 scaleY = _mm_loadu_ps(m_scaleY.GetData() + i);
+			__m128 scaleZ = _mm_loadu_ps(m_scaleZ.GetData() + i);
+
+			//rows of each column of the matrices, every lane belongs to a different transform
+			__m128 columns[4][4] = {
+				{
+					_mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, y2), z2), scaleX),
+					_mm_mul_ps(_mm_add_ps(xy, zw), scaleX),
+					_mm_mul_ps(_mm_sub_ps(xz, yw), scaleX),
+					zero
+				},
+				{
+					_mm_mul_ps(_mm_sub_ps(xy, zw), scaleY),
+					_mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, x2), z2), scaleY),
+					_mm_mul_ps(_mm_add_ps(yz, xw), scaleY),
+					zero
+				},
+				{
+					_mm_mul_ps(_mm_add_ps(xz, yw), scaleZ),
+					_mm_mul_ps(_mm_sub_ps(yz, xw), scaleZ),
+					_mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, x2), y2), scaleZ),
+					zero
+				},
+				{
+					_mm_loadu_ps(m_posX.GetData() + i),
+					_mm_loadu_ps(m_posY.GetData() + i),
+					_mm_loadu_ps(m_posZ.GetData() + i),
+					one
+				}
+			};
+
+			for (unsigned int col = 0; col < 4; col++)
+			{
+				__m128 r0 = columns[col][0];
+				__m128 r1 = columns[col][1];
+				__m128 r2 = columns[col][2];
+				__m128 r3 = columns[col][3];
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+				_mm_storeu_ps(&m_localMatrices[i][col].x, r0);
+				_mm_storeu_ps(&m_localMatrices[i + 1][col].x, r1);
+				_mm_storeu_ps(&m_localMatrices[i + 2][col].x, r2);
+				_mm_storeu_ps(&m_localMatrices[i + 3][col].x, r3);
+			}
+		}
+#else
+		for (size_t i = first; i < last; i++)
+		{
+			float twoX = m_rotX[i] * 2.0f;
+			float twoY = m_rotY[i] * 2.0f;
+			float twoZ = m_rotZ[i] * 2.0f;
+			float x2 = m_rotX[i] * twoX;
+			float y2 = m_rotY[i] * twoY;
+			float z2 = m_rotZ[i] * twoZ;
+			float xy = m_rotX[i] * twoY;
+			float xz = m_rotX[i] * twoZ;
+			float yz = m_rotY[i] * twoZ;
+			float xw = twoX * m_rotW[i];
+			float yw = twoY * m_rotW[i];
+			float zw = twoZ * m_rotW[i];
+
+			m_localMatrices[i] = Mat4(
+				Vector4(1.0f - y2 - z2, xy + zw, xz - yw, 0.0f) * m_scaleX[i],
+				Vector4(xy - zw, 1.0f - x2 - z2, yz + xw, 0.0f) * m_scaleY[i],
+				Vector4(xz + yw, yz - xw, 1.0f - x2 - y2, 0.0f) * m_scaleZ[i],
+				Vector4(m_posX[i], m_posY[i], m_posZ[i], 1.0f));
+		}
+#endif
+	}
+
+	void TransformHierarchy::ComputeWorldMatrices(Registry<BaseEntity>& registry)
+	{
+		AE_PROFILE_FUNCTION();
+		auto view = registry.GetView<Transform>();
+		for (size_t slot : m_updateSlots)
+		{
+			BaseEntity e = m_order[slot];
+			Transform& t = view.Get(e);
+
+			if (m_parentSlot[slot] == s_noSlot)
+			{
+				t.m_transformMatrix = m_localMatrices[slot];
+			}
+			else
+			{
+				const Transform& parent = view.Get(m_order[m_parentSlot[slot]]);
+				t.m_transformMatrix = parent.m_transformMatrix * m_localMatrices[slot];
+				t.m_parentVersion = parent.m_matrixVersion;
+			}
+
+			t.m_matrixVersion++;
+			t.m_dirty = false;
+			t.m_hasChanged = true;
+			m_changedEntities.Add(e);
+			m_willUpdate[slot] = false;
+		}
+
+		for (size_t group : m_dirtyGroups)
+		{
+			m_groupIsDirty[group] = false;
+		}
+	}
+}
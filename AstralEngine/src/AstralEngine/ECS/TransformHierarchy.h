@@ -0,0 +1,79 @@
+#pragma once
+#include "ECS Core/Registry.h"
+#include "AstralEngine/Math/AMath.h"
+
+namespace AstralEngine
+{
+	class Transform;
+
+	/*updates the world matrices of the Transforms of a scene once per frame
+
+	  the transforms are kept sorted by depth in the hierarchy so parents are always updated before
+	  their children. The setters of Transform report the modified transforms so only those and their
+	  descendants are visited. The local position, rotation and scale of every transform are kept in 
+	  persistent structure of arrays buffers in the same order, the local matrices of the modified 
+	  transforms are computed four at a time using SSE (when available) before being combined with 
+	  the matrix of their parent
+	*/
+	class TransformHierarchy
+	{
+	public:
+		TransformHierarchy();
+
+		void Update(Registry<BaseEntity>& registry);
+
+		//the world matrix of the entity is recomputed during the next update
+		void OnTransformModified(BaseEntity e);
+
+		//the order is rebuilt during the next update when transforms are added, removed or reparented
+		void OnHierarchyChanged() { m_needsRebuild = true; }
+		void OnTransformCreated(Registry<BaseEntity>& registry, const BaseEntity e) { m_needsRebuild = true; }
+		void OnTransformDestroyed(Registry<BaseEntity>& registry, const BaseEntity e) { m_needsRebuild = true; }
+
+		//number of transforms which had their world matrix recomputed during the last update
+		size_t GetUpdatedCount() const { return m_updateSlots.GetCount(); }
+
+		//entities whose world matrix changed during the last update, see Transform::HasChanged
+		const ADynArr<BaseEntity>& GetChangedEntities() const { return m_changedEntities; }
+
+	private:
+		static constexpr size_t s_noSlot = MAXSIZE_T;
+
+		void RebuildOrder(Registry<BaseEntity>& registry);
+		void GatherDirty(Registry<BaseEntity>& registry);
+		void StoreLocalTransform(size_t slot, const Transform& t);
+		void ComputeLocalMatrices(size_t first, size_t last);
+		void ComputeWorldMatrices(Registry<BaseEntity>& registry);
+
+		//hierarchy sorted by depth, m_parentSlot stores the position of the parent in m_order
+		ADynArr<BaseEntity> m_order;
+		ADynArr<size_t> m_parentSlot;
+
+		//the children of the transform at slot i are stored in m_children from m_childStart[i] to m_childStart[i + 1]
+		ADynArr<size_t> m_childStart;
+		ADynArr<size_t> m_children;
+
+		//position of every entity in m_order indexed by the index part of its id
+		ADynArr<size_t> m_slotOf;
+
+		//local transform of every slot stored as structure of arrays, padded to a multiple of four
+		ADynArr<float> m_posX, m_posY, m_posZ;
+		ADynArr<float> m_rotX, m_rotY, m_rotZ, m_rotW;
+		ADynArr<float> m_scaleX, m_scaleY, m_scaleZ;
+		ADynArr<Mat4> m_localMatrices;
+
+		//entities reported by the setters of Transform since the last update, can hold duplicates
+		ADynArr<BaseEntity> m_modified;
+		bool m_needsRebuild;
+
+		/*slots whose world matrix is recomputed this update sorted by depth, along with the groups of four 
+		  slots whose local matrices are recomputed. The flags are only set during the update
+		*/
+		ADynArr<size_t> m_updateSlots;
+		ADynArr<size_t> m_dirtyGroups;
+		ADynArr<bool> m_willUpdate;
+		ADynArr<bool> m_groupIsDirty;
+
+		ADynArr<BaseEntity> m_changedEntities;
+	};
+}
@@ -2,6 +2,7 @@
 
 HANDLE AstralEngine::Logger::s_handle;
 std::ofstream AstralEngine::Logger::s_file;
+std::mutex AstralEngine::Logger::s_mutex;
 
 extern AstralEngine::Application* CreateApp();
 
@@ -0,0 +1,67 @@
+#include "aepch.h"
+#include "AABB.h"
+
+namespace AstralEngine
+{
+	AABB::AABB() { }
+	AABB::AABB(const Vector3& lower, const Vector3& upper) : lowerBound(lower), upperBound(upper) { }
+
+	Vector3 AABB::GetCenter() const
+	{
+		return (lowerBound + upperBound) * 0.5f;
+	}
+
+	Vector3 AABB::GetExtents() const
+	{
+		return (upperBound - lowerBound) * 0.5f;
+	}
+
+	float AABB::GetSurfaceArea() const
+	{
+		Vector3 size = upperBound - lowerBound;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	bool AABB::Contains(const AABB& other) const
+	{
+		return lowerBound.x <= other.lowerBound.x && lowerBound.y <= other.lowerBound.y 
+			&& lowerBound.z <= other.lowerBound.z && upperBound.x >= other.upperBound.x 
+			&& upperBound.y >= other.upperBound.y && upperBound.z >= other.upperBound.z;
+	}
+
+	bool AABB::Overlaps(const AABB& other) const
+	{
+		return lowerBound.x <= other.upperBound.x && lowerBound.y <= other.upperBound.y
+			&& lowerBound.z <= other.upperBound.z && upperBound.x >= other.lowerBound.x
+			&& upperBound.y >= other.lowerBound.y && upperBound.z >= other.lowerBound.z;
+	}
+
+	const AABB AABB::Expand(const Vector3& margin) const
+	{
+		return AABB(lowerBound - margin, upperBound + margin);
+	}
+
+	const AABB AABB::Merge(const AABB& a, const AABB& b)
+	{
+		return AABB(
+			Vector3(Math::Min(a.lowerBound.x, b.lowerBound.x), Math::Min(a.lowerBound.y, b.lowerBound.y),
+				Math::Min(a.lowerBound.z, b.lowerBound.z)),
+			Vector3(Math::Max(a.upperBound.x, b.upperBound.x), Math::Max(a.upperBound.y, b.upperBound.y),
+				Math::Max(a.upperBound.z, b.upperBound.z)));
+	}
+
+	const AABB AABB::Transform(const AABB& box, const Mat4& transform)
+	{
+		//the extents of the transformed box are the extents projected on the absolute value of the matrix
+		Vector3 localCenter = box.GetCenter();
+		Vector3 center = Vector3(transform * Vector4(localCenter.x, localCenter.y, localCenter.z, 1.0f));
+		Vector3 extents = box.GetExtents();
+		Vector3 newExtents;
+		for (unsigned int row = 0; row < 3; row++)
+		{
+			newExtents[row] = Math::Abs(transform[0][row]) * extents.x + Math::Abs(transform[1][row]) * extents.y
+				+ Math::Abs(transform[2][row]) * extents.z;
+		}
+		return AABB(center - newExtents, center + newExtents);
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "Vectors/Vector3.h"
+#include "Matrices/Mat4.h"
+
+namespace AstralEngine
+{
+	//axis aligned bounding box
+	class AABB
+	{
+	public:
+		AABB();
+		AABB(const Vector3& lower, const Vector3& upper);
+
+		Vector3 GetCenter() const;
+
+		// half the size of the box along every axis
+		Vector3 GetExtents() const;
+		float GetSurfaceArea() const;
+
+		bool Contains(const AABB& other) const;
+		bool Overlaps(const AABB& other) const;
+
+		// box grown by margin in every direction
+		const AABB Expand(const Vector3& margin) const;
+
+		static const AABB Merge(const AABB& a, const AABB& b);
+
+		// smallest box enclosing the transformed corners of the box provided (Arvo's method)
+		static const AABB Transform(const AABB& box, const Mat4& transform);
+
+		Vector3 lowerBound;
+		Vector3 upperBound;
+	};
+}
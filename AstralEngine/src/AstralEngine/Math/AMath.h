@@ -16,3 +16,6 @@
 // Matrices //////////////////////////////////////////////
 #include "Matrices/Mat3.h"
 #include "Matrices/Mat4.h"
+
+// Geometry //////////////////////////////////////////////
+#include "AABB.h"
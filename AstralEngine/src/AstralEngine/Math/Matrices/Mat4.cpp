@@ -2,8 +2,159 @@
 #include "AstralEngine/Math/Utils.h"
 #include "Mat4.h"
 
+#ifdef AE_SIMD_SSE
+	#include <immintrin.h>
+#endif
+
 namespace AstralEngine
 {
+	static_assert(sizeof(Mat4) == sizeof(float) * 16, "the SIMD code expects Mat4 to be 16 tightly packed floats");
+
+#ifdef AE_SIMD_SSE
+	// SIMD helpers /////////////////////////////////////////////////
+
+	//sum of the four columns weighted by the components of v
+	static inline __m128 CombineColumns(__m128 c0, __m128 c1, __m128 c2, __m128 c3, __m128 v)
+	{
+		__m128 result = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+		result = _mm_add_ps(result, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+		result = _mm_add_ps(result, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+		return _mm_add_ps(result, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+	}
+
+	//every column of the product is the columns of lhs weighted by the matching column of rhs
+	static inline void MultiplySSE(const float* lhs, const float* rhs, float* out)
+	{
+		__m128 c0 = _mm_loadu_ps(lhs);
+		__m128 c1 = _mm_loadu_ps(lhs + 4);
+		__m128 c2 = _mm_loadu_ps(lhs + 8);
+		__m128 c3 = _mm_loadu_ps(lhs + 12);
+
+		//everything is loaded before storing so out can alias lhs or rhs
+		__m128 r0 = CombineColumns(c0, c1, c2, c3, _mm_loadu_ps(rhs));
+		__m128 r1 = CombineColumns(c0, c1, c2, c3, _mm_loadu_ps(rhs + 4));
+		__m128 r2 = CombineColumns(c0, c1, c2, c3, _mm_loadu_ps(rhs + 8));
+		__m128 r3 = CombineColumns(c0, c1, c2, c3, _mm_loadu_ps(rhs + 12));
+
+		_mm_storeu_ps(out, r0);
+		_mm_storeu_ps(out + 4, r1);
+		_mm_storeu_ps(out + 8, r2);
+		_mm_storeu_ps(out + 12, r3);
+	}
+
+#ifdef AE_SIMD_AVX2
+	//same as MultiplySSE but computes two columns of the product at a time
+	static inline void MultiplyAVX2(const float* lhs, const float* rhs, float* out)
+	{
+		__m256 c0 = _mm256_broadcast_ps((const __m128*)lhs);
+		__m256 c1 = _mm256_broadcast_ps((const __m128*)(lhs + 4));
+		__m256 c2 = _mm256_broadcast_ps((const __m128*)(lhs + 8));
+		__m256 c3 = _mm256_broadcast_ps((const __m128*)(lhs + 12));
+
+		__m256 b01 = _mm256_loadu_ps(rhs);
+		__m256 b23 = _mm256_loadu_ps(rhs + 8);
+
+		__m256 r01 = _mm256_mul_ps(c0, _mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0)));
+		r01 = _mm256_fmadd_ps(c1, _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1)), r01);
+		r01 = _mm256_fmadd_ps(c2, _mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2)), r01);
+		r01 = _mm256_fmadd_ps(c3, _mm256_permute_ps(b01, _MM_SHUFFLE(3, 3, 3, 3)), r01);
+
+		__m256 r23 = _mm256_mul_ps(c0, _mm256_permute_ps(b23, _MM_SHUFFLE(0, 0, 0, 0)));
+		r23 = _mm256_fmadd_ps(c1, _mm256_permute_ps(b23, _MM_SHUFFLE(1, 1, 1, 1)), r23);
+		r23 = _mm256_fmadd_ps(c2, _mm256_permute_ps(b23, _MM_SHUFFLE(2, 2, 2, 2)), r23);
+		r23 = _mm256_fmadd_ps(c3, _mm256_permute_ps(b23, _MM_SHUFFLE(3, 3, 3, 3)), r23);
+
+		_mm256_storeu_ps(out, r01);
+		_mm256_storeu_ps(out + 8, r23);
+	}
+#endif
+
+	// 2x2 matrices stored in a single register as (m00, m01, m10, m11)
+
+	//a * b
+	static inline __m128 Mat2Multiply(__m128 a, __m128 b)
+	{
+		return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	//adjugate(a) * b
+	static inline __m128 Mat2AdjugateMultiply(__m128 a, __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+	}
+
+	//a * adjugate(b)
+	static inline __m128 Mat2MultiplyAdjugate(__m128 a, __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	/*inverts the matrix by splitting it in four 2x2 blocks, returns false if the matrix is not invertable.
+
+	  the blocks are built from the columns so this computes the inverse of the transpose, 
+	  storing its rows as columns transposes it back
+	*/
+	static inline bool InverseSSE(const float* m, float* out)
+	{
+		__m128 c0 = _mm_loadu_ps(m);
+		__m128 c1 = _mm_loadu_ps(m + 4);
+		__m128 c2 = _mm_loadu_ps(m + 8);
+		__m128 c3 = _mm_loadu_ps(m + 12);
+
+		__m128 a = _mm_movelh_ps(c0, c1);
+		__m128 b = _mm_movehl_ps(c1, c0);
+		__m128 c = _mm_movelh_ps(c2, c3);
+		__m128 d = _mm_movehl_ps(c3, c2);
+
+		//determinants of the blocks as (|a|, |b|, |c|, |d|)
+		__m128 detBlocks = _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+			_mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+		__m128 detA = _mm_shuffle_ps(detBlocks, detBlocks, _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 detB = _mm_shuffle_ps(detBlocks, detBlocks, _MM_SHUFFLE(1, 1, 1, 1));
+		__m128 detC = _mm_shuffle_ps(detBlocks, detBlocks, _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 detD = _mm_shuffle_ps(detBlocks, detBlocks, _MM_SHUFFLE(3, 3, 3, 3));
+
+		__m128 dc = Mat2AdjugateMultiply(d, c);
+		__m128 ab = Mat2AdjugateMultiply(a, b);
+
+		__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Multiply(b, dc));
+		__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Multiply(c, ab));
+		__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MultiplyAdjugate(d, ab));
+		__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MultiplyAdjugate(a, dc));
+
+		//|m| = |a| * |d| + |b| * |c| - trace(adjugate(a) * b * adjugate(d) * c)
+		__m128 trace = _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, _MM_SHUFFLE(3, 1, 2, 0)));
+		trace = _mm_add_ps(trace, _mm_movehl_ps(trace, trace));
+		trace = _mm_add_ss(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 1, 1, 1)));
+		trace = _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(0, 0, 0, 0));
+
+		__m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+		if (_mm_cvtss_f32(det) == 0.0f)
+		{
+			return false;
+		}
+
+		__m128 inverseDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+		x = _mm_mul_ps(x, inverseDet);
+		y = _mm_mul_ps(y, inverseDet);
+		z = _mm_mul_ps(z, inverseDet);
+		w = _mm_mul_ps(w, inverseDet);
+
+		//applies the adjugate of the blocks while putting them back in place
+		_mm_storeu_ps(out, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+		_mm_storeu_ps(out + 4, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+		_mm_storeu_ps(out + 8, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+		_mm_storeu_ps(out + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+		return true;
+	}
+#endif
+
+	// Mat4 ////////////////////////////////////////////////////////
+
 	Mat4::Mat4()
 	{
 		m_vectors[0] = Vector4::Zero();
@@ -83,6 +234,14 @@ namespace AstralEngine
 	const Mat4 Mat4::Inverse()  const
 	{
 		AE_PROFILE_FUNCTION();
+#ifdef AE_SIMD_SSE
+		Mat4 result;
+		if (!InverseSSE(Data(), &result.m_vectors[0].x))
+		{
+			return Mat4::Zero();
+		}
+		return result;
+#else
 		float det = Determinant();
 		if (det == 0.0f)
 		{
@@ -91,6 +250,7 @@ namespace AstralEngine
 
 		Mat4 adjugate = CalculateAdjugate();
 		return adjugate / det;
+#endif
 	}
 	
 	const Mat4 Mat4::Transpose() const
@@ -102,11 +262,26 @@ namespace AstralEngine
 		//31, 32, 33, 34  z
 		//41, 42, 43, 44  w
 
+#ifdef AE_SIMD_SSE
+		__m128 c0 = _mm_loadu_ps(Data());
+		__m128 c1 = _mm_loadu_ps(Data() + 4);
+		__m128 c2 = _mm_loadu_ps(Data() + 8);
+		__m128 c3 = _mm_loadu_ps(Data() + 12);
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+		Mat4 result;
+		_mm_storeu_ps(&result.m_vectors[0].x, c0);
+		_mm_storeu_ps(&result.m_vectors[1].x, c1);
+		_mm_storeu_ps(&result.m_vectors[2].x, c2);
+		_mm_storeu_ps(&result.m_vectors[3].x, c3);
+		return result;
+#else
 		return Mat4(
 			{Get(0, 0), Get(0, 1), Get(0, 2), Get(0, 3)},
 			{Get(1, 0), Get(1, 1), Get(1, 2), Get(1, 3)},
 			{Get(2, 0), Get(2, 1), Get(2, 2), Get(2, 3)},
 			{Get(3, 0), Get(3, 1), Get(3, 2), Get(3, 3)});
+#endif
 	}
 	
 	const float Mat4::Trace() const
@@ -235,13 +410,78 @@ namespace AstralEngine
 
 	const Mat4 Mat4::Zero() { return Mat4(); }
 
+	void Mat4::MultiplyArray(const Mat4* lhs, const Mat4* rhs, Mat4* out, size_t count)
+	{
+		AE_PROFILE_FUNCTION();
+		for (size_t i = 0; i < count; i++)
+		{
+#if defined(AE_SIMD_AVX2)
+			MultiplyAVX2(lhs[i].Data(), rhs[i].Data(), &out[i].m_vectors[0].x);
+#elif defined(AE_SIMD_SSE)
+			MultiplySSE(lhs[i].Data(), rhs[i].Data(), &out[i].m_vectors[0].x);
+#else
+			out[i] = lhs[i] * rhs[i];
+#endif
+		}
+	}
+
+	void Mat4::TransformArray(const Mat4& m, const Vector4* points, Vector4* out, size_t count)
+	{
+		AE_PROFILE_FUNCTION();
+		size_t i = 0;
+#if defined(AE_SIMD_AVX2)
+		//two points per iteration, each half of the registers holds a copy of the columns
+		__m256 c0 = _mm256_broadcast_ps((const __m128*)m.Data());
+		__m256 c1 = _mm256_broadcast_ps((const __m128*)(m.Data() + 4));
+		__m256 c2 = _mm256_broadcast_ps((const __m128*)(m.Data() + 8));
+		__m256 c3 = _mm256_broadcast_ps((const __m128*)(m.Data() + 12));
+
+		for (; i + 2 <= count; i += 2)
+		{
+			__m256 p = _mm256_loadu_ps(&points[i].x);
+			__m256 result = _mm256_mul_ps(c0, _mm256_permute_ps(p, _MM_SHUFFLE(0, 0, 0, 0)));
+			result = _mm256_fmadd_ps(c1, _mm256_permute_ps(p, _MM_SHUFFLE(1, 1, 1, 1)), result);
+			result = _mm256_fmadd_ps(c2, _mm256_permute_ps(p, _MM_SHUFFLE(2, 2, 2, 2)), result);
+			result = _mm256_fmadd_ps(c3, _mm256_permute_ps(p, _MM_SHUFFLE(3, 3, 3, 3)), result);
+			_mm256_storeu_ps(&out[i].x, result);
+		}
+#endif
+
+#ifdef AE_SIMD_SSE
+		__m128 col0 = _mm_loadu_ps(m.Data());
+		__m128 col1 = _mm_loadu_ps(m.Data() + 4);
+		__m128 col2 = _mm_loadu_ps(m.Data() + 8);
+		__m128 col3 = _mm_loadu_ps(m.Data() + 12);
+
+		for (; i < count; i++)
+		{
+			_mm_storeu_ps(&out[i].x, CombineColumns(col0, col1, col2, col3, _mm_loadu_ps(&points[i].x)));
+		}
+#else
+		for (; i < count; i++)
+		{
+			out[i] = m * points[i];
+		}
+#endif
+	}
+
 	const Mat4 Mat4::operator*(float k) const
 	{
+#ifdef AE_SIMD_SSE
+		__m128 scalar = _mm_set1_ps(k);
+		Mat4 result;
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			_mm_storeu_ps(&result.m_vectors[i].x, _mm_mul_ps(_mm_loadu_ps(&m_vectors[i].x), scalar));
+		}
+		return result;
+#else
 		return Mat4(
 			{ m_vectors[0].x * k,  m_vectors[0].y * k, m_vectors[0].z * k, m_vectors[0].w * k},
 			{ m_vectors[1].x * k,  m_vectors[1].y * k, m_vectors[1].z * k, m_vectors[1].w * k},
 			{ m_vectors[2].x * k,  m_vectors[2].y * k, m_vectors[2].z * k, m_vectors[2].w * k},
 			{ m_vectors[3].x * k,  m_vectors[3].y * k, m_vectors[3].z * k, m_vectors[3].w * k});
+#endif
 	}
 
 	const Mat4 Mat4::operator/(float k) const
@@ -259,7 +499,11 @@ namespace AstralEngine
 		//31, 32, 33, 34  z
 		//41, 42, 43, 44  w
 
-		AE_PROFILE_FUNCTION();
+#ifdef AE_SIMD_SSE
+		Mat4 result;
+		MultiplySSE(Data(), other.Data(), &result.m_vectors[0].x);
+		return result;
+#else
 		float f11 = (Get(0, 0) * other.Get(0, 0)) + (Get(0, 1) * other.Get(1, 0)) + 
 			(Get(0, 2) * other.Get(2, 0)) + (Get(0, 3) * other.Get(3, 0));
 		float f12 = (Get(0, 0) * other.Get(0, 1)) + (Get(0, 1) * other.Get(1, 1)) + 
@@ -310,30 +554,23 @@ namespace AstralEngine
 			{ f12, f22, f32, f42 },
 			{ f13, f23, f33, f43 },
 			{ f14, f24, f34, f44 });
+#endif
 	}
 
 	const Mat4 Mat4::operator+(const Mat4& other) const
 	{
-		return Mat4(
-			{ m_vectors[0].x + other.m_vectors[0].x,
-			  m_vectors[0].y * other.m_vectors[0].y,
-			  m_vectors[0].z * other.m_vectors[0].z, 
-			  m_vectors[0].w * other.m_vectors[0].w },
-
-			{ m_vectors[1].x + other.m_vectors[1].x,
-			  m_vectors[1].y * other.m_vectors[1].y,
-			  m_vectors[1].z * other.m_vectors[1].z,
-          	  m_vectors[1].w * other.m_vectors[1].w },
-
-			{ m_vectors[2].x + other.m_vectors[2].x,
-			  m_vectors[2].y * other.m_vectors[2].y,
-			  m_vectors[2].z * other.m_vectors[2].z,
-			  m_vectors[2].w * other.m_vectors[2].w },
-			
-			{ m_vectors[3].x + other.m_vectors[3].x,
-			  m_vectors[3].y * other.m_vectors[3].y,
-			  m_vectors[3].z * other.m_vectors[3].z,
-			  m_vectors[3].w * other.m_vectors[3].w });
+#ifdef AE_SIMD_SSE
+		Mat4 result;
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			_mm_storeu_ps(&result.m_vectors[i].x, 
+				_mm_add_ps(_mm_loadu_ps(&m_vectors[i].x), _mm_loadu_ps(&other.m_vectors[i].x)));
+		}
+		return result;
+#else
+		return Mat4(m_vectors[0] + other.m_vectors[0], m_vectors[1] + other.m_vectors[1], 
+			m_vectors[2] + other.m_vectors[2], m_vectors[3] + other.m_vectors[3]);
+#endif
 	}
 	
 	const Mat4 Mat4::operator+=(const Mat4& other) const { return *this + other; }
@@ -347,13 +584,19 @@ namespace AstralEngine
 		//31, 32, 33, 34  z
 		//41, 42, 43, 44  w
 
-		AE_PROFILE_FUNCTION();
+#ifdef AE_SIMD_SSE
+		Vector4 result;
+		_mm_storeu_ps(&result.x, CombineColumns(_mm_loadu_ps(Data()), _mm_loadu_ps(Data() + 4), 
+			_mm_loadu_ps(Data() + 8), _mm_loadu_ps(Data() + 12), _mm_loadu_ps(&v.x)));
+		return result;
+#else
 		float x = (Get(0, 0) * v.x) + (Get(0, 1) * v.y) + (Get(0, 2) * v.z) + (Get(0, 3) * v.w);
 		float y = (Get(1, 0) * v.x) + (Get(1, 1) * v.y) + (Get(1, 2) * v.z) + (Get(1, 3) * v.w);
 		float z = (Get(2, 0) * v.x) + (Get(2, 1) * v.y) + (Get(2, 2) * v.z) + (Get(2, 3) * v.w);
 		float w = (Get(3, 0) * v.x) + (Get(3, 1) * v.y) + (Get(3, 2) * v.z) + (Get(3, 3) * v.w);
 
 		return Vector4(x, y, z, w);
+#endif
 	}
 	
 	Mat4 operator*(float k, const Mat4& m) { return m * k; }
@@ -39,6 +39,12 @@ namespace AstralEngine
 		static const Mat4 Identity();
 		static const Mat4 Zero();
 
+		//out[i] = lhs[i] * rhs[i] for every matrix of the arrays, out can be the same array as lhs or rhs
+		static void MultiplyArray(const Mat4* lhs, const Mat4* rhs, Mat4* out, size_t count);
+
+		//out[i] = m * points[i] for every vector of the array, out can be the same array as points
+		static void TransformArray(const Mat4& m, const Vector4* points, Vector4* out, size_t count);
+
 		const Mat4 operator*(float k) const;
 		const Mat4 operator/(float k) const;
 		const Mat4 operator*(const Mat4& other) const;
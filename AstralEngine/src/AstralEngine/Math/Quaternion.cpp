@@ -1,8 +1,14 @@
 #include "aepch.h"
 #include "Quaternions.h"
 
+#ifdef AE_SIMD_SSE
+	#include <xmmintrin.h>
+#endif
+
 namespace AstralEngine
 {
+	static_assert(sizeof(Quaternion) == sizeof(float) * 4, "the SIMD code expects Quaternion to be 4 tightly packed floats (w, x, y, z)");
+
 	Quaternion::Quaternion() : m_w(1.0f) { }
 	Quaternion::Quaternion(float w, const Vector3& v) : m_w(w), m_v(v) { }
 	Quaternion::Quaternion(float w, float x, float y, float z) : m_w(w), m_v(x, y, z) {	}
@@ -279,11 +285,29 @@ namespace AstralEngine
 
 	Quaternion Quaternion::operator*(const Quaternion& q) const
 	{
+#ifdef AE_SIMD_SSE
+		//every lane is (w, x, y, z), the product is the sum of q scaled by each component of this quaternion
+		__m128 lhs = _mm_loadu_ps(&m_w);
+		__m128 rhs = _mm_loadu_ps(&q.m_w);
+
+		__m128 result = _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(0, 0, 0, 0)), rhs);
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(1, 1, 1, 1)),
+			_mm_mul_ps(_mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(2, 3, 0, 1)), _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f))));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2, 2, 2, 2)),
+			_mm_mul_ps(_mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(1, 0, 3, 2)), _mm_setr_ps(-1.0f, 1.0f, 1.0f, -1.0f))));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(3, 3, 3, 3)),
+			_mm_mul_ps(_mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(0, 1, 2, 3)), _mm_setr_ps(-1.0f, -1.0f, 1.0f, 1.0f))));
+
+		Quaternion product;
+		_mm_storeu_ps(&product.m_w, result);
+		return product;
+#else
 		return Quaternion(
 			m_w * q.m_w - m_v.x * q.m_v.x - m_v.y * q.m_v.y - m_v.z * q.m_v.z,
 			m_w * q.m_v.x + q.m_w * m_v.x + m_v.y * q.m_v.z - q.m_v.y * m_v.z,
 			m_w * q.m_v.y + q.m_w * m_v.y + m_v.z * q.m_v.x - q.m_v.z * m_v.x,
 			m_w * q.m_v.z + q.m_w * m_v.z + m_v.x * q.m_v.y - q.m_v.x * m_v.y);
+#endif
 	}
 
 	Quaternion Quaternion::operator*(float k) const
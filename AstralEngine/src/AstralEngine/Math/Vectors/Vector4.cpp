@@ -6,8 +6,14 @@
 #include "Vector4.h"
 #include "Vector4Int.h"
 
+#ifdef AE_SIMD_SSE
+	#include <xmmintrin.h>
+#endif
+
 namespace AstralEngine
 {
+	static_assert(sizeof(Vector4) == sizeof(float) * 4, "the SIMD code expects Vector4 to be 4 tightly packed floats");
+
 	Vector4::Vector4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) { }
 	Vector4::Vector4(float X, float Y, float Z, float W) : x(X), y(Y), z(Z), w(W) { }
 	Vector4::Vector4(const Vector2& v2) : x(v2.x), y(v2.y), z(0.0f), w(0.0f) { }
@@ -49,8 +55,28 @@ namespace AstralEngine
 	}
 
 	const Vector4 Vector4::operator-() const { return Vector4(-x, -y, -z, -w); }
-	const Vector4 Vector4::operator+(const Vector4& v) const { return Vector4(x + v.x, y + v.y, z + v.z, w + v.w); }
-	const Vector4 Vector4::operator-(const Vector4& v) const { return Vector4(x - v.x, y - v.y, z - v.z, w - v.w); }
+
+	const Vector4 Vector4::operator+(const Vector4& v) const 
+	{
+#ifdef AE_SIMD_SSE
+		Vector4 result;
+		_mm_storeu_ps(&result.x, _mm_add_ps(_mm_loadu_ps(&x), _mm_loadu_ps(&v.x)));
+		return result;
+#else
+		return Vector4(x + v.x, y + v.y, z + v.z, w + v.w); 
+#endif
+	}
+
+	const Vector4 Vector4::operator-(const Vector4& v) const 
+	{
+#ifdef AE_SIMD_SSE
+		Vector4 result;
+		_mm_storeu_ps(&result.x, _mm_sub_ps(_mm_loadu_ps(&x), _mm_loadu_ps(&v.x)));
+		return result;
+#else
+		return Vector4(x - v.x, y - v.y, z - v.z, w - v.w); 
+#endif
+	}
 	
 	const Vector4& Vector4::operator+=(const Vector4& v) 
 	{ 
@@ -64,7 +90,17 @@ namespace AstralEngine
 		return *this;
 	}
 	
-	const Vector4 Vector4::operator*(float k) const { return Vector4(x * k, y * k, z * k, w * k); }
+	const Vector4 Vector4::operator*(float k) const 
+	{
+#ifdef AE_SIMD_SSE
+		Vector4 result;
+		_mm_storeu_ps(&result.x, _mm_mul_ps(_mm_loadu_ps(&x), _mm_set1_ps(k)));
+		return result;
+#else
+		return Vector4(x * k, y * k, z * k, w * k); 
+#endif
+	}
+
 	const Vector4 Vector4::operator/(float k) const { return Vector4(x / k, y / k, z / k, w / k); }
 	float& Vector4::operator[](unsigned int index)
 	{
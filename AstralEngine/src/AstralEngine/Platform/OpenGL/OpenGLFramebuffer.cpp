@@ -41,7 +41,7 @@ namespace AstralEngine
 	void OpenGLFramebuffer::Bind() const 
 	{
 		glBindFramebuffer(GL_FRAMEBUFFER, m_rendererID);
-		ADynArr<unsigned int> attachments = ADynArr<unsigned int>(m_largestColorAttachmentIndex);
+		ASmallArr<unsigned int, 8> attachments;
 		for (size_t i = 0; i < m_largestColorAttachmentIndex; i++)
 		{
 			if (m_colorAttachments[i] != NullHandle);
@@ -5,18 +5,27 @@
 
 namespace AstralEngine
 {
-	OpenGLIndexBuffer::OpenGLIndexBuffer() : m_count(0)
+	OpenGLIndexBuffer::OpenGLIndexBuffer() : m_count(0), m_format(IndexFormat::UnsignedInt)
 	{
 		glCreateBuffers(1, &m_rendererID);
 	}
 
-	OpenGLIndexBuffer::OpenGLIndexBuffer(unsigned int* indices, unsigned int count) : m_count(count)
+	OpenGLIndexBuffer::OpenGLIndexBuffer(unsigned int* indices, unsigned int count) 
+		: m_count(count), m_format(IndexFormat::UnsignedInt)
 	{
 		glCreateBuffers(1, &m_rendererID);
 		Bind();
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_count * sizeof(unsigned int), indices, GL_STATIC_DRAW);
 	}
 
+	OpenGLIndexBuffer::OpenGLIndexBuffer(unsigned short* indices, unsigned int count)
+		: m_count(count), m_format(IndexFormat::UnsignedShort)
+	{
+		glCreateBuffers(1, &m_rendererID);
+		Bind();
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_count * sizeof(unsigned short), indices, GL_STATIC_DRAW);
+	}
+
 	OpenGLIndexBuffer::~OpenGLIndexBuffer() 
 	{
 		glDeleteBuffers(1, &m_rendererID);
@@ -35,6 +44,7 @@ namespace AstralEngine
 	void OpenGLIndexBuffer::SetData(const unsigned int* data, unsigned int count)
 	{
 		m_count = count;
+		m_format = IndexFormat::UnsignedInt;
 		Bind();
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_count * sizeof(unsigned int), data, GL_DYNAMIC_DRAW);
 	}
@@ -8,6 +8,7 @@ namespace AstralEngine
 	public:
 		OpenGLIndexBuffer();
 		OpenGLIndexBuffer(unsigned int* indices, unsigned int count);
+		OpenGLIndexBuffer(unsigned short* indices, unsigned int count);
 		~OpenGLIndexBuffer();
 
 		virtual void Bind() const override;
@@ -15,9 +16,11 @@ namespace AstralEngine
 		virtual void SetData(const unsigned int* data, unsigned int count) override;
 
 		inline virtual int GetCount() const override {	return m_count;	}
+		inline virtual IndexFormat GetFormat() const override { return m_format; }
 
 	private:
 		unsigned int m_rendererID;
 		unsigned int m_count;
+		IndexFormat m_format;
 	};
 }
\ No newline at end of file
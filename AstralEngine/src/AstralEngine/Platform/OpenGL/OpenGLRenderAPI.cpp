@@ -24,6 +24,21 @@ namespace AstralEngine
 		return 0;
 	}
 
+	static unsigned int IndexFormatToOpenGLType(IndexFormat format)
+	{
+		switch (format)
+		{
+		case IndexFormat::UnsignedShort:
+			return GL_UNSIGNED_SHORT;
+
+		case IndexFormat::UnsignedInt:
+			return GL_UNSIGNED_INT;
+		}
+
+		AE_CORE_ERROR("Unknown index format provided");
+		return 0;
+	}
+
 	void OpenGLRenderAPI::Init()
 	{
 		glEnable(GL_BLEND);
@@ -89,17 +104,19 @@ namespace AstralEngine
 
 	void OpenGLRenderAPI::DrawIndexed(const AReference<IndexBuffer>& indexBuffer)
 	{
-		glDrawElements(GL_TRIANGLES, indexBuffer->GetCount(), GL_UNSIGNED_INT, nullptr);
+		glDrawElements(GL_TRIANGLES, indexBuffer->GetCount(), 
+			IndexFormatToOpenGLType(indexBuffer->GetFormat()), nullptr);
 	}
 
 	void OpenGLRenderAPI::DrawIndexed(const AReference<IndexBuffer>& indexBuffer, unsigned int count)
 	{
-		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+		glDrawElements(GL_TRIANGLES, count, IndexFormatToOpenGLType(indexBuffer->GetFormat()), nullptr);
 	}
 
 	void OpenGLRenderAPI::DrawIndexed(RenderingPrimitive primitive, const AReference<IndexBuffer>& indexBuffer, unsigned int count) 
 	{
-		glDrawElements(RenderingPrimitiveToOpenGLPrimitive(primitive), count, GL_UNSIGNED_INT, nullptr);
+		glDrawElements(RenderingPrimitiveToOpenGLPrimitive(primitive), count, 
+			IndexFormatToOpenGLType(indexBuffer->GetFormat()), nullptr);
 	}
 
 	void OpenGLRenderAPI::DrawInstancedIndexed(const AReference<IndexBuffer>& indexBuffer, 
@@ -109,6 +126,7 @@ namespace AstralEngine
 		{
 			count = indexBuffer->GetCount();
 		}
-		glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, instanceAmount);
+		glDrawElementsInstanced(GL_TRIANGLES, count, IndexFormatToOpenGLType(indexBuffer->GetFormat()), 
+			nullptr, instanceAmount);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "aepch.h"
+#include "Frustum.h"
+
+namespace AstralEngine
+{
+	Frustum::Frustum()
+	{
+		for (size_t i = 0; i < 6; i++)
+		{
+			m_planes[i] = Vector4::Zero();
+			m_absNormals[i] = Vector3::Zero();
+		}
+	}
+
+	Frustum::Frustum(const Mat4& viewProj)
+	{
+		//the columns of the matrix are stored so the rows are gathered from them
+		Vector4 rows[4];
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			rows[i] = Vector4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+		}
+
+		// left, right, bottom, top, near, far
+		m_planes[0] = rows[3] + rows[0];
+		m_planes[1] = rows[3] - rows[0];
+		m_planes[2] = rows[3] + rows[1];
+		m_planes[3] = rows[3] - rows[1];
+		m_planes[4] = rows[3] + rows[2];
+		m_planes[5] = rows[3] - rows[2];
+
+		//normalize the planes so the distances they compute are in world units
+		for (size_t i = 0; i < 6; i++)
+		{
+			float length = Vector3(m_planes[i].x, m_planes[i].y, m_planes[i].z).Magnitude();
+			if (length > 0.0f)
+			{
+				m_planes[i] = m_planes[i] / length;
+			}
+			m_absNormals[i] = Vector3(Math::Abs(m_planes[i].x), Math::Abs(m_planes[i].y), Math::Abs(m_planes[i].z));
+		}
+	}
+
+	bool Frustum::Intersects(const Vector3& center, float radius) const
+	{
+		for (size_t i = 0; i < 6; i++)
+		{
+			if (DistanceToPlane(i, center) < -radius)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Frustum::Contains(const Vector3& center, float radius) const
+	{
+		for (size_t i = 0; i < 6; i++)
+		{
+			if (DistanceToPlane(i, center) < radius)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Frustum::Intersects(const AABB& box) const
+	{
+		return Classify(box) != FrustumOverlap::Outside;
+	}
+
+	bool Frustum::Contains(const AABB& box) const
+	{
+		return Classify(box) == FrustumOverlap::Inside;
+	}
+
+	FrustumOverlap Frustum::Classify(const AABB& box) const
+	{
+		//the components are used directly since this runs for every node visited when culling
+		float centerX = (box.lowerBound.x + box.upperBound.x) * 0.5f;
+		float centerY = (box.lowerBound.y + box.upperBound.y) * 0.5f;
+		float centerZ = (box.lowerBound.z + box.upperBound.z) * 0.5f;
+		float extentX = (box.upperBound.x - box.lowerBound.x) * 0.5f;
+		float extentY = (box.upperBound.y - box.lowerBound.y) * 0.5f;
+		float extentZ = (box.upperBound.z - box.lowerBound.z) * 0.5f;
+
+		FrustumOverlap result = FrustumOverlap::Inside;
+		for (size_t i = 0; i < 6; i++)
+		{
+			const Vector4& p = m_planes[i];
+			const Vector3& n = m_absNormals[i];
+			float distance = p.x * centerX + p.y * centerY + p.z * centerZ + p.w;
+
+			//distance from the center to the corner the furthest along the normal of the plane
+			float radius = n.x * extentX + n.y * extentY + n.z * extentZ;
+			if (distance < -radius)
+			{
+				return FrustumOverlap::Outside;
+			}
+			if (distance < radius)
+			{
+				result = FrustumOverlap::Intersects;
+			}
+		}
+		return result;
+	}
+
+	void Frustum::TransformSphere(const Mat4& transform, const Vector3& center, float radius,
+		Vector3& outCenter, float& outRadius)
+	{
+		Vector4 transformedCenter = transform * Vector4(center.x, center.y, center.z, 1.0f);
+		outCenter = Vector3(transformedCenter.x, transformedCenter.y, transformedCenter.z);
+
+		float scale = Math::Max(Math::Max(Vector3(transform[0].x, transform[0].y, transform[0].z).SqrMagnitude(),
+			Vector3(transform[1].x, transform[1].y, transform[1].z).SqrMagnitude()),
+			Vector3(transform[2].x, transform[2].y, transform[2].z).SqrMagnitude());
+		outRadius = radius * Math::Sqrt(scale);
+	}
+
+	float Frustum::DistanceToPlane(size_t plane, const Vector3& point) const
+	{
+		const Vector4& p = m_planes[plane];
+		return p.x * point.x + p.y * point.y + p.z * point.z + p.w;
+	}
+}
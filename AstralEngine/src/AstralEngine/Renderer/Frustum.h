@@ -0,0 +1,53 @@
+#pragma once
+#include "AstralEngine/Math/AMath.h"
+
+namespace AstralEngine
+{
+	/* the six planes bounding the volume seen through a view projection matrix
+
+	   the planes are extracted from the rows of the matrix (Gribb and Hartmann) so the frustum is
+	   expressed in the space the matrix transforms from, usually world space. The normals of the
+	   planes point towards the inside of the frustum
+	*/
+	enum class FrustumOverlap
+	{
+		Outside,
+		Intersects,
+		Inside
+	};
+
+	class Frustum
+	{
+	public:
+		Frustum();
+		Frustum(const Mat4& viewProj);
+
+		// true if the sphere is at least partially inside the frustum
+		bool Intersects(const Vector3& center, float radius) const;
+
+		// true if the sphere is entirely inside the frustum
+		bool Contains(const Vector3& center, float radius) const;
+
+		// conservative, boxes near the corners of the frustum may intersect it without touching it
+		bool Intersects(const AABB& box) const;
+		bool Contains(const AABB& box) const;
+
+		// both tests above in a single pass over the planes
+		FrustumOverlap Classify(const AABB& box) const;
+
+		/* transforms a bounding sphere, the largest scale of the transform is used
+		   for the radius so the transformed sphere still encloses the transformed geometry
+		*/
+		static void TransformSphere(const Mat4& transform, const Vector3& center, float radius,
+			Vector3& outCenter, float& outRadius);
+
+	private:
+		float DistanceToPlane(size_t plane, const Vector3& point) const;
+
+		// xyz holds the normal of the plane and w its distance to the origin
+		Vector4 m_planes[6];
+
+		//absolute value of the normals, projects the extents of a box on the normals
+		Vector3 m_absNormals[6];
+	};
+}
@@ -35,4 +35,19 @@ namespace AstralEngine
 		AE_CORE_ERROR("Unknown RenderAPI");
 		return nullptr;
 	}
+
+	AReference<IndexBuffer> IndexBuffer::Create(unsigned short* indices, unsigned int count)
+	{
+		switch(RenderAPI::GetAPI())
+		{
+			case RenderAPI::API::None:
+				AE_CORE_ERROR("No RenderAPI is not yet supported");
+
+			case RenderAPI::API::OpenGL:
+				return AReference<OpenGLIndexBuffer>::Create(indices, count);
+		}
+
+		AE_CORE_ERROR("Unknown RenderAPI");
+		return nullptr;
+	}
 }
\ No newline at end of file
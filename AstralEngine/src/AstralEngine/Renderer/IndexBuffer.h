@@ -3,6 +3,13 @@
 
 namespace AstralEngine
 {
+	//size of the indices stored in an IndexBuffer
+	enum class IndexFormat
+	{
+		UnsignedShort,
+		UnsignedInt
+	};
+
 	class IndexBuffer
 	{
 	public:
@@ -14,8 +21,12 @@ namespace AstralEngine
 		virtual void SetData(const unsigned int* data, unsigned int count) = 0;
 
 		virtual int GetCount() const = 0;
+		virtual IndexFormat GetFormat() const = 0;
 
 		static AReference<IndexBuffer> Create();
 		static AReference<IndexBuffer> Create(unsigned int* indices, unsigned int count);
+
+		//16 bit indices, only usable when the vertex buffer has at most 65536 vertices
+		static AReference<IndexBuffer> Create(unsigned short* indices, unsigned int count);
 	};
 }
\ No newline at end of file
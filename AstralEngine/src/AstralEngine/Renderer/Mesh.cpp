@@ -1,18 +1,329 @@
 #include "aepch.h"
 #include "Mesh.h"
+#include "OBJParser.h"
+#include "MeshOptimizer.h"
+#include "Renderer.h"
+
+#include <cstring>
+#include <cstdint>
+#include <filesystem>
+#include <atomic>
+#include <thread>
 
 namespace AstralEngine
 {
+	// .amesh format //////////////////////////////////////////////////
+
+	/*the header is followed by the interleaved VertexData of the mesh, its indices and the indices
+	  of its levels of detail, every block starts at an offset aligned to s_aMeshAlignment bytes 
+	  from the start of the file
+	*/
+	struct AMeshHeader
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint64_t sourceHash;
+
+		std::uint32_t numVertices;
+		std::uint32_t numIndices;
+
+		//number of float components of the position, normal and texture coordinates attributes
+		std::uint32_t vertexStride;
+		std::uint32_t attributeComponents[3];
+
+		float boundsMin[3];
+		float boundsMax[3];
+
+		std::uint64_t vertexOffset;
+		std::uint64_t indexOffset;
+
+		//the indices of the levels of detail refer to the vertices of the mesh
+		std::uint32_t numLODs;
+		std::uint32_t lodNumIndices[Mesh::s_maxNumLODs];
+		std::uint64_t lodIndexOffsets[Mesh::s_maxNumLODs];
+	};
+
+	static constexpr char s_aMeshMagic[4] = { 'A', 'M', 'S', 'H' };
+	static constexpr std::uint32_t s_aMeshVersion = 3;
+	static constexpr std::uint64_t s_aMeshAlignment = 16;
+	static constexpr size_t s_floatsPerVertex = sizeof(VertexData) / sizeof(float);
+
+	static std::uint64_t AlignAMeshOffset(std::uint64_t offset)
+	{
+		return (offset + s_aMeshAlignment - 1) & ~(s_aMeshAlignment - 1);
+	}
+
+	//FNV-1a hash of the content of a source file used to find its cooked version
+	static std::uint64_t HashContent(const char* data, size_t size)
+	{
+		std::uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ (unsigned char)data[i]) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	//pads the file up to offset then writes the block, position is the number of bytes written so far
+	static void WriteAMeshBlock(std::ofstream& file, std::uint64_t& position, std::uint64_t offset, 
+		const void* data, size_t size)
+	{
+		const char padding[s_aMeshAlignment] = { };
+		file.write(padding, offset - position);
+		file.write((const char*)data, size);
+		position = offset + size;
+	}
+
+	//the size is checked separately from the offset so corrupted values cannot overflow the sum
+	static bool IsAMeshBlockInFile(std::uint64_t offset, std::uint64_t size, std::uint64_t fileSize)
+	{
+		return offset <= fileSize && size <= fileSize - offset;
+	}
+
+	static bool ReadWholeFile(const std::string& filepath, std::string& outData)
+	{
+		std::ifstream file(filepath, std::ios::in | std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			return false;
+		}
+
+		size_t size = (size_t)file.tellg();
+		file.seekg(0, std::ios::beg);
+		outData.resize(size);
+		file.read(&outData[0], size);
+		return (bool)file;
+	}
+
+	// Mesh ///////////////////////////////////////////////////////////
+
+	//meshes with at most this many vertices use 16 bit indices on the gpu
+	static constexpr size_t s_maxShortIndexVertices = 65536;
+
 	Mesh::Mesh(const ADynArr<Vector3>& positions, const ADynArr<Vector2>& textureCoords,
 		const ADynArr<Vector3>& normals, const ADynArr<unsigned int>& indices)
-		: m_positions(positions), m_normals(normals), m_indices(indices), m_textureCoords(textureCoords)
-	{ }
+		: m_positions(positions), m_normals(normals), m_indices(indices), m_textureCoords(textureCoords), 
+		m_linkedInstanceBuffer(nullptr), m_boundsRadius(0.0f)
+	{
+		ComputeBounds();
+		BuildClusters();
+	}
 
 	const ADynArr<Vector3>& Mesh::GetPositions() const { return m_positions; }
 	const ADynArr<Vector2>& Mesh::GetTextureCoords() const { return m_textureCoords; }
 	const ADynArr<Vector3>& Mesh::GetNormals() const { return m_normals; }
 	const ADynArr<unsigned int>& Mesh::GetIndices() const { return m_indices; }
 
+	size_t Mesh::GetNumLODs() const { return m_lods.GetCount(); }
+	const Vector3& Mesh::GetBoundsCenter() const { return m_boundsCenter; }
+	float Mesh::GetBoundsRadius() const { return m_boundsRadius; }
+	const AABB& Mesh::GetBounds() const { return m_bounds; }
+
+	const ADynArr<MeshCluster>& Mesh::GetClusters() const { return m_clusters; }
+	const ADynArr<unsigned int>& Mesh::GetClusterVertices() const { return m_clusterVertices; }
+	const ADynArr<unsigned short>& Mesh::GetClusterIndices() const { return m_clusterIndices; }
+
+	MeshHandle Mesh::SelectLOD(float screenSize) const
+	{
+		MeshHandle lod = NullHandle;
+		float threshold = s_firstLODScreenSize;
+		for (MeshHandle handle : m_lods)
+		{
+			if (screenSize >= threshold)
+			{
+				break;
+			}
+			lod = handle;
+			threshold *= 0.5f;
+		}
+		return lod;
+	}
+
+	const AReference<VertexBuffer>& Mesh::GetVertexBuffer() const { return m_vertexBuffer; }
+	const AReference<IndexBuffer>& Mesh::GetIndexBuffer() const { return m_indexBuffer; }
+
+	void Mesh::BindForInstancing(const AReference<VertexBuffer>& instanceBuffer, 
+		const VertexBufferLayout& instanceLayout, size_t layoutOffset) const
+	{
+		AE_RENDER_ASSERT(m_vertexBuffer != nullptr, "Mesh has no gpu buffers");
+		m_vertexBuffer->Bind();
+		m_indexBuffer->Bind();
+
+		if (m_linkedInstanceBuffer != instanceBuffer.Get())
+		{
+			// the layout of an instance array is set on the currently bound vertex array
+			instanceBuffer->Bind();
+			instanceBuffer->SetLayout(instanceLayout, layoutOffset);
+			m_linkedInstanceBuffer = instanceBuffer.Get();
+		}
+	}
+
+	void Mesh::CreateGPUBuffers()
+	{
+		AE_PROFILE_FUNCTION();
+		size_t numVertices = m_positions.GetCount();
+		unsigned int vertexDataSize = (unsigned int)(sizeof(VertexData) * numVertices);
+
+		if (m_cookedVertices.GetCount() == numVertices * s_floatsPerVertex)
+		{
+			//the vertices read from a .amesh file are already interleaved
+			m_vertexBuffer = VertexBuffer::Create(m_cookedVertices.GetData(), vertexDataSize);
+		}
+		else
+		{
+			VertexData* vertexDataArr = new VertexData[numVertices];
+			for (size_t i = 0; i < numVertices; i++)
+			{
+				vertexDataArr[i].position = m_positions[i];
+				vertexDataArr[i].normal = m_normals[i];
+				vertexDataArr[i].textureCoords = m_textureCoords[i];
+			}
+			m_vertexBuffer = VertexBuffer::Create((float*)vertexDataArr, vertexDataSize);
+			delete[] vertexDataArr;
+		}
+		m_cookedVertices = ADynArr<float>(0);
+
+		m_vertexBuffer->Bind();
+		m_vertexBuffer->SetLayout({
+			{ ADataType::Float3, "position" },
+			{ ADataType::Float3, "normal" },
+			{ ADataType::Float2, "textureCoords" }
+			});
+
+		//16 bit indices halve the size of the index buffer when every vertex can be addressed with them
+		unsigned int numIndices = (unsigned int)m_indices.GetCount();
+		unsigned int indexDataSize;
+		if (numVertices <= s_maxShortIndexVertices)
+		{
+			unsigned short* shortIndices = new unsigned short[numIndices];
+			for (unsigned int i = 0; i < numIndices; i++)
+			{
+				shortIndices[i] = (unsigned short)m_indices[i];
+			}
+			m_indexBuffer = IndexBuffer::Create(shortIndices, numIndices);
+			indexDataSize = (unsigned int)(sizeof(unsigned short) * numIndices);
+			delete[] shortIndices;
+		}
+		else
+		{
+			m_indexBuffer = IndexBuffer::Create(m_indices.GetData(), numIndices);
+			indexDataSize = (unsigned int)(sizeof(unsigned int) * numIndices);
+		}
+		m_linkedInstanceBuffer = nullptr;
+
+		Renderer::s_stats.numBytesUploaded += vertexDataSize + indexDataSize;
+	}
+
+	void Mesh::ComputeBounds()
+	{
+		if (m_positions.GetCount() == 0)
+		{
+			m_boundsCenter = Vector3::Zero();
+			m_boundsRadius = 0.0f;
+			m_bounds = AABB();
+			return;
+		}
+
+		Vector3 boundsMin = m_positions[0];
+		Vector3 boundsMax = m_positions[0];
+		for (const Vector3& position : m_positions)
+		{
+			boundsMin = Vector3((std::min)(boundsMin.x, position.x), (std::min)(boundsMin.y, position.y),
+				(std::min)(boundsMin.z, position.z));
+			boundsMax = Vector3((std::max)(boundsMax.x, position.x), (std::max)(boundsMax.y, position.y),
+				(std::max)(boundsMax.z, position.z));
+		}
+
+		m_bounds = AABB(boundsMin, boundsMax);
+		m_boundsCenter = (boundsMin + boundsMax) * 0.5f;
+		float sqrRadius = 0.0f;
+		for (const Vector3& position : m_positions)
+		{
+			sqrRadius = (std::max)(sqrRadius, (position - m_boundsCenter).SqrMagnitude());
+		}
+		m_boundsRadius = Math::Sqrt(sqrRadius);
+	}
+
+	void Mesh::BuildClusters()
+	{
+		if (m_positions.GetCount() <= s_maxClusterVertices && m_indices.GetCount() <= s_maxClusterTriangles * 3)
+		{
+			return;
+		}
+
+		MeshOptimizer::BuildClusters(m_positions, m_indices, s_maxClusterVertices, s_maxClusterTriangles,
+			m_clusters, m_clusterVertices, m_clusterIndices);
+	}
+
+	void Mesh::GenerateLODs()
+	{
+		AE_PROFILE_FUNCTION();
+		m_lodIndices.Clear();
+		size_t targetIndexCount = m_indices.GetCount();
+
+		for (size_t i = 0; i < s_maxNumLODs; i++)
+		{
+			targetIndexCount = (size_t)((float)targetIndexCount * s_lodReduction);
+			targetIndexCount -= targetIndexCount % 3;
+			if (targetIndexCount / 3 < s_minLODTriangles)
+			{
+				break;
+			}
+
+			//every level is simplified from the previous one
+			const ADynArr<unsigned int>& sourceIndices = i == 0 ? m_indices : m_lodIndices[i - 1];
+			ADynArr<unsigned int> lodIndices;
+			MeshOptimizer::Simplify(m_positions, sourceIndices, targetIndexCount, lodIndices);
+
+			//the border of the mesh is never simplified, stop once the simplification barely removes triangles
+			if ((float)lodIndices.GetCount() > (float)sourceIndices.GetCount() * (1.0f + s_lodReduction) * 0.5f)
+			{
+				break;
+			}
+
+			MeshOptimizer::OptimizeVertexCache(lodIndices, m_positions.GetCount());
+			MeshOptimizer::OptimizeOverdraw(m_positions, lodIndices);
+			m_lodIndices.Add(lodIndices);
+		}
+	}
+
+	void Mesh::BuildLODMeshes()
+	{
+		AE_PROFILE_FUNCTION();
+		static constexpr unsigned int s_unassigned = (unsigned int)-1;
+		unsigned int* remap = new unsigned int[m_positions.GetCount()];
+
+		for (const ADynArr<unsigned int>& lodIndices : m_lodIndices)
+		{
+			//only keep the vertices used by the level of detail
+			for (size_t i = 0; i < m_positions.GetCount(); i++)
+			{
+				remap[i] = s_unassigned;
+			}
+
+			ADynArr<Vector3> positions;
+			ADynArr<Vector2> textureCoords;
+			ADynArr<Vector3> normals;
+			ADynArr<unsigned int> indices = ADynArr<unsigned int>(lodIndices.GetCount());
+			for (unsigned int index : lodIndices)
+			{
+				if (remap[index] == s_unassigned)
+				{
+					remap[index] = (unsigned int)positions.GetCount();
+					positions.Add(m_positions[index]);
+					textureCoords.Add(m_textureCoords[index]);
+					normals.Add(m_normals[index]);
+				}
+				indices.Add(remap[index]);
+			}
+
+			m_lodMeshes.Add(AReference<Mesh>::Create(positions, textureCoords, normals, indices));
+		}
+
+		delete[] remap;
+		m_lodIndices = ADynArr<ADynArr<unsigned int>>(0);
+	}
+
 	MeshHandle Mesh::QuadMesh()
 	{
 		static MeshHandle quadMesh = GenerateQuadMesh();
@@ -54,14 +365,32 @@ namespace AstralEngine
 	AReference<Mesh> Mesh::LoadFromFile(const std::string& filepath)
 	{
 		std::string extension = GetFileExtension(filepath);
+		AReference<Mesh> mesh;
 
 		if (extension == "obj")
 		{
-			return LoadFromOBJ(filepath);
+			mesh = LoadFromOBJ(filepath);
+		}
+		else if (extension == "amesh")
+		{
+			mesh = LoadFromAMesh(filepath);
+			if (mesh == nullptr)
+			{
+				AE_CORE_WARN("could not load cooked mesh \"%S\"", filepath);
+			}
+		}
+		else
+		{
+			AE_CORE_ERROR("file format of \"%S\" not supported\n", filepath);
+			return nullptr;
 		}
 
-		AE_CORE_ERROR("file format of \"%S\" not supported\n", filepath);
-		return nullptr;
+		//building the levels of detail computes their bounds and clusters, keep that work on the loading thread
+		if (mesh != nullptr)
+		{
+			mesh->BuildLODMeshes();
+		}
+		return mesh;
 	}
 
 	std::string Mesh::GetFileExtension(const std::string& filepath)
@@ -79,204 +408,264 @@ namespace AstralEngine
 
 	AReference<Mesh> Mesh::LoadFromOBJ(const std::string& filepath)
 	{
-		std::ifstream file(filepath);
-
-		if (!file)
+		std::string data;
+		if (!ReadWholeFile(filepath, data))
 		{
-			AE_CORE_WARN("could not load file \"%s\"", filepath);
+			AE_CORE_WARN("could not load file \"%S\"", filepath);
 			return nullptr;
 		}
 
-		ADynArr<Vector3> positions;
-		ADynArr<Vector2> textureCoords;
-		ADynArr<Vector3> normals;
+		//reuse the cooked version of the file if it was already loaded once
+		std::uint64_t sourceHash = HashContent(data.data(), data.size());
+		std::string cookedFilepath = GetCookedFilepath(sourceHash);
+		AReference<Mesh> cookedMesh = LoadFromAMesh(cookedFilepath, sourceHash);
+		if (cookedMesh != nullptr)
+		{
+			return cookedMesh;
+		}
 
-		ADynArr<unsigned int> posIndices;
-		//index of the face first then the actual value
-		ADynArr<std::pair<unsigned int, unsigned int>> texCoordIndices;
-		ADynArr<std::pair<unsigned int, unsigned int>> normalIndices;
+		OBJParser parser;
+		if (!parser.Parse(data.data(), data.size()))
+		{
+			AE_CORE_WARN("Unexpected format in OBJ file %S", filepath);
+			return nullptr;
+		}
 
-		unsigned int vertexIndex = 0;
+		ADynArr<Vector3> outPositions;
+		ADynArr<Vector2> outTextureCoords;
+		ADynArr<Vector3> outNormals;
+		ADynArr<unsigned int> outIndices;
+		parser.WeldVertices(outPositions, outTextureCoords, outNormals, outIndices);
+
+		VertexCacheStatistics statsBefore = MeshOptimizer::AnalyzeVertexCache(outIndices, outPositions.GetCount());
+		MeshOptimizer::OptimizeVertexCache(outIndices, outPositions.GetCount());
+		MeshOptimizer::OptimizeOverdraw(outPositions, outIndices);
+		MeshOptimizer::OptimizeVertexFetch(outPositions, outTextureCoords, outNormals, outIndices);
+		VertexCacheStatistics statsAfter = MeshOptimizer::AnalyzeVertexCache(outIndices, outPositions.GetCount());
+		AE_CORE_INFO("optimized mesh \"%S\", ACMR %f -> %f, ATVR %f -> %f", filepath, statsBefore.acmr, 
+			statsAfter.acmr, statsBefore.atvr, statsAfter.atvr);
+
+		AReference<Mesh> mesh = AReference<Mesh>::Create(outPositions, outTextureCoords, outNormals, outIndices);
+		mesh->GenerateLODs();
+		mesh->WriteAMesh(cookedFilepath, sourceHash);
+		return mesh;
+	}
 
-		while (true)
+	bool Mesh::Cook(const std::string& filepath, const std::string& cookedFilepath)
+	{
+		AReference<Mesh> mesh = LoadFromFile(filepath);
+		if (mesh == nullptr)
 		{
-			if (file.eof())
-			{
-				break;
-			}
+			return false;
+		}
+		return mesh->WriteAMesh(cookedFilepath, 0);
+	}
 
-			char buffer[200];
-			file.getline(buffer, 200);//read line
+	AReference<Mesh> Mesh::LoadFromAMesh(const std::string& filepath, std::uint64_t sourceHash)
+	{
+		AE_PROFILE_FUNCTION();
+		std::ifstream file(filepath, std::ios::in | std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			return nullptr;
+		}
+		std::uint64_t fileSize = (std::uint64_t)file.tellg();
+		file.seekg(0, std::ios::beg);
+
+		AMeshHeader header;
+		if (!file.read((char*)&header, sizeof(AMeshHeader)) 
+			|| std::memcmp(header.magic, s_aMeshMagic, sizeof(s_aMeshMagic)) != 0
+			|| header.version != s_aMeshVersion 
+			|| header.vertexStride != sizeof(VertexData)
+			|| header.numLODs > s_maxNumLODs
+			|| (sourceHash != 0 && header.sourceHash != sourceHash))
+		{
+			return nullptr;
+		}
 
+		//a stale or corrupted file is cooked again instead of allocating whatever sizes it holds
+		if (!IsAMeshBlockInFile(header.vertexOffset, (std::uint64_t)header.numVertices * sizeof(VertexData), fileSize)
+			|| !IsAMeshBlockInFile(header.indexOffset, (std::uint64_t)header.numIndices * sizeof(unsigned int), fileSize))
+		{
+			return nullptr;
+		}
 
-			if (buffer[0] == 'v' && buffer[1] == ' ') //defining a postion
+		for (size_t i = 0; i < header.numLODs; i++)
+		{
+			if (!IsAMeshBlockInFile(header.lodIndexOffsets[i], 
+				(std::uint64_t)header.lodNumIndices[i] * sizeof(unsigned int), fileSize))
 			{
-				Vector3 position = Vector3(0, 0, 0);
-				int result = sscanf_s(buffer, "v %f %f %f\n", &position.x, &position.y, &position.z);
-
-				if (result != 3)
-				{
-					AE_WARN("Unexpected internal format when reading vertex position in file %s", filepath);
-					return nullptr;
-				}
-				positions.Add(position);
+				return nullptr;
 			}
-			else if (buffer[0] == 'v' && buffer[1] == 't' && buffer[2] == ' ') //defining a texture coordinate
-			{
-				Vector3 texCoord = Vector3(0, 0, 0);
-				int result = sscanf_s(buffer, "vt %f %f\n", &texCoord.x, &texCoord.y);
+		}
 
-				if (result != 2)
-				{
-					result = sscanf_s(buffer, "vt %f %f %f\n", &texCoord.x, &texCoord.y, &texCoord.z);
-					if (result != 3)
-					{
-						AE_WARN("Unexpected internal format when reading vertex texture coordinates"
-							"in file %s", filepath);
-						return nullptr;
-					}
-				}
-				textureCoords.Add(texCoord);
-			}
-			else if (buffer[0] == 'v' && buffer[1] == 'n' && buffer[2] == ' ') //defining a normal
-			{
-				Vector3 normal = Vector3(0, 0, 0);
-				int result = sscanf_s(buffer, "vn %f %f %f\n", &normal.x, &normal.y, &normal.z);
+		//the interleaved vertices are read in a single call and kept as is for the upload
+		size_t numFloats = (size_t)header.numVertices * s_floatsPerVertex;
+		ADynArr<float> vertices;
+		vertices.ResizeUninitialized(numFloats);
 
-				if (result != 3)
-				{
-					AE_WARN("Unexpected internal format when reading vertex normal in file %s", filepath);
-					return nullptr;
-				}
-				normals.Add(normal);
-			}
-			else if (buffer[0] == 'f' && buffer[1] == ' ') //defining a face
-			{
-				int posIndex[3];
-				int textureCoordsIndex[3];
-				int normalIndex[3];
+		ADynArr<unsigned int> indices;
+		indices.ResizeUninitialized(header.numIndices);
 
-				bool hasTexCoords = true;
-				bool hasNormals = true;
+		file.seekg(header.vertexOffset, std::ios::beg);
+		file.read((char*)vertices.GetData(), numFloats * sizeof(float));
+		file.seekg(header.indexOffset, std::ios::beg);
+		file.read((char*)indices.GetData(), header.numIndices * sizeof(unsigned int));
 
-				//try format pos/tex/normal
-				int result = sscanf_s(buffer, "f %d/%d/%d %d/%d/%d %d/%d/%d\n", &posIndex[0], &textureCoordsIndex[0],
-					&normalIndex[0], &posIndex[1], &textureCoordsIndex[1], &normalIndex[1], &posIndex[2],
-					&textureCoordsIndex[2], &normalIndex[2]);
+		ADynArr<ADynArr<unsigned int>> lodIndices = ADynArr<ADynArr<unsigned int>>(header.numLODs);
+		for (size_t i = 0; i < header.numLODs; i++)
+		{
+			ADynArr<unsigned int> currLODIndices;
+			currLODIndices.ResizeUninitialized(header.lodNumIndices[i]);
 
-				if (result != 9)
-				{
-					//try format pos//normal
-					result = sscanf_s(buffer, "f %d//%d %d//%d %d//%d\n", &posIndex[0], &normalIndex[0], &posIndex[1],
-						&normalIndex[1], &posIndex[2], &normalIndex[2]);
-
-					if (result != 6)
-					{
-						//try format pos/tex
-						result = sscanf_s(buffer, "f %d/%d %d/%d %d/%d\n", &posIndex[0], &textureCoordsIndex[0],
-							&posIndex[1], &textureCoordsIndex[1], &posIndex[2], &textureCoordsIndex[2]);
-
-						if (result != 6)
-						{
-							//try format pos//
-							result = sscanf_s(buffer, "f %d// %d// %d//\n", &posIndex[0], &posIndex[1], &posIndex[2]);
-
-							if (result != 3)
-							{
-								AE_WARN("Unknown face format detected in file %s", filepath);
-								return nullptr;
-							}
-
-							hasTexCoords = false;
-						}
-
-						hasNormals = false;
-					}
-					else
-					{
-						hasTexCoords = false;
-					}
-				}
+			file.seekg(header.lodIndexOffsets[i], std::ios::beg);
+			file.read((char*)currLODIndices.GetData(), header.lodNumIndices[i] * sizeof(unsigned int));
+			lodIndices.Add(std::move(currLODIndices));
+		}
 
-				posIndices.Add(posIndex[0] - 1);
-				posIndices.Add(posIndex[1] - 1);
-				posIndices.Add(posIndex[2] - 1);
+		if (!file)
+		{
+			return nullptr;
+		}
 
-				if (hasNormals)
-				{
-					normalIndices.Add(std::make_pair(vertexIndex, (unsigned int)normalIndex[0] - 1U));
-					normalIndices.Add(std::make_pair(vertexIndex + 1, (unsigned int)normalIndex[1] - 1U));
-					normalIndices.Add(std::make_pair(vertexIndex + 2, (unsigned int)normalIndex[2] - 1U));
-				}
+		ADynArr<Vector3> positions = ADynArr<Vector3>(header.numVertices);
+		ADynArr<Vector3> normals = ADynArr<Vector3>(header.numVertices);
+		ADynArr<Vector2> textureCoords = ADynArr<Vector2>(header.numVertices);
+		const VertexData* vertexDataArr = (const VertexData*)vertices.GetData();
+		for (size_t i = 0; i < header.numVertices; i++)
+		{
+			positions.Add(vertexDataArr[i].position);
+			normals.Add(vertexDataArr[i].normal);
+			textureCoords.Add(vertexDataArr[i].textureCoords);
+		}
 
-				if (hasTexCoords)
+		for (unsigned int index : indices)
+		{
+			if (index >= header.numVertices)
+			{
+				return nullptr;
+			}
+		}
+
+		for (const ADynArr<unsigned int>& currLODIndices : lodIndices)
+		{
+			for (unsigned int index : currLODIndices)
+			{
+				if (index >= header.numVertices)
 				{
-					texCoordIndices.Add(std::make_pair(vertexIndex, (unsigned int)textureCoordsIndex[0] - 1U));
-					texCoordIndices.Add(std::make_pair(vertexIndex + 1, (unsigned int)textureCoordsIndex[1] - 1U));
-					texCoordIndices.Add(std::make_pair(vertexIndex + 2, (unsigned int)textureCoordsIndex[2] - 1U));
+					return nullptr;
 				}
-
-				vertexIndex += 3;
 			}
 		}
 
-		ADynArr<Vector3> outPositions;
-		ADynArr<Vector2> outTextureCoords;
-		ADynArr<Vector3> outNormals;
-		ADynArr<unsigned int> outIndices;
+		AReference<Mesh> mesh = AReference<Mesh>::Create(positions, textureCoords, normals, indices);
+		mesh->m_cookedVertices = std::move(vertices);
+		mesh->m_lodIndices = std::move(lodIndices);
+		return mesh;
+	}
 
-		int textureIndex = 0;
-		int normalIndex = 0;
+	bool Mesh::WriteAMesh(const std::string& filepath, std::uint64_t sourceHash) const
+	{
+		AE_PROFILE_FUNCTION();
+		size_t numVertices = m_positions.GetCount();
+
+		AMeshHeader header;
+		std::memcpy(header.magic, s_aMeshMagic, sizeof(s_aMeshMagic));
+		header.version = s_aMeshVersion;
+		header.sourceHash = sourceHash;
+		header.numVertices = (std::uint32_t)numVertices;
+		header.numIndices = (std::uint32_t)m_indices.GetCount();
+		header.vertexStride = sizeof(VertexData);
+		header.attributeComponents[0] = 3;
+		header.attributeComponents[1] = 3;
+		header.attributeComponents[2] = 2;
+
+		Vector3 boundsMin = numVertices == 0 ? Vector3::Zero() : m_positions[0];
+		Vector3 boundsMax = boundsMin;
+		for (const Vector3& position : m_positions)
+		{
+			boundsMin = Vector3((std::min)(boundsMin.x, position.x), (std::min)(boundsMin.y, position.y),
+				(std::min)(boundsMin.z, position.z));
+			boundsMax = Vector3((std::max)(boundsMax.x, position.x), (std::max)(boundsMax.y, position.y),
+				(std::max)(boundsMax.z, position.z));
+		}
+		header.boundsMin[0] = boundsMin.x;
+		header.boundsMin[1] = boundsMin.y;
+		header.boundsMin[2] = boundsMin.z;
+		header.boundsMax[0] = boundsMax.x;
+		header.boundsMax[1] = boundsMax.y;
+		header.boundsMax[2] = boundsMax.z;
+
+		header.vertexOffset = AlignAMeshOffset(sizeof(AMeshHeader));
+		header.indexOffset = AlignAMeshOffset(header.vertexOffset + sizeof(VertexData) * numVertices);
+
+		header.numLODs = (std::uint32_t)m_lodIndices.GetCount();
+		std::uint64_t endOffset = header.indexOffset + sizeof(unsigned int) * m_indices.GetCount();
+		for (size_t i = 0; i < s_maxNumLODs; i++)
+		{
+			header.lodNumIndices[i] = i < header.numLODs ? (std::uint32_t)m_lodIndices[i].GetCount() : 0;
+			header.lodIndexOffsets[i] = AlignAMeshOffset(endOffset);
+			endOffset = header.lodIndexOffsets[i] + sizeof(unsigned int) * header.lodNumIndices[i];
+		}
 
-		int index = 0;
-		for (unsigned int i = 0; i < posIndices.GetCount(); i++)
+		VertexData* vertexDataArr = new VertexData[numVertices];
+		for (size_t i = 0; i < numVertices; i++)
 		{
-			Vector3 texCoords;
-			if (textureCoords.GetCount() != 0 && texCoordIndices[textureIndex].first == i)
-			{
-				texCoords = textureCoords[texCoordIndices[textureIndex].second];
-				textureIndex++;
-			}
+			vertexDataArr[i].position = m_positions[i];
+			vertexDataArr[i].normal = m_normals[i];
+			vertexDataArr[i].textureCoords = m_textureCoords[i];
+		}
 
-			Vector3 normal;
-			if (normals.GetCount() != 0 && normalIndices[normalIndex].first == i)
-			{
-				normal = normals[normalIndices[normalIndex].second];
-				normalIndex++;
-			}
+		/*write to a temporary file first so a file being loaded concurrently is never partially written,
+		  the name is unique as several workers can cook the same source at once
+		*/
+		static std::atomic<std::uint32_t> s_tempFileCounter{ 0 };
+		std::error_code error;
+		std::filesystem::path path = std::filesystem::path(filepath);
+		if (path.has_parent_path())
+		{
+			std::filesystem::create_directories(path.parent_path(), error);
+		}
+		std::string tempFilepath = filepath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()))
+			+ "." + std::to_string(s_tempFileCounter.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
 
-			int currIndex = FindVertexData(outPositions, outTextureCoords, outNormals,
-				positions[posIndices[i]], texCoords, normal);
+		std::ofstream file(tempFilepath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (file)
+		{
+			std::uint64_t position = 0;
+			WriteAMeshBlock(file, position, 0, &header, sizeof(AMeshHeader));
+			WriteAMeshBlock(file, position, header.vertexOffset, vertexDataArr, sizeof(VertexData) * numVertices);
+			WriteAMeshBlock(file, position, header.indexOffset, m_indices.GetData(), 
+				sizeof(unsigned int) * m_indices.GetCount());
 
-			if (currIndex == -1)
+			for (size_t i = 0; i < header.numLODs; i++)
 			{
-				currIndex = index;
-				index++;
-
-				//add a vertex point
-				outPositions.Add(positions[posIndices[i]]);
-				outTextureCoords.Add(texCoords);
-				outNormals.Add(normal);
+				WriteAMeshBlock(file, position, header.lodIndexOffsets[i], m_lodIndices[i].GetData(),
+					sizeof(unsigned int) * m_lodIndices[i].GetCount());
 			}
+		}
+		delete[] vertexDataArr;
 
-			outIndices.Add((unsigned int)currIndex);
+		bool succeeded = (bool)file;
+		file.close();
+		if (succeeded)
+		{
+			std::filesystem::rename(tempFilepath, filepath, error);
+			succeeded = !error;
 		}
 
-		return AReference<Mesh>::Create(outPositions, outTextureCoords, outNormals, outIndices);
+		if (!succeeded)
+		{
+			std::filesystem::remove(tempFilepath, error);
+			AE_CORE_WARN("could not write cooked mesh \"%S\"", filepath);
+		}
+		return succeeded;
 	}
 
-	//helper function which tries to find the VertexData and returns it's index or returns -1 
-	//if it couldn't be found
-	int Mesh::FindVertexData(const ADynArr<Vector3>& outPositions, const ADynArr<Vector2>& outTextureCoords,
-		const ADynArr<Vector3>& outNormals, const Vector3& pos, const Vector2& textureCoords, const Vector3& normal)
+	std::string Mesh::GetCookedFilepath(std::uint64_t sourceHash)
 	{
-		for (unsigned int i = 0; i < outPositions.GetCount(); i++)
-		{
-			if (outPositions[i] == pos && outTextureCoords[i] == textureCoords && outNormals[i] == normal)
-			{
-				return i;
-			}
-		}
-		return -1;
+		char name[17];
+		snprintf(name, sizeof(name), "%016llx", (unsigned long long)sourceHash);
+		return std::string(s_cookedMeshDirectory) + name + ".amesh";
 	}
 }
\ No newline at end of file
@@ -2,13 +2,30 @@
 #include "AstralEngine/Data Struct/ADynArr.h"
 #include "AstralEngine/Math/AMath.h"
 #include "AstralEngine/Core/Resource.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "MeshOptimizer.h"
 
 #include <string>
 #include <fstream>
+#include <cstdint>
 
 namespace AstralEngine
 {
 	/* represents the mesh obtained when loading a model from a file
+
+	   the vertices of the mesh are uploaded once to gpu resident buffers when it is added 
+	   to the ResourceHandler so rendering the mesh does not require sending its geometry again
+
+	   text model files are cooked to the binary .amesh format the first time they are loaded, 
+	   the cooked files are stored in a cache directory keyed on the content of the source file 
+	   so later loads only read the interleaved vertices and indices back
+
+	   simplified levels of detail are generated for loaded models, each level is a separate mesh 
+	   added to the ResourceHandler along with the mesh which owns it
+
+	   meshes which do not fit in a single cluster are partitioned into clusters of neighbouring 
+	   triangles when they are created so the renderer can batch and cull them piece by piece
 	*/
 	class Mesh
 	{
@@ -22,9 +39,60 @@ namespace AstralEngine
 		const ADynArr<Vector3>& GetNormals() const;
 		const ADynArr<unsigned int>& GetIndices() const;
 
+		// interleaved VertexData of the mesh, nullptr until the mesh is added to the ResourceHandler
+		const AReference<VertexBuffer>& GetVertexBuffer() const;
+		const AReference<IndexBuffer>& GetIndexBuffer() const;
+
+		/* binds the buffers of the mesh and links the per instance attributes of the provided 
+		   buffer to them, the attributes are only relinked when a different instance buffer is used
+		*/
+		void BindForInstancing(const AReference<VertexBuffer>& instanceBuffer, 
+			const VertexBufferLayout& instanceLayout, size_t layoutOffset) const;
+
 		static MeshHandle QuadMesh();
 
+		static constexpr size_t s_maxNumLODs = 3;
+
+		size_t GetNumLODs() const;
+
+		/* returns the level of detail to render when the bounding sphere of the mesh covers screenSize 
+		   of the height of the screen, NullHandle when the mesh itself should be rendered
+		*/
+		MeshHandle SelectLOD(float screenSize) const;
+
+		//bounding sphere of the vertices of the mesh in local space
+		const Vector3& GetBoundsCenter() const;
+		float GetBoundsRadius() const;
+
+		//box enclosing the vertices of the mesh in local space
+		const AABB& GetBounds() const;
+
+		static constexpr size_t s_maxClusterVertices = 1024;
+		static constexpr size_t s_maxClusterTriangles = 2048;
+
+		//empty when the whole mesh fits in a single cluster, see MeshCluster for the layout
+		const ADynArr<MeshCluster>& GetClusters() const;
+		const ADynArr<unsigned int>& GetClusterVertices() const;
+		const ADynArr<unsigned short>& GetClusterIndices() const;
+
+		//loads the model file provided and writes it to the .amesh file provided, returns false on failure
+		static bool Cook(const std::string& filepath, const std::string& cookedFilepath);
+
 	private:
+		// must be called from the thread owning the rendering context
+		void CreateGPUBuffers();
+
+		void ComputeBounds();
+		void BuildClusters();
+
+		//simplifies the mesh, can be called from any thread
+		void GenerateLODs();
+
+		/* turns the generated levels of detail into meshes, can be called from any thread. The meshes 
+		   are added to the ResourceHandler along with this mesh once its gpu buffers are created
+		*/
+		void BuildLODMeshes();
+
 		static MeshHandle GenerateQuadMesh();
 
 		//loads a model from a file and creates a Mesh object. returns nullptr if an error occurs
@@ -33,14 +101,53 @@ namespace AstralEngine
 		static std::string GetFileExtension(const std::string& filepath);
 		static AReference<Mesh> LoadFromOBJ(const std::string& filepath);
 
-		//helper function which tries to find the VertexData and returns it's index or returns -1 if it couldn't be found
-		static int FindVertexData(const ADynArr<Vector3>& outPositions, const ADynArr<Vector2>& outTextureCoords,
-			const ADynArr<Vector3>& outNormals, const Vector3& pos, const Vector2& textureCoords, 
-			const Vector3& normal);
+		/* returns nullptr if the file does not exist or is not a valid .amesh file, when a source hash 
+		   is provided the file is also rejected if it was cooked from a different source
+		*/
+		static AReference<Mesh> LoadFromAMesh(const std::string& filepath, std::uint64_t sourceHash = 0);
+		bool WriteAMesh(const std::string& filepath, std::uint64_t sourceHash) const;
+		static std::string GetCookedFilepath(std::uint64_t sourceHash);
+
+		static constexpr const char* s_cookedMeshDirectory = "assets/cache/meshes/";
+
+		//every level of detail has at most s_lodReduction times the triangles of the previous one
+		static constexpr float s_lodReduction = 0.5f;
+
+		//the first level of detail is used below this screen size, the next ones below half the previous size
+		static constexpr float s_firstLODScreenSize = 0.5f;
+
+		//meshes are not simplified below this number of triangles
+		static constexpr size_t s_minLODTriangles = 256;
 
 		ADynArr<Vector3> m_positions;
 		ADynArr<Vector2> m_textureCoords;
 		ADynArr<Vector3> m_normals;
 		ADynArr<unsigned int> m_indices;
+
+		//interleaved VertexData read from a .amesh file, uploaded as is then released
+		ADynArr<float> m_cookedVertices;
+
+		//indices of the levels of detail, refer to the vertices of this mesh until they are turned into meshes
+		ADynArr<ADynArr<unsigned int>> m_lodIndices;
+
+		//levels of detail built by BuildLODMeshes which were not added to the ResourceHandler yet
+		ADynArr<AReference<Mesh>> m_lodMeshes;
+		ADynArr<MeshHandle> m_lods;
+
+		Vector3 m_boundsCenter;
+		float m_boundsRadius;
+		AABB m_bounds;
+
+		ADynArr<MeshCluster> m_clusters;
+		ADynArr<unsigned int> m_clusterVertices;
+		ADynArr<unsigned short> m_clusterIndices;
+
+		AReference<VertexBuffer> m_vertexBuffer;
+		AReference<IndexBuffer> m_indexBuffer;
+		mutable const VertexBuffer* m_linkedInstanceBuffer;
 	};
+
+	//meshes are created by the loading jobs and handed over to the main thread
+	template<>
+	struct AAtomicRefCount<Mesh> : std::true_type { };
 }
\ No newline at end of file
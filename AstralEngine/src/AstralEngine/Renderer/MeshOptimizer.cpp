@@ -0,0 +1,1004 @@
+#include "aepch.h"
+#include "MeshOptimizer.h"
+
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <cfloat>
+
+namespace AstralEngine
+{
+	// scoring constants from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+	static constexpr float s_cacheDecayPower = 1.5f;
+	static constexpr float s_lastTriangleScore = 0.75f;
+	static constexpr float s_valenceBoostScale = 2.0f;
+	static constexpr float s_valenceBoostPower = 0.5f;
+
+	// Quadric ////////////////////////////////////////////////////////
+
+	//symmetric 4x4 matrix measuring the sum of squared distances to a set of planes
+	struct Quadric
+	{
+		double a2, ab, ac, ad;
+		double b2, bc, bd;
+		double c2, cd;
+		double d2;
+	};
+
+	static void AddPlaneToQuadric(Quadric& q, double a, double b, double c, double d, double weight)
+	{
+		q.a2 += a * a * weight;
+		q.ab += a * b * weight;
+		q.ac += a * c * weight;
+		q.ad += a * d * weight;
+		q.b2 += b * b * weight;
+		q.bc += b * c * weight;
+		q.bd += b * d * weight;
+		q.c2 += c * c * weight;
+		q.cd += c * d * weight;
+		q.d2 += d * d * weight;
+	}
+
+	static Quadric SumQuadrics(const Quadric& q1, const Quadric& q2)
+	{
+		return { q1.a2 + q2.a2, q1.ab + q2.ab, q1.ac + q2.ac, q1.ad + q2.ad, q1.b2 + q2.b2, 
+			q1.bc + q2.bc, q1.bd + q2.bd, q1.c2 + q2.c2, q1.cd + q2.cd, q1.d2 + q2.d2 };
+	}
+
+	static double EvaluateQuadric(const Quadric& q, const Vector3& p)
+	{
+		double x = p.x;
+		double y = p.y;
+		double z = p.z;
+		return q.a2 * x * x + 2.0 * q.ab * x * y + 2.0 * q.ac * x * z + 2.0 * q.ad * x
+			+ q.b2 * y * y + 2.0 * q.bc * y * z + 2.0 * q.bd * y
+			+ q.c2 * z * z + 2.0 * q.cd * z + q.d2;
+	}
+
+	// Cache simulation ///////////////////////////////////////////////
+
+	/*transforms the vertices of the triangle missing from a FIFO cache of cacheSize vertices and returns 
+	  their number, a vertex is in the cache if less than cacheSize vertices were transformed since it was
+	  itself transformed. Increasing time by cacheSize + 1 empties the cache
+	*/
+	static unsigned int SimulateVertexCache(const unsigned int* triangle, size_t* transformTimes, size_t& time,
+		size_t cacheSize)
+	{
+		unsigned int numMisses = 0;
+		for (int i = 0; i < 3; i++)
+		{
+			unsigned int vertex = triangle[i];
+			if (time - transformTimes[vertex] > cacheSize)
+			{
+				transformTimes[vertex] = time++;
+				numMisses++;
+			}
+		}
+		return numMisses;
+	}
+
+	// MeshOptimizer //////////////////////////////////////////////////
+
+	void MeshOptimizer::OptimizeVertexCache(ADynArr<unsigned int>& indices, size_t numVertices)
+	{
+		AE_PROFILE_FUNCTION();
+		size_t numIndices = indices.GetCount();
+		size_t numTriangles = numIndices / 3;
+		if (numTriangles == 0)
+		{
+			return;
+		}
+
+		//triangles using every vertex stored contiguously, the first numActiveTriangles[v]
+		//entries of a vertex are the triangles which were not emitted yet
+		unsigned int* numActiveTriangles = new unsigned int[numVertices]();
+		for (size_t i = 0; i < numIndices; i++)
+		{
+			numActiveTriangles[indices[i]]++;
+		}
+
+		unsigned int* adjacencyOffsets = new unsigned int[numVertices + 1];
+		adjacencyOffsets[0] = 0;
+		for (size_t i = 0; i < numVertices; i++)
+		{
+			adjacencyOffsets[i + 1] = adjacencyOffsets[i] + numActiveTriangles[i];
+		}
+
+		unsigned int* adjacency = new unsigned int[numIndices];
+		unsigned int* writePositions = new unsigned int[numVertices];
+		for (size_t i = 0; i < numVertices; i++)
+		{
+			writePositions[i] = adjacencyOffsets[i];
+		}
+
+		for (size_t i = 0; i < numIndices; i++)
+		{
+			adjacency[writePositions[indices[i]]++] = (unsigned int)(i / 3);
+		}
+		delete[] writePositions;
+
+		int* cachePositions = new int[numVertices];
+		float* vertexScores = new float[numVertices];
+		for (size_t i = 0; i < numVertices; i++)
+		{
+			cachePositions[i] = -1;
+			vertexScores[i] = ComputeVertexScore(-1, numActiveTriangles[i]);
+		}
+
+		float* triangleScores = new float[numTriangles];
+		bool* isEmitted = new bool[numTriangles]();
+		int bestTriangle = 0;
+		for (size_t i = 0; i < numTriangles; i++)
+		{
+			triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]]
+				+ vertexScores[indices[i * 3 + 2]];
+
+			if (triangleScores[i] > triangleScores[bestTriangle])
+			{
+				bestTriangle = (int)i;
+			}
+		}
+
+		//the cache can temporarily hold the three vertices of the emitted triangle on top of its size
+		unsigned int cache[s_optimizedCacheSize + 3];
+		size_t cacheCount = 0;
+
+		ADynArr<unsigned int> output = ADynArr<unsigned int>(numIndices);
+		size_t nextUnemitted = 0;
+
+		for (size_t emitted = 0; emitted < numTriangles; emitted++)
+		{
+			//no triangle uses a vertex of the cache, continue with the next triangle in the original order
+			if (bestTriangle == -1)
+			{
+				while (isEmitted[nextUnemitted])
+				{
+					nextUnemitted++;
+				}
+				bestTriangle = (int)nextUnemitted;
+			}
+
+			isEmitted[bestTriangle] = true;
+			unsigned int triangle[3] = { indices[bestTriangle * 3], indices[bestTriangle * 3 + 1],
+				indices[bestTriangle * 3 + 2] };
+
+			unsigned int newCache[s_optimizedCacheSize + 3];
+			size_t newCacheCount = 0;
+
+			for (unsigned int vertex : triangle)
+			{
+				output.Add(vertex);
+
+				//remove the triangle from the active triangles of the vertex
+				unsigned int* begin = adjacency + adjacencyOffsets[vertex];
+				unsigned int* last = begin + numActiveTriangles[vertex] - 1;
+				for (unsigned int* it = begin; it <= last; it++)
+				{
+					if (*it == (unsigned int)bestTriangle)
+					{
+						std::swap(*it, *last);
+						numActiveTriangles[vertex]--;
+						break;
+					}
+				}
+
+				//degenerate triangles can use the same vertex more than once
+				bool isInCache = false;
+				for (size_t i = 0; i < newCacheCount; i++)
+				{
+					isInCache |= newCache[i] == vertex;
+				}
+
+				if (!isInCache)
+				{
+					newCache[newCacheCount++] = vertex;
+				}
+			}
+
+			//the vertices of the triangle move to the front of the cache
+			for (size_t i = 0; i < cacheCount; i++)
+			{
+				unsigned int vertex = cache[i];
+				if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+				{
+					newCache[newCacheCount++] = vertex;
+				}
+			}
+
+			//update the scores of every vertex whose position changed, including the evicted ones
+			for (size_t i = 0; i < newCacheCount; i++)
+			{
+				unsigned int vertex = newCache[i];
+				cachePositions[vertex] = i < s_optimizedCacheSize ? (int)i : -1;
+
+				float score = ComputeVertexScore(cachePositions[vertex], numActiveTriangles[vertex]);
+				float scoreDelta = score - vertexScores[vertex];
+				vertexScores[vertex] = score;
+
+				unsigned int* begin = adjacency + adjacencyOffsets[vertex];
+				for (unsigned int j = 0; j < numActiveTriangles[vertex]; j++)
+				{
+					triangleScores[begin[j]] += scoreDelta;
+				}
+			}
+
+			cacheCount = (std::min)(newCacheCount, s_optimizedCacheSize);
+			for (size_t i = 0; i < cacheCount; i++)
+			{
+				cache[i] = newCache[i];
+			}
+
+			//only the triangles using a vertex of the cache had their score improved
+			bestTriangle = -1;
+			float bestScore = 0.0f;
+			for (size_t i = 0; i < cacheCount; i++)
+			{
+				unsigned int vertex = cache[i];
+				unsigned int* begin = adjacency + adjacencyOffsets[vertex];
+				for (unsigned int j = 0; j < numActiveTriangles[vertex]; j++)
+				{
+					if (bestTriangle == -1 || triangleScores[begin[j]] > bestScore)
+					{
+						bestTriangle = (int)begin[j];
+						bestScore = triangleScores[begin[j]];
+					}
+				}
+			}
+		}
+
+		//keep the indices which do not form a full triangle
+		for (size_t i = numTriangles * 3; i < numIndices; i++)
+		{
+			output.Add(indices[i]);
+		}
+		indices = std::move(output);
+
+		delete[] numActiveTriangles;
+		delete[] adjacencyOffsets;
+		delete[] adjacency;
+		delete[] cachePositions;
+		delete[] vertexScores;
+		delete[] triangleScores;
+		delete[] isEmitted;
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(const ADynArr<Vector3>& positions, ADynArr<unsigned int>& indices,
+		float threshold)
+	{
+		AE_PROFILE_FUNCTION();
+		size_t numTriangles = indices.GetCount() / 3;
+		size_t numVertices = positions.GetCount();
+		if (numTriangles == 0 || numVertices == 0)
+		{
+			return;
+		}
+
+		size_t* transformTimes = new size_t[numVertices]();
+		size_t time = s_optimizedCacheSize + 1;
+
+		//the triangles whose three vertices miss the cache start a cluster, moving them does not change the misses
+		ADynArr<size_t> hardBoundaries;
+		for (size_t i = 0; i < numTriangles; i++)
+		{
+			if (SimulateVertexCache(indices.GetData() + i * 3, transformTimes, time, s_optimizedCacheSize) == 3 || i == 0)
+			{
+				hardBoundaries.Add(i);
+			}
+		}
+		hardBoundaries.Add(numTriangles);
+
+		/*the clusters are split further once the miss ratio of their triangles processed so far gets within 
+		  threshold of the one of the whole cluster, the cache is emptied at every split since the clusters 
+		  are reordered afterward
+		*/
+		ADynArr<size_t> clusterStarts;
+		for (size_t c = 0; c + 1 < hardBoundaries.GetCount(); c++)
+		{
+			size_t start = hardBoundaries[c];
+			size_t end = hardBoundaries[c + 1];
+
+			time += s_optimizedCacheSize + 1;
+			size_t clusterMisses = 0;
+			for (size_t i = start; i < end; i++)
+			{
+				clusterMisses += SimulateVertexCache(indices.GetData() + i * 3, transformTimes, time, s_optimizedCacheSize);
+			}
+			float clusterThreshold = threshold * (float)clusterMisses / (float)(end - start);
+
+			clusterStarts.Add(start);
+			time += s_optimizedCacheSize + 1;
+			size_t runningMisses = 0;
+			size_t runningTriangles = 0;
+			for (size_t i = start; i < end; i++)
+			{
+				runningMisses += SimulateVertexCache(indices.GetData() + i * 3, transformTimes, time, s_optimizedCacheSize);
+				runningTriangles++;
+
+				if (i + 1 < end && (float)runningMisses / (float)runningTriangles <= clusterThreshold)
+				{
+					clusterStarts.Add(i + 1);
+					time += s_optimizedCacheSize + 1;
+					runningMisses = 0;
+					runningTriangles = 0;
+				}
+			}
+		}
+		clusterStarts.Add(numTriangles);
+		delete[] transformTimes;
+
+		Vector3 meshCenter = Vector3::Zero();
+		for (const Vector3& position : positions)
+		{
+			meshCenter += position;
+		}
+		meshCenter = meshCenter / (float)numVertices;
+
+		//clusters are sorted by how much they face away from the center of the mesh, measured at their area weighted centroid
+		struct ClusterSortKey
+		{
+			float key;
+			size_t cluster;
+		};
+
+		size_t numClusters = clusterStarts.GetCount() - 1;
+		ADynArr<ClusterSortKey> sortKeys(numClusters);
+		for (size_t c = 0; c < numClusters; c++)
+		{
+			Vector3 centroid = Vector3::Zero();
+			Vector3 normal = Vector3::Zero();
+			float area = 0.0f;
+			for (size_t i = clusterStarts[c]; i < clusterStarts[c + 1]; i++)
+			{
+				const Vector3& p0 = positions[indices[i * 3]];
+				const Vector3& p1 = positions[indices[i * 3 + 1]];
+				const Vector3& p2 = positions[indices[i * 3 + 2]];
+
+				//the length of the cross product is twice the area of the triangle
+				Vector3 triangleNormal = Vector3::CrossProduct(p1 - p0, p2 - p0);
+				float triangleArea = triangleNormal.Magnitude();
+				centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+				normal += triangleNormal;
+				area += triangleArea;
+			}
+
+			float key = 0.0f;
+			if (area > 0.0f && normal.SqrMagnitude() > 0.0f)
+			{
+				key = Vector3::DotProduct(centroid / area - meshCenter, Vector3::Normalize(normal));
+			}
+			sortKeys.Add({ key, c });
+		}
+
+		std::stable_sort(sortKeys.GetData(), sortKeys.GetData() + sortKeys.GetCount(), 
+			[](const ClusterSortKey& a, const ClusterSortKey& b) { return a.key > b.key; });
+
+		ADynArr<unsigned int> output = ADynArr<unsigned int>(indices.GetCount());
+		for (const ClusterSortKey& sortKey : sortKeys)
+		{
+			for (size_t i = clusterStarts[sortKey.cluster] * 3; i < clusterStarts[sortKey.cluster + 1] * 3; i++)
+			{
+				output.Add(indices[i]);
+			}
+		}
+
+		//keep the indices which do not form a full triangle
+		for (size_t i = numTriangles * 3; i < indices.GetCount(); i++)
+		{
+			output.Add(indices[i]);
+		}
+		indices = std::move(output);
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(ADynArr<Vector3>& positions, ADynArr<Vector2>& textureCoords,
+		ADynArr<Vector3>& normals, ADynArr<unsigned int>& indices)
+	{
+		AE_PROFILE_FUNCTION();
+		size_t numVertices = positions.GetCount();
+		static constexpr unsigned int s_unassigned = (unsigned int)-1;
+
+		unsigned int* remap = new unsigned int[numVertices];
+		for (size_t i = 0; i < numVertices; i++)
+		{
+			remap[i] = s_unassigned;
+		}
+
+		unsigned int nextVertex = 0;
+		for (unsigned int& index : indices)
+		{
+			if (remap[index] == s_unassigned)
+			{
+				remap[index] = nextVertex++;
+			}
+			index = remap[index];
+		}
+
+		for (size_t i = 0; i < numVertices; i++)
+		{
+			if (remap[i] == s_unassigned)
+			{
+				remap[i] = nextVertex++;
+			}
+		}
+
+		ADynArr<Vector3> newPositions;
+		ADynArr<Vector2> newTextureCoords;
+		ADynArr<Vector3> newNormals;
+		newPositions.Resize(numVertices, Vector3::Zero());
+		newTextureCoords.Resize(numVertices, Vector2::Zero());
+		newNormals.Resize(numVertices, Vector3::Zero());
+
+		for (size_t i = 0; i < numVertices; i++)
+		{
+			newPositions[remap[i]] = positions[i];
+			newTextureCoords[remap[i]] = textureCoords[i];
+			newNormals[remap[i]] = normals[i];
+		}
+		delete[] remap;
+
+		positions = std::move(newPositions);
+		textureCoords = std::move(newTextureCoords);
+		normals = std::move(newNormals);
+	}
+
+	void MeshOptimizer::Simplify(const ADynArr<Vector3>& positions, const ADynArr<unsigned int>& indices,
+		size_t targetIndexCount, ADynArr<unsigned int>& outIndices)
+	{
+		AE_PROFILE_FUNCTION();
+		struct Collapse
+		{
+			unsigned int from;
+			unsigned int to;
+			double cost;
+		};
+
+		size_t numVertices = positions.GetCount();
+		size_t numIndices = indices.GetCount() - indices.GetCount() % 3;
+		outIndices.Clear();
+		outIndices.Reserve(numIndices);
+		for (size_t i = 0; i < numIndices; i++)
+		{
+			outIndices.Add(indices[i]);
+		}
+
+		if (numIndices <= targetIndexCount || numVertices == 0)
+		{
+			return;
+		}
+
+		//every vertex starts with the quadric of the planes of its triangles weighted by their area
+		Quadric* quadrics = new Quadric[numVertices]();
+		for (size_t i = 0; i < numIndices; i += 3)
+		{
+			const Vector3& p0 = positions[indices[i]];
+			const Vector3& p1 = positions[indices[i + 1]];
+			const Vector3& p2 = positions[indices[i + 2]];
+			Vector3 normal = Vector3::CrossProduct(p1 - p0, p2 - p0);
+			double length = normal.Magnitude();
+			if (length == 0.0)
+			{
+				continue;
+			}
+
+			double a = normal.x / length;
+			double b = normal.y / length;
+			double c = normal.z / length;
+			double d = -(a * p0.x + b * p0.y + c * p0.z);
+			for (size_t j = 0; j < 3; j++)
+			{
+				AddPlaneToQuadric(quadrics[indices[i + j]], a, b, c, d, length * 0.5);
+			}
+		}
+
+		//an edge used by a single triangle is on the border of the mesh, its vertices are locked
+		bool* isLocked = new bool[numVertices]();
+		std::uint64_t* edges = new std::uint64_t[numIndices];
+		for (size_t i = 0; i < numIndices; i++)
+		{
+			std::uint64_t v0 = indices[i];
+			std::uint64_t v1 = indices[i - i % 3 + (i + 1) % 3];
+			edges[i] = (std::min)(v0, v1) << 32 | (std::max)(v0, v1);
+		}
+		std::sort(edges, edges + numIndices);
+
+		for (size_t i = 0; i < numIndices;)
+		{
+			size_t runEnd = i + 1;
+			while (runEnd < numIndices && edges[runEnd] == edges[i])
+			{
+				runEnd++;
+			}
+
+			if (runEnd - i == 1)
+			{
+				isLocked[edges[i] >> 32] = true;
+				isLocked[edges[i] & 0xFFFFFFFF] = true;
+			}
+			i = runEnd;
+		}
+		delete[] edges;
+
+		unsigned int* adjacencyOffsets = new unsigned int[numVertices + 1];
+		unsigned int* adjacency = new unsigned int[numIndices];
+		unsigned int* remap = new unsigned int[numVertices];
+		bool* isTouched = new bool[numVertices];
+		Collapse* collapses = new Collapse[numIndices];
+
+		while (outIndices.GetCount() > targetIndexCount)
+		{
+			size_t currNumIndices = outIndices.GetCount();
+
+			//triangles using every vertex
+			for (size_t i = 0; i <= numVertices; i++)
+			{
+				adjacencyOffsets[i] = 0;
+			}
+
+			for (unsigned int index : outIndices)
+			{
+				adjacencyOffsets[index + 1]++;
+			}
+
+			for (size_t i = 0; i < numVertices; i++)
+			{
+				adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+			}
+
+			for (size_t i = 0; i < currNumIndices; i++)
+			{
+				adjacency[adjacencyOffsets[outIndices[i]]++] = (unsigned int)(i / 3);
+			}
+
+			//filling moved every offset to the start of the next vertex
+			for (size_t i = numVertices; i > 0; i--)
+			{
+				adjacencyOffsets[i] = adjacencyOffsets[i - 1];
+			}
+			adjacencyOffsets[0] = 0;
+
+			//for every edge keep the cheapest direction of the collapse
+			size_t numCollapses = 0;
+			for (size_t i = 0; i < currNumIndices; i++)
+			{
+				unsigned int v0 = outIndices[i];
+				unsigned int v1 = outIndices[i - i % 3 + (i + 1) % 3];
+				if (v0 == v1 || (isLocked[v0] && isLocked[v1]))
+				{
+					continue;
+				}
+
+				Quadric q = SumQuadrics(quadrics[v0], quadrics[v1]);
+				double costToV1 = isLocked[v0] ? DBL_MAX : EvaluateQuadric(q, positions[v1]);
+				double costToV0 = isLocked[v1] ? DBL_MAX : EvaluateQuadric(q, positions[v0]);
+
+				Collapse& collapse = collapses[numCollapses++];
+				collapse.from = costToV1 <= costToV0 ? v0 : v1;
+				collapse.to = costToV1 <= costToV0 ? v1 : v0;
+				collapse.cost = (std::min)(costToV1, costToV0);
+			}
+
+			std::sort(collapses, collapses + numCollapses, 
+				[](const Collapse& c1, const Collapse& c2) { return c1.cost < c2.cost; });
+
+			for (size_t i = 0; i < numVertices; i++)
+			{
+				remap[i] = (unsigned int)i;
+				isTouched[i] = false;
+			}
+
+			//a collapse removes two triangles unless the edge is on a seam
+			size_t numTrianglesToRemove = (currNumIndices - targetIndexCount + 2) / 3;
+			size_t numTrianglesRemoved = 0;
+			for (size_t i = 0; i < numCollapses && numTrianglesRemoved < numTrianglesToRemove; i++)
+			{
+				const Collapse& collapse = collapses[i];
+				if (isTouched[collapse.from] || isTouched[collapse.to] 
+					|| CollapseFlipsTriangle(positions, outIndices, adjacencyOffsets, adjacency, collapse.from, collapse.to))
+				{
+					continue;
+				}
+
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to] = SumQuadrics(quadrics[collapse.to], quadrics[collapse.from]);
+
+				//the triangles around the collapsed vertex change so their vertices wait for the next pass
+				for (unsigned int j = adjacencyOffsets[collapse.from]; j < adjacencyOffsets[collapse.from + 1]; j++)
+				{
+					size_t triangle = adjacency[j];
+					isTouched[outIndices[triangle * 3]] = true;
+					isTouched[outIndices[triangle * 3 + 1]] = true;
+					isTouched[outIndices[triangle * 3 + 2]] = true;
+				}
+				numTrianglesRemoved += 2;
+			}
+
+			if (numTrianglesRemoved == 0)
+			{
+				break;
+			}
+
+			//remap the indices and remove the triangles which became degenerate
+			size_t writeIndex = 0;
+			for (size_t i = 0; i < currNumIndices; i += 3)
+			{
+				unsigned int v0 = remap[outIndices[i]];
+				unsigned int v1 = remap[outIndices[i + 1]];
+				unsigned int v2 = remap[outIndices[i + 2]];
+				if (v0 != v1 && v1 != v2 && v2 != v0)
+				{
+					outIndices[writeIndex++] = v0;
+					outIndices[writeIndex++] = v1;
+					outIndices[writeIndex++] = v2;
+				}
+			}
+
+			while (outIndices.GetCount() > writeIndex)
+			{
+				outIndices.RemoveAt(outIndices.GetCount() - 1);
+			}
+		}
+
+		delete[] quadrics;
+		delete[] isLocked;
+		delete[] adjacencyOffsets;
+		delete[] adjacency;
+		delete[] remap;
+		delete[] isTouched;
+		delete[] collapses;
+	}
+
+	void MeshOptimizer::BuildClusters(const ADynArr<Vector3>& positions, const ADynArr<unsigned int>& indices,
+		size_t maxVertices, size_t maxTriangles, ADynArr<MeshCluster>& outClusters,
+		ADynArr<unsigned int>& outClusterVertices, ADynArr<unsigned short>& outClusterIndices)
+	{
+		AE_PROFILE_FUNCTION();
+		AE_CORE_ASSERT(maxVertices >= 3 && maxVertices <= 65536 && maxTriangles > 0, "invalid cluster size");
+		outClusters.Clear();
+		outClusterVertices.Clear();
+		outClusterIndices.Clear();
+
+		size_t numVertices = positions.GetCount();
+		size_t numTriangles = indices.GetCount() / 3;
+		size_t numIndices = numTriangles * 3;
+		if (numTriangles == 0)
+		{
+			return;
+		}
+		static constexpr unsigned int s_unassigned = (unsigned int)-1;
+
+		//triangles using every vertex stored contiguously
+		unsigned int* adjacencyOffsets = new unsigned int[numVertices + 1]();
+		for (size_t i = 0; i < numIndices; i++)
+		{
+			adjacencyOffsets[indices[i] + 1]++;
+		}
+
+		for (size_t i = 0; i < numVertices; i++)
+		{
+			adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+		}
+
+		unsigned int* adjacency = new unsigned int[numIndices];
+		unsigned int* writePositions = new unsigned int[numVertices];
+		for (size_t i = 0; i < numVertices; i++)
+		{
+			writePositions[i] = adjacencyOffsets[i];
+		}
+
+		for (size_t i = 0; i < numIndices; i++)
+		{
+			adjacency[writePositions[indices[i]]++] = (unsigned int)(i / 3);
+		}
+		delete[] writePositions;
+
+		//index of the vertices of the mesh in the cluster being built
+		unsigned int* localIndices = new unsigned int[numVertices];
+		for (size_t i = 0; i < numVertices; i++)
+		{
+			localIndices[i] = s_unassigned;
+		}
+
+		bool* isAssigned = new bool[numTriangles]();
+		size_t numAssigned = 0;
+		size_t nextSeed = 0;
+
+		//triangle which did not fit in the previous cluster, it neighbours it so it makes a good seed
+		size_t pendingSeed = numTriangles;
+		outClusterIndices.Reserve(numIndices);
+
+		while (numAssigned < numTriangles)
+		{
+			MeshCluster cluster;
+			cluster.firstVertex = (unsigned int)outClusterVertices.GetCount();
+			cluster.numVertices = 0;
+			cluster.firstIndex = (unsigned int)outClusterIndices.GetCount();
+			cluster.numIndices = 0;
+
+			//the vertices of the cluster are visited in the order they were added so it grows in rings
+			size_t nextVertexToVisit = cluster.firstVertex;
+			while (true)
+			{
+				size_t triangle = numTriangles;
+				while (triangle == numTriangles && nextVertexToVisit < outClusterVertices.GetCount())
+				{
+					unsigned int vertex = outClusterVertices[nextVertexToVisit];
+					for (unsigned int i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex + 1]; i++)
+					{
+						if (!isAssigned[adjacency[i]])
+						{
+							triangle = adjacency[i];
+							break;
+						}
+					}
+
+					if (triangle == numTriangles)
+					{
+						nextVertexToVisit++;
+					}
+				}
+
+				//no triangle left around the cluster, continue with the next triangle in index order
+				if (triangle == numTriangles)
+				{
+					if (pendingSeed != numTriangles && !isAssigned[pendingSeed])
+					{
+						triangle = pendingSeed;
+					}
+					else
+					{
+						while (nextSeed < numTriangles && isAssigned[nextSeed])
+						{
+							nextSeed++;
+						}
+
+						if (nextSeed == numTriangles)
+						{
+							break;
+						}
+						triangle = nextSeed;
+					}
+				}
+
+				size_t numNewVertices = 0;
+				for (size_t i = 0; i < 3; i++)
+				{
+					numNewVertices += localIndices[indices[triangle * 3 + i]] == s_unassigned ? 1 : 0;
+				}
+
+				if (cluster.numVertices + numNewVertices > maxVertices || cluster.numIndices / 3 >= maxTriangles)
+				{
+					pendingSeed = triangle;
+					break;
+				}
+
+				for (size_t i = 0; i < 3; i++)
+				{
+					unsigned int vertex = indices[triangle * 3 + i];
+					if (localIndices[vertex] == s_unassigned)
+					{
+						localIndices[vertex] = cluster.numVertices++;
+						outClusterVertices.Add(vertex);
+					}
+					outClusterIndices.Add((unsigned short)localIndices[vertex]);
+				}
+				cluster.numIndices += 3;
+				isAssigned[triangle] = true;
+				numAssigned++;
+			}
+
+			for (size_t i = cluster.firstVertex; i < outClusterVertices.GetCount(); i++)
+			{
+				localIndices[outClusterVertices[i]] = s_unassigned;
+			}
+
+			ComputeClusterBounds(positions, outClusterVertices, cluster);
+			outClusters.Add(cluster);
+		}
+
+		delete[] adjacencyOffsets;
+		delete[] adjacency;
+		delete[] localIndices;
+		delete[] isAssigned;
+
+#ifdef AE_DEBUG
+		ValidateClusters(positions, indices, maxVertices, maxTriangles, outClusters, outClusterVertices, outClusterIndices);
+#endif
+	}
+
+	VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const ADynArr<unsigned int>& indices,
+		size_t numVertices, size_t cacheSize)
+	{
+		VertexCacheStatistics stats = { 0.0f, 0.0f };
+		size_t numTriangles = indices.GetCount() / 3;
+		if (numTriangles == 0 || numVertices == 0)
+		{
+			return stats;
+		}
+
+		/*FIFO cache, a vertex is in the cache if less than cacheSize vertices were
+		  transformed since it was itself transformed
+		*/
+		size_t* transformTimes = new size_t[numVertices];
+		bool* isReferenced = new bool[numVertices]();
+		for (size_t i = 0; i < numVertices; i++)
+		{
+			transformTimes[i] = 0;
+		}
+
+		size_t numTransformed = 0;
+		size_t numReferenced = 0;
+		for (size_t i = 0; i < numTriangles * 3; i++)
+		{
+			unsigned int vertex = indices[i];
+			if (!isReferenced[vertex] || numTransformed - transformTimes[vertex] >= cacheSize)
+			{
+				numReferenced += isReferenced[vertex] ? 0 : 1;
+				isReferenced[vertex] = true;
+				transformTimes[vertex] = numTransformed;
+				numTransformed++;
+			}
+		}
+
+		delete[] transformTimes;
+		delete[] isReferenced;
+
+		stats.acmr = (float)numTransformed / (float)numTriangles;
+		stats.atvr = (float)numTransformed / (float)numReferenced;
+		return stats;
+	}
+
+	bool MeshOptimizer::CollapseFlipsTriangle(const ADynArr<Vector3>& positions, const ADynArr<unsigned int>& indices,
+		const unsigned int* adjacencyOffsets, const unsigned int* adjacency, unsigned int from, unsigned int to)
+	{
+		for (unsigned int i = adjacencyOffsets[from]; i < adjacencyOffsets[from + 1]; i++)
+		{
+			size_t triangle = adjacency[i];
+			unsigned int v0 = indices[triangle * 3];
+			unsigned int v1 = indices[triangle * 3 + 1];
+			unsigned int v2 = indices[triangle * 3 + 2];
+
+			//triangles using the collapsed edge are removed
+			if (v0 == to || v1 == to || v2 == to)
+			{
+				continue;
+			}
+
+			Vector3 normal = Vector3::CrossProduct(positions[v1] - positions[v0], positions[v2] - positions[v0]);
+
+			Vector3 p0 = positions[v0 == from ? to : v0];
+			Vector3 p1 = positions[v1 == from ? to : v1];
+			Vector3 p2 = positions[v2 == from ? to : v2];
+			Vector3 newNormal = Vector3::CrossProduct(p1 - p0, p2 - p0);
+
+			if (Vector3::DotProduct(normal, newNormal) <= 0.0f)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	float MeshOptimizer::ComputeVertexScore(int cachePosition, unsigned int numActiveTriangles)
+	{
+		if (numActiveTriangles == 0)
+		{
+			//the vertex is not used by any remaining triangle
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				//the vertices of the last triangle get a fixed score so the next triangle does not
+				//simply reuse the same edge which would make strips instead of patches
+				score = s_lastTriangleScore;
+			}
+			else
+			{
+				float scale = 1.0f / (float)(s_optimizedCacheSize - 3);
+				score = std::pow(1.0f - (float)(cachePosition - 3) * scale, s_cacheDecayPower);
+			}
+		}
+
+		//vertices with few triangles left are boosted so they get removed from the mesh early
+		score += s_valenceBoostScale * std::pow((float)numActiveTriangles, -s_valenceBoostPower);
+		return score;
+	}
+
+	void MeshOptimizer::ComputeClusterBounds(const ADynArr<Vector3>& positions,
+		const ADynArr<unsigned int>& clusterVertices, MeshCluster& cluster)
+	{
+		const unsigned int* vertices = clusterVertices.GetData() + cluster.firstVertex;
+		Vector3 boundsMin = positions[vertices[0]];
+		Vector3 boundsMax = boundsMin;
+		for (unsigned int i = 1; i < cluster.numVertices; i++)
+		{
+			const Vector3& position = positions[vertices[i]];
+			boundsMin = Vector3((std::min)(boundsMin.x, position.x), (std::min)(boundsMin.y, position.y),
+				(std::min)(boundsMin.z, position.z));
+			boundsMax = Vector3((std::max)(boundsMax.x, position.x), (std::max)(boundsMax.y, position.y),
+				(std::max)(boundsMax.z, position.z));
+		}
+
+		cluster.boundsCenter = (boundsMin + boundsMax) * 0.5f;
+		float sqrRadius = 0.0f;
+		for (unsigned int i = 0; i < cluster.numVertices; i++)
+		{
+			sqrRadius = (std::max)(sqrRadius, (positions[vertices[i]] - cluster.boundsCenter).SqrMagnitude());
+		}
+		cluster.boundsRadius = std::sqrt(sqrRadius);
+	}
+
+#ifdef AE_DEBUG
+	void MeshOptimizer::ValidateClusters(const ADynArr<Vector3>& positions, const ADynArr<unsigned int>& indices,
+		size_t maxVertices, size_t maxTriangles, const ADynArr<MeshCluster>& clusters,
+		const ADynArr<unsigned int>& clusterVertices, const ADynArr<unsigned short>& clusterIndices)
+	{
+		//triangles rotated so their smallest index comes first, which keeps their winding
+		auto canonical = [](unsigned int a, unsigned int b, unsigned int c) -> std::array<unsigned int, 3>
+		{
+			if (a <= b && a <= c)
+			{
+				return { a, b, c };
+			}
+			return b <= c ? std::array<unsigned int, 3>{ b, c, a } : std::array<unsigned int, 3>{ c, a, b };
+		};
+
+		size_t numTriangles = indices.GetCount() / 3;
+		ADynArr<std::array<unsigned int, 3>> meshTriangles(numTriangles);
+		for (size_t i = 0; i < numTriangles; i++)
+		{
+			meshTriangles.Add(canonical(indices[i * 3], indices[i * 3 + 1], indices[i * 3 + 2]));
+		}
+
+		ADynArr<std::array<unsigned int, 3>> clusterTriangles(numTriangles);
+		size_t nextVertex = 0;
+		size_t nextIndex = 0;
+		for (const MeshCluster& cluster : clusters)
+		{
+			AE_CORE_ASSERT(cluster.firstVertex == nextVertex && cluster.firstIndex == nextIndex, 
+				"Clusters do not cover contiguous ranges");
+			AE_CORE_ASSERT(cluster.numVertices > 0 && cluster.numVertices <= maxVertices, "Cluster has too many vertices");
+			AE_CORE_ASSERT(cluster.numIndices > 0 && cluster.numIndices % 3 == 0 && cluster.numIndices / 3 <= maxTriangles,
+				"Cluster has too many triangles");
+			nextVertex += cluster.numVertices;
+			nextIndex += cluster.numIndices;
+			AE_CORE_ASSERT(nextVertex <= clusterVertices.GetCount() && nextIndex <= clusterIndices.GetCount(), 
+				"Cluster range out of bounds");
+
+			const unsigned int* vertices = clusterVertices.GetData() + cluster.firstVertex;
+			for (unsigned int i = 0; i < cluster.numIndices; i += 3)
+			{
+				unsigned int triangle[3];
+				for (unsigned int j = 0; j < 3; j++)
+				{
+					unsigned short local = clusterIndices[cluster.firstIndex + i + j];
+					AE_CORE_ASSERT(local < cluster.numVertices, "Cluster index out of bounds");
+					triangle[j] = vertices[local];
+				}
+				clusterTriangles.Add(canonical(triangle[0], triangle[1], triangle[2]));
+			}
+
+			//small tolerance for the rounding of the radius
+			float tolerance = cluster.boundsRadius * 1e-4f + 1e-5f;
+			for (unsigned int i = 0; i < cluster.numVertices; i++)
+			{
+				AE_CORE_ASSERT((positions[vertices[i]] - cluster.boundsCenter).Magnitude() <= cluster.boundsRadius + tolerance,
+					"Cluster bounds do not contain its vertices");
+			}
+		}
+		AE_CORE_ASSERT(nextVertex == clusterVertices.GetCount() && nextIndex == clusterIndices.GetCount(),
+			"Cluster data not covered by the clusters");
+
+		//same triangles on both sides, including duplicated ones, means every triangle was assigned exactly once
+		AE_CORE_ASSERT(meshTriangles.GetCount() == clusterTriangles.GetCount(), "Triangles missing from the clusters");
+		std::sort(meshTriangles.GetData(), meshTriangles.GetData() + meshTriangles.GetCount());
+		std::sort(clusterTriangles.GetData(), clusterTriangles.GetData() + clusterTriangles.GetCount());
+		for (size_t i = 0; i < meshTriangles.GetCount(); i++)
+		{
+			AE_CORE_ASSERT(meshTriangles[i] == clusterTriangles[i], "Triangle not assigned to exactly one cluster");
+		}
+	}
+#endif
+}
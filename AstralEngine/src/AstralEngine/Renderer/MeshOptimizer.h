@@ -0,0 +1,111 @@
+#pragma once
+#include "AstralEngine/Data Struct/ADynArr.h"
+#include "AstralEngine/Math/AMath.h"
+
+namespace AstralEngine
+{
+	/* efficiency of an index order for a simulated FIFO post transform vertex cache
+
+	   acmr (average cache miss ratio) is the number of vertices transformed per triangle,
+	   between 0.5 and 3 with lower values being better. atvr (average transformed vertex ratio)
+	   is the number of vertices transformed per vertex of the mesh, 1 being optimal
+	*/
+	struct VertexCacheStatistics
+	{
+		float acmr;
+		float atvr;
+	};
+
+	/* group of neighbouring triangles of a mesh small enough to be batched and culled on its own
+
+	   the vertices of the cluster are the range [firstVertex, firstVertex + numVertices) of the 
+	   cluster vertices, which hold indices of vertices of the mesh, and its triangles the range 
+	   [firstIndex, firstIndex + numIndices) of the cluster indices, which refer to the vertices 
+	   of the cluster
+	*/
+	struct MeshCluster
+	{
+		unsigned int firstVertex;
+		unsigned int numVertices;
+		unsigned int firstIndex;
+		unsigned int numIndices;
+
+		//bounding sphere of the vertices of the cluster in the local space of the mesh
+		Vector3 boundsCenter;
+		float boundsRadius;
+	};
+
+	/* cpu side processing of the geometry of imported meshes
+
+	   OptimizeVertexCache reorders the triangles using Tom Forsyth's linear speed vertex cache
+	   optimization so consecutive triangles reuse the vertices recently transformed by the gpu,
+	   OptimizeVertexFetch then reorders the vertices in the order they are first used so the
+	   vertex fetches walk through memory linearly
+
+	   OptimizeOverdraw runs between the two (Sander et al., "Fast Triangle Reordering for Vertex 
+	   Locality and Reduced Overdraw"), the triangles are split in clusters where the cache was 
+	   already cold and the clusters facing away from the center of the mesh are drawn first so 
+	   they occlude the inner ones
+
+	   Simplify reduces the number of triangles of a mesh by collapsing the edges which least change 
+	   its surface according to quadric error metrics (Garland and Heckbert), vertices are collapsed 
+	   onto one of their neighbours so the simplified indices still refer to the original vertices
+
+	   BuildClusters partitions the triangles of a mesh into clusters grown from a seed triangle
+	   through the triangles sharing its vertices, which keeps the clusters compact so their 
+	   bounding spheres are tight enough to be culled individually
+	*/
+	class MeshOptimizer
+	{
+	public:
+		static void OptimizeVertexCache(ADynArr<unsigned int>& indices, size_t numVertices);
+
+		/*the indices must already be optimized for the vertex cache, threshold is the increase of the 
+		  cache miss ratio accepted inside a cluster to split it into smaller clusters which can be sorted
+		*/
+		static void OptimizeOverdraw(const ADynArr<Vector3>& positions, ADynArr<unsigned int>& indices,
+			float threshold = s_overdrawThreshold);
+
+		//unreferenced vertices are moved at the end of the arrays
+		static void OptimizeVertexFetch(ADynArr<Vector3>& positions, ADynArr<Vector2>& textureCoords,
+			ADynArr<Vector3>& normals, ADynArr<unsigned int>& indices);
+
+		/*the mesh is simplified until it has at most targetIndexCount indices or no edge can be 
+		  collapsed anymore. Vertices on the border of the mesh (including uv and normal seams) are 
+		  never moved so the outline of the mesh is preserved
+		*/
+		static void Simplify(const ADynArr<Vector3>& positions, const ADynArr<unsigned int>& indices, 
+			size_t targetIndexCount, ADynArr<unsigned int>& outIndices);
+
+		//every cluster has at most maxVertices vertices and maxTriangles triangles
+		static void BuildClusters(const ADynArr<Vector3>& positions, const ADynArr<unsigned int>& indices,
+			size_t maxVertices, size_t maxTriangles, ADynArr<MeshCluster>& outClusters, 
+			ADynArr<unsigned int>& outClusterVertices, ADynArr<unsigned short>& outClusterIndices);
+
+		static VertexCacheStatistics AnalyzeVertexCache(const ADynArr<unsigned int>& indices,
+			size_t numVertices, size_t cacheSize = s_analyzedCacheSize);
+
+	private:
+		//size of the cache modeled by the optimization, the real cache of the gpu is not known
+		static constexpr size_t s_optimizedCacheSize = 32;
+		static constexpr size_t s_analyzedCacheSize = 16;
+		static constexpr float s_overdrawThreshold = 1.05f;
+
+		static float ComputeVertexScore(int cachePosition, unsigned int numActiveTriangles);
+		static void ComputeClusterBounds(const ADynArr<Vector3>& positions, 
+			const ADynArr<unsigned int>& clusterVertices, MeshCluster& cluster);
+
+#ifdef AE_DEBUG
+		/*asserts that the clusters partition the triangles of the mesh, every triangle being assigned 
+		  to exactly one cluster, that they respect the limits and that their bounds contain their vertices
+		*/
+		static void ValidateClusters(const ADynArr<Vector3>& positions, const ADynArr<unsigned int>& indices,
+			size_t maxVertices, size_t maxTriangles, const ADynArr<MeshCluster>& clusters,
+			const ADynArr<unsigned int>& clusterVertices, const ADynArr<unsigned short>& clusterIndices);
+#endif
+
+		//true if moving the vertex from onto the vertex to would flip one of the triangles around it
+		static bool CollapseFlipsTriangle(const ADynArr<Vector3>& positions, const ADynArr<unsigned int>& indices,
+			const unsigned int* adjacencyOffsets, const unsigned int* adjacency, unsigned int from, unsigned int to);
+	};
+}
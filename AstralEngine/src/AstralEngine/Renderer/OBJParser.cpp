@@ -0,0 +1,592 @@
+#include "aepch.h"
+#include "OBJParser.h"
+#include "AstralEngine/Core/JobSystem.h"
+#include "AstralEngine/Data Struct/AUnorderedMap.h"
+
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <cmath>
+
+namespace AstralEngine
+{
+	//attributes of a vertex used to weld identical face corners when importing a mesh
+	struct VertexKey
+	{
+		Vector3 position;
+		Vector2 textureCoords;
+		Vector3 normal;
+
+		bool operator==(const VertexKey& other) const
+		{
+			return position == other.position && textureCoords == other.textureCoords && normal == other.normal;
+		}
+	};
+}
+
+namespace std
+{
+	template<>
+	struct hash<AstralEngine::VertexKey>
+	{
+		size_t operator()(const AstralEngine::VertexKey& key) const
+		{
+			const float values[] = { key.position.x, key.position.y, key.position.z, key.textureCoords.x,
+				key.textureCoords.y, key.normal.x, key.normal.y, key.normal.z };
+
+			//FNV-1a over the bits of every component, -0 and +0 compare equal so they must hash the same
+			size_t hash = 2166136261u;
+			for (float value : values)
+			{
+				std::uint32_t bits = 0;
+				if (value != 0.0f)
+				{
+					std::memcpy(&bits, &value, sizeof(float));
+				}
+				hash = (hash ^ bits) * 16777619u;
+			}
+			return hash ^ (hash >> 16);
+		}
+	};
+}
+
+namespace AstralEngine
+{
+	// Tokenizer helpers //////////////////////////////////////////////
+
+	static bool IsBlank(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	static bool IsDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	static const char* SkipBlanks(const char* curr, const char* end)
+	{
+		while (curr < end && IsBlank(*curr))
+		{
+			curr++;
+		}
+		return curr;
+	}
+
+	//returns the position right after the end of the line starting at curr
+	static const char* FindNextLine(const char* curr, const char* end)
+	{
+		const char* newLine = (const char*)std::memchr(curr, '\n', end - curr);
+		return newLine == nullptr ? end : newLine + 1;
+	}
+
+	//checks if the line starts with the keyword followed by a blank
+	static bool StartsWithKeyword(const char* curr, const char* lineEnd, const char* keyword, size_t length)
+	{
+		if ((size_t)(lineEnd - curr) <= length)
+		{
+			return false;
+		}
+		return std::memcmp(curr, keyword, length) == 0 && IsBlank(curr[length]);
+	}
+
+	static bool ParseInt(const char*& curr, const char* end, int& out)
+	{
+		bool isNegative = false;
+		if (curr < end && (*curr == '-' || *curr == '+'))
+		{
+			isNegative = *curr == '-';
+			curr++;
+		}
+
+		if (curr >= end || !IsDigit(*curr))
+		{
+			return false;
+		}
+
+		long long value = 0;
+		while (curr < end && IsDigit(*curr))
+		{
+			if (value <= INT_MAX)
+			{
+				value = value * 10 + (*curr - '0');
+			}
+			curr++;
+		}
+
+		if (value > INT_MAX)
+		{
+			return false;
+		}
+
+		out = isNegative ? -(int)value : (int)value;
+		return true;
+	}
+
+	/*only the first 19 significant digits are kept in the mantissa which is well above
+	  the precision of a float, the decimal exponent is applied in double precision
+	*/
+	static bool ParseFloat(const char*& curr, const char* end, float& out)
+	{
+		static constexpr double s_powersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+			1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+		static constexpr int s_maxExactPower = 22;
+		static constexpr int s_maxMantissaDigits = 19;
+
+		curr = SkipBlanks(curr, end);
+
+		bool isNegative = false;
+		if (curr < end && (*curr == '-' || *curr == '+'))
+		{
+			isNegative = *curr == '-';
+			curr++;
+		}
+
+		std::uint64_t mantissa = 0;
+		int exponent = 0;
+		int numDigits = 0;
+		bool hasDigits = false;
+
+		while (curr < end && IsDigit(*curr))
+		{
+			if (numDigits < s_maxMantissaDigits)
+			{
+				mantissa = mantissa * 10 + (*curr - '0');
+				numDigits += mantissa != 0 ? 1 : 0;
+			}
+			else
+			{
+				exponent++;
+			}
+			hasDigits = true;
+			curr++;
+		}
+
+		if (curr < end && *curr == '.')
+		{
+			curr++;
+			while (curr < end && IsDigit(*curr))
+			{
+				if (numDigits < s_maxMantissaDigits)
+				{
+					mantissa = mantissa * 10 + (*curr - '0');
+					numDigits += mantissa != 0 ? 1 : 0;
+					exponent--;
+				}
+				hasDigits = true;
+				curr++;
+			}
+		}
+
+		if (!hasDigits)
+		{
+			return false;
+		}
+
+		if (curr < end && (*curr == 'e' || *curr == 'E'))
+		{
+			curr++;
+			int explicitExponent;
+			if (!ParseInt(curr, end, explicitExponent))
+			{
+				return false;
+			}
+			exponent += explicitExponent;
+		}
+
+		double value = (double)mantissa;
+		if (exponent > 0)
+		{
+			value *= exponent <= s_maxExactPower ? s_powersOfTen[exponent] : std::pow(10.0, exponent);
+		}
+		else if (exponent < 0)
+		{
+			value /= -exponent <= s_maxExactPower ? s_powersOfTen[-exponent] : std::pow(10.0, -exponent);
+		}
+
+		out = (float)(isNegative ? -value : value);
+		return true;
+	}
+
+	/*converts a one based index (or a negative index relative to the number of attributes
+	  defined so far) to a zero based index, 0 is not a valid index
+	*/
+	static bool ResolveIndex(int index, size_t numDefined, int& out)
+	{
+		if (index > 0)
+		{
+			out = index - 1;
+			return true;
+		}
+		else if (index < 0 && (size_t)(-(long long)index) <= numDefined)
+		{
+			out = (int)numDefined + index;
+			return true;
+		}
+		return false;
+	}
+
+	// OBJParser //////////////////////////////////////////////////////
+
+	bool OBJParser::ParseFile(const std::string& filepath)
+	{
+		std::ifstream file(filepath, std::ios::in | std::ios::binary | std::ios::ate);
+
+		if (!file)
+		{
+			AE_CORE_WARN("could not load file \"%S\"", filepath);
+			return false;
+		}
+
+		//read the whole file at once instead of line by line
+		size_t size = (size_t)file.tellg();
+		file.seekg(0, std::ios::beg);
+		std::string data;
+		data.resize(size);
+		file.read(&data[0], size);
+
+		if (!Parse(data.data(), size))
+		{
+			AE_CORE_WARN("Unexpected format in OBJ file %S", filepath);
+			return false;
+		}
+		return true;
+	}
+
+	bool OBJParser::Parse(const char* data, size_t size)
+	{
+		AE_PROFILE_FUNCTION();
+
+		m_positions.Clear();
+		m_textureCoords.Clear();
+		m_normals.Clear();
+		m_indices.Clear();
+
+		SplitInChunks(data, size);
+
+		//first pass, count the attributes so the chunks know which indices they define
+		JobSystem::ParallelFor(m_chunks.GetCount(), [this](size_t i) { CountAttributes(m_chunks[i]); });
+
+		size_t numPositions = 0;
+		size_t numTextureCoords = 0;
+		size_t numNormals = 0;
+		for (Chunk& chunk : m_chunks)
+		{
+			chunk.positionOffset = numPositions;
+			chunk.textureCoordsOffset = numTextureCoords;
+			chunk.normalOffset = numNormals;
+			numPositions += chunk.numPositions;
+			numTextureCoords += chunk.numTextureCoords;
+			numNormals += chunk.numNormals;
+		}
+
+		m_positions.Reserve(numPositions);
+		for (size_t i = 0; i < numPositions; i++)
+		{
+			m_positions.Add(Vector3::Zero());
+		}
+
+		m_textureCoords.Reserve(numTextureCoords);
+		for (size_t i = 0; i < numTextureCoords; i++)
+		{
+			m_textureCoords.Add(Vector2::Zero());
+		}
+
+		m_normals.Reserve(numNormals);
+		for (size_t i = 0; i < numNormals; i++)
+		{
+			m_normals.Add(Vector3::Zero());
+		}
+
+		//second pass, every chunk writes its attributes directly to their final position
+		JobSystem::ParallelFor(m_chunks.GetCount(), [this](size_t i) { ParseChunk(m_chunks[i]); });
+
+		size_t numIndices = 0;
+		for (const Chunk& chunk : m_chunks)
+		{
+			if (!chunk.succeeded)
+			{
+				m_chunks.Clear();
+				return false;
+			}
+			numIndices += chunk.indices.GetCount();
+		}
+
+		m_indices.Reserve(numIndices);
+		for (const Chunk& chunk : m_chunks)
+		{
+			for (const OBJIndex& index : chunk.indices)
+			{
+				m_indices.Add(index);
+			}
+		}
+		m_chunks.Clear();
+
+		return ValidateIndices();
+	}
+
+	void OBJParser::SplitInChunks(const char* data, size_t size)
+	{
+		m_chunks.Clear();
+
+		size_t numChunks = 1;
+		if (JobSystem::IsInitialized() && size >= 2 * s_chunkSize)
+		{
+			numChunks = size / s_chunkSize;
+		}
+
+		const char* end = data + size;
+		const char* curr = data;
+		for (size_t i = 1; i <= numChunks && curr < end; i++)
+		{
+			//chunks always end right after a line break so no line is split between two chunks
+			const char* chunkEnd = i == numChunks ? end : FindNextLine(data + (size * i) / numChunks, end);
+			if (chunkEnd <= curr)
+			{
+				continue;
+			}
+
+			Chunk chunk;
+			chunk.begin = curr;
+			chunk.end = chunkEnd;
+			chunk.positionOffset = 0;
+			chunk.textureCoordsOffset = 0;
+			chunk.normalOffset = 0;
+			chunk.numPositions = 0;
+			chunk.numTextureCoords = 0;
+			chunk.numNormals = 0;
+			chunk.succeeded = false;
+			m_chunks.Add(chunk);
+
+			curr = chunkEnd;
+		}
+	}
+
+	void OBJParser::CountAttributes(Chunk& chunk)
+	{
+		const char* curr = chunk.begin;
+		while (curr < chunk.end)
+		{
+			const char* lineEnd = FindNextLine(curr, chunk.end);
+			curr = SkipBlanks(curr, lineEnd);
+
+			if (StartsWithKeyword(curr, lineEnd, "v", 1))
+			{
+				chunk.numPositions++;
+			}
+			else if (StartsWithKeyword(curr, lineEnd, "vt", 2))
+			{
+				chunk.numTextureCoords++;
+			}
+			else if (StartsWithKeyword(curr, lineEnd, "vn", 2))
+			{
+				chunk.numNormals++;
+			}
+
+			curr = lineEnd;
+		}
+	}
+
+	void OBJParser::ParseChunk(Chunk& chunk)
+	{
+		size_t numPositions = chunk.positionOffset;
+		size_t numTextureCoords = chunk.textureCoordsOffset;
+		size_t numNormals = chunk.normalOffset;
+
+		//roughly one face line out of two in usual files, each giving at least one triangle
+		chunk.indices.Reserve((size_t)(chunk.end - chunk.begin) / 32);
+
+		const char* curr = chunk.begin;
+		while (curr < chunk.end)
+		{
+			const char* lineEnd = FindNextLine(curr, chunk.end);
+			curr = SkipBlanks(curr, lineEnd);
+
+			if (StartsWithKeyword(curr, lineEnd, "v", 1)) //defining a position
+			{
+				//an optional w component can follow, it is ignored
+				curr++;
+				Vector3& position = m_positions[numPositions++];
+				if (!ParseFloat(curr, lineEnd, position.x) || !ParseFloat(curr, lineEnd, position.y)
+					|| !ParseFloat(curr, lineEnd, position.z))
+				{
+					return;
+				}
+			}
+			else if (StartsWithKeyword(curr, lineEnd, "vt", 2)) //defining a texture coordinate
+			{
+				//the v and w components are optional
+				curr += 2;
+				Vector2& texCoords = m_textureCoords[numTextureCoords++];
+				if (!ParseFloat(curr, lineEnd, texCoords.x))
+				{
+					return;
+				}
+
+				if (!ParseFloat(curr, lineEnd, texCoords.y))
+				{
+					texCoords.y = 0.0f;
+				}
+			}
+			else if (StartsWithKeyword(curr, lineEnd, "vn", 2)) //defining a normal
+			{
+				curr += 2;
+				Vector3& normal = m_normals[numNormals++];
+				if (!ParseFloat(curr, lineEnd, normal.x) || !ParseFloat(curr, lineEnd, normal.y)
+					|| !ParseFloat(curr, lineEnd, normal.z))
+				{
+					return;
+				}
+			}
+			else if (StartsWithKeyword(curr, lineEnd, "f", 1)) //defining a face
+			{
+				if (!ParseFace(chunk, curr + 1, lineEnd, numPositions, numTextureCoords, numNormals))
+				{
+					return;
+				}
+			}
+
+			curr = lineEnd;
+		}
+
+		chunk.succeeded = true;
+	}
+
+	/*accepts the formats pos, pos/tex, pos//normal and pos/tex/normal for every corner,
+	  polygons are triangulated as a fan around their first corner
+	*/
+	bool OBJParser::ParseFace(Chunk& chunk, const char* curr, const char* lineEnd, size_t numPositions,
+		size_t numTextureCoords, size_t numNormals)
+	{
+		OBJIndex first = { -1, -1, -1 };
+		OBJIndex previous = { -1, -1, -1 };
+		size_t numCorners = 0;
+
+		while (true)
+		{
+			curr = SkipBlanks(curr, lineEnd);
+			if (curr >= lineEnd || *curr == '\n' || *curr == '#')
+			{
+				break;
+			}
+
+			OBJIndex corner = { -1, -1, -1 };
+			int index;
+			if (!ParseInt(curr, lineEnd, index) || !ResolveIndex(index, numPositions, corner.position))
+			{
+				return false;
+			}
+
+			if (curr < lineEnd && *curr == '/')
+			{
+				curr++;
+				if (curr < lineEnd && *curr != '/')
+				{
+					if (!ParseInt(curr, lineEnd, index) || !ResolveIndex(index, numTextureCoords, corner.textureCoords))
+					{
+						return false;
+					}
+				}
+
+				//the normal index is optional even after a second slash ("pos//")
+				if (curr < lineEnd && *curr == '/')
+				{
+					curr++;
+					if (curr < lineEnd && (IsDigit(*curr) || *curr == '-' || *curr == '+'))
+					{
+						if (!ParseInt(curr, lineEnd, index) || !ResolveIndex(index, numNormals, corner.normal))
+						{
+							return false;
+						}
+					}
+				}
+			}
+
+			if (curr < lineEnd && !IsBlank(*curr) && *curr != '\n')
+			{
+				return false;
+			}
+
+			if (numCorners == 0)
+			{
+				first = corner;
+			}
+			else if (numCorners >= 2)
+			{
+				chunk.indices.Add(first);
+				chunk.indices.Add(previous);
+				chunk.indices.Add(corner);
+			}
+
+			previous = corner;
+			numCorners++;
+		}
+
+		return numCorners >= 3;
+	}
+
+	bool OBJParser::ValidateIndices() const
+	{
+		for (const OBJIndex& index : m_indices)
+		{
+			if ((size_t)index.position >= m_positions.GetCount()
+				|| (index.textureCoords != -1 && (size_t)index.textureCoords >= m_textureCoords.GetCount())
+				|| (index.normal != -1 && (size_t)index.normal >= m_normals.GetCount()))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void OBJParser::WeldVertices(ADynArr<Vector3>& outPositions, ADynArr<Vector2>& outTextureCoords,
+		ADynArr<Vector3>& outNormals, ADynArr<unsigned int>& outIndices) const
+	{
+		AE_PROFILE_FUNCTION();
+
+		outPositions.Clear();
+		outTextureCoords.Clear();
+		outNormals.Clear();
+		outIndices.Clear();
+		outIndices.Reserve(m_indices.GetCount());
+
+		//maps the attributes of every vertex added so far to its index so duplicates are found in constant time
+		//most vertices are shared by several triangles so the map is sized for a fraction of the indices
+		AUnorderedMap<VertexKey, unsigned int> vertexIndices(m_indices.GetCount() / 4);
+
+		for (const OBJIndex& objIndex : m_indices)
+		{
+			VertexKey key;
+			key.position = m_positions[objIndex.position];
+
+			if (objIndex.textureCoords != -1)
+			{
+				key.textureCoords = m_textureCoords[objIndex.textureCoords];
+			}
+
+			if (objIndex.normal != -1)
+			{
+				key.normal = m_normals[objIndex.normal];
+			}
+
+			unsigned int vertexIndex;
+			if (vertexIndices.ContainsKey(key))
+			{
+				vertexIndex = vertexIndices[key];
+			}
+			else
+			{
+				vertexIndex = (unsigned int)outPositions.GetCount();
+				vertexIndices.Add(key, vertexIndex);
+
+				//add a vertex point
+				outPositions.Add(key.position);
+				outTextureCoords.Add(key.textureCoords);
+				outNormals.Add(key.normal);
+			}
+
+			outIndices.Add(vertexIndex);
+		}
+	}
+}
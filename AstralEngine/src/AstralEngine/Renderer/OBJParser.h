@@ -0,0 +1,80 @@
+#pragma once
+#include "AstralEngine/Data Struct/ADynArr.h"
+#include "AstralEngine/Math/AMath.h"
+
+#include <string>
+
+namespace AstralEngine
+{
+	//indices of the attributes of a face corner, -1 when the attribute is not provided
+	struct OBJIndex
+	{
+		int position;
+		int textureCoords;
+		int normal;
+	};
+
+	/* parses the geometry of a Wavefront OBJ file
+
+	   the whole file is read at once and tokenized in place using hand written number parsers.
+	   Polygons with more than three corners are triangulated as fans and negative (relative) indices
+	   are resolved while parsing. Large files are split in chunks of lines parsed on the JobSystem,
+	   a first pass counts the vertex attributes of every chunk so relative indices can be resolved
+	   and the attributes written directly to their final position
+	*/
+	class OBJParser
+	{
+	public:
+		// returns false if the file could not be read or is malformed
+		bool ParseFile(const std::string& filepath);
+		bool Parse(const char* data, size_t size);
+
+		const ADynArr<Vector3>& GetPositions() const { return m_positions; }
+		const ADynArr<Vector2>& GetTextureCoords() const { return m_textureCoords; }
+		const ADynArr<Vector3>& GetNormals() const { return m_normals; }
+
+		// three corners per triangle
+		const ADynArr<OBJIndex>& GetIndices() const { return m_indices; }
+
+		/*builds the indexed vertices of the parsed geometry, the corners with identical attributes are 
+		  welded into a single vertex. The attributes missing from a corner are left to zero
+		*/
+		void WeldVertices(ADynArr<Vector3>& outPositions, ADynArr<Vector2>& outTextureCoords,
+			ADynArr<Vector3>& outNormals, ADynArr<unsigned int>& outIndices) const;
+
+	private:
+		struct Chunk
+		{
+			const char* begin;
+			const char* end;
+
+			// number of attributes defined before the chunk
+			size_t positionOffset;
+			size_t textureCoordsOffset;
+			size_t normalOffset;
+
+			size_t numPositions;
+			size_t numTextureCoords;
+			size_t numNormals;
+
+			ADynArr<OBJIndex> indices;
+			bool succeeded;
+		};
+
+		// files smaller than two chunks are parsed on the calling thread
+		static constexpr size_t s_chunkSize = 1024 * 1024;
+
+		void SplitInChunks(const char* data, size_t size);
+		static void CountAttributes(Chunk& chunk);
+		void ParseChunk(Chunk& chunk);
+		static bool ParseFace(Chunk& chunk, const char* curr, const char* lineEnd, size_t numPositions,
+			size_t numTextureCoords, size_t numNormals);
+		bool ValidateIndices() const;
+
+		ADynArr<Chunk> m_chunks;
+		ADynArr<Vector3> m_positions;
+		ADynArr<Vector2> m_textureCoords;
+		ADynArr<Vector3> m_normals;
+		ADynArr<OBJIndex> m_indices;
+	};
+}
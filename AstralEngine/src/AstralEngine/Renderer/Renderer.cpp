@@ -645,6 +645,8 @@ namespace AstralEngine
 	//Renderer///////////////////////////////////////////////////
 
 	RendererStatistics Renderer::s_stats;
+	ALinearAllocator Renderer::s_frameAllocators[2];
+	size_t Renderer::s_currFrameAllocator = 0;
 
 	RenderQueue* Renderer::s_forwardQueue;
 	RenderQueue* Renderer::s_deferredQueue;
@@ -690,6 +692,11 @@ namespace AstralEngine
 		return s_camPos;
 	}
 
+	const Mat4& Renderer::GetViewProjMatrix()
+	{
+		return s_viewProjMatrix;
+	}
+
 	void Renderer::BindGBufferTextures() { s_deferredQueue->BindGBufferTextureData(); }
 
 	bool Renderer::LightsModified() { return s_lightHandler.LightsModified(); }
@@ -756,21 +763,17 @@ namespace AstralEngine
 		
 		s_stats.timePerFrame = Time::GetTime() - s_frameStartTime;
 		s_lightHandler.m_lightsModified = false;
+
+		s_stats.numFrameAllocations += (unsigned int)GetFrameAllocator().GetNumHeapAllocations();
+		s_currFrameAllocator = (s_currFrameAllocator + 1) % 2;
+		GetFrameAllocator().Reset();
 	}
 	
 	void Renderer::DrawQuad(const Mat4& transform, MaterialHandle mat, Texture2DHandle texture,
 		float tileFactor, const Vector4& tintColor)
 	{
-		DrawCommand* cmd = new DrawCommand(transform, mat, Mesh::QuadMesh(), tintColor, NullEntity,
-			(tintColor.a == 1.0f), texture);
-		if (cmd->UsesDeferred())
-		{
-			s_deferredQueue->AddData(cmd);
-		}
-		else
-		{
-			s_forwardQueue->AddData(cmd);
-		}
+		SubmitDrawCommand(GetFrameAllocator().New<DrawCommand>(transform, mat, Mesh::QuadMesh(), 
+			tintColor, NullEntity, (tintColor.a == 1.0f), texture));
 	}
 
 	void Renderer::DrawQuad(const Mat4& transform, Texture2DHandle texture,
@@ -835,17 +838,11 @@ namespace AstralEngine
 
 	void Renderer::DrawSprite(const Transform& transform, const SpriteRenderer& sprite)
 	{
-		DrawCommand* cmd = new DrawCommand(transform.GetTransformMatrix(), Material::SpriteMat(),
-			Mesh::QuadMesh(), sprite.GetColor(), transform.GetAEntity(), sprite.GetColor().a == 1.0f, sprite.GetSprite());
-
-		if (cmd->UsesDeferred())
-		{
-			s_deferredQueue->AddData(cmd);
-		}
-		else
-		{
-			s_forwardQueue->AddData(cmd);
-		}
+		//the matrix is computed first since it can bump the version of the transform
+		const Mat4& transformMatrix = transform.GetTransformMatrix();
+		SubmitDrawCommand(GetFrameAllocator().New<DrawCommand>(transformMatrix, 
+			Material::SpriteMat(), Mesh::QuadMesh(), sprite.GetColor(), transform.GetAEntity(), 
+			sprite.GetColor().a == 1.0f, sprite.GetSprite(), transform.GetMatrixVersion()));
 	}
 
 	void Renderer::DrawSprite(const Vector3& position, float rotation, const Vector2& size,
@@ -859,22 +856,61 @@ namespace AstralEngine
 	{
 		if (mesh.GetMesh() != NullHandle)
 		{
-			AReference<Material> material = ResourceHandler::GetMaterial(mesh.GetMaterial());
-			DrawCommand* cmd = new DrawCommand(transform.GetTransformMatrix(), mesh.GetMaterial(),
-				mesh.GetMesh(), Vector4(1.0f, 1.0f, 1.0f, 1.0f), transform.GetAEntity(), 
-				(material->GetColor().a == 1.0f));
+			const Mat4& transformMatrix = transform.GetTransformMatrix();
+			ResourceView<Material> material = ResourceHandler::BorrowMaterial(mesh.GetMaterial());
+			SubmitDrawCommand(GetFrameAllocator().New<DrawCommand>(transformMatrix, mesh.GetMaterial(), 
+				SelectMeshLOD(transformMatrix, mesh.GetMesh()), Vector4(1.0f, 1.0f, 1.0f, 1.0f), 
+				transform.GetAEntity(), (material->GetColor().a == 1.0f), NullHandle, transform.GetMatrixVersion()));
+		}
+	}
 
-			if (cmd->UsesDeferred())
-			{
-				s_deferredQueue->AddData(cmd);
-			}
-			else
-			{
-				s_forwardQueue->AddData(cmd);
-			}
+	MeshHandle Renderer::SelectMeshLOD(const Mat4& transform, MeshHandle mesh)
+	{
+		ResourceView<Mesh> meshData = ResourceHandler::BorrowMesh(mesh);
+		if (meshData == nullptr || meshData->GetNumLODs() == 0)
+		{
+			return mesh;
+		}
+
+		const Vector3& center = meshData->GetBoundsCenter();
+		Vector4 clipPos = s_viewProjMatrix * (transform * Vector4(center.x, center.y, center.z, 1.0f));
+		if (clipPos.w <= 0.0f)
+		{
+			// behind the camera
+			return mesh;
+		}
+
+		//the largest scale of the transform bounds the radius of the transformed sphere
+		float scale = Math::Max(Math::Max(Vector3(transform[0].x, transform[0].y, transform[0].z).Magnitude(),
+			Vector3(transform[1].x, transform[1].y, transform[1].z).Magnitude()),
+			Vector3(transform[2].x, transform[2].y, transform[2].z).Magnitude());
+
+		//the view matrix does not change lengths so the y row of viewProj holds the vertical scale of the projection
+		float projectionScale = Vector3(s_viewProjMatrix[0].y, s_viewProjMatrix[1].y, 
+			s_viewProjMatrix[2].y).Magnitude();
+		float screenSize = meshData->GetBoundsRadius() * scale * projectionScale / clipPos.w;
+
+		MeshHandle lod = meshData->SelectLOD(screenSize);
+		return lod == NullHandle ? mesh : lod;
+	}
+
+	void Renderer::SubmitDrawCommand(DrawCommand* cmd)
+	{
+		if (cmd->UsesDeferred())
+		{
+			s_deferredQueue->AddData(cmd);
+		}
+		else
+		{
+			s_forwardQueue->AddData(cmd);
 		}
 	}
 
+	ALinearAllocator& Renderer::GetFrameAllocator()
+	{
+		return s_frameAllocators[s_currFrameAllocator];
+	}
+
 	void Renderer::DrawUIElement(const UIElement& element, const Vector4& color)
 	{
 		Vector3 worldPos = (Vector3)element.GetWorldPos();
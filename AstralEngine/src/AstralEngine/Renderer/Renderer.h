@@ -1,5 +1,6 @@
 #pragma once
 #include "AstralEngine/Data Struct/AReference.h"
+#include "AstralEngine/Data Struct/ALinearAllocator.h"
 #include "AstralEngine/Math/AMath.h"
 #include "RenderCommand.h"
 #include "Shader.h"
@@ -18,6 +19,7 @@ namespace AstralEngine
 	class UIElement;
 
 	class RenderQueue;
+	class DrawCommand;
 	class Camera;
 	class SpriteRenderer;
 	class MeshRenderer;
@@ -225,6 +227,9 @@ namespace AstralEngine
 		unsigned int numDrawCalls = 0;
 		unsigned int numVertices = 0;
 		unsigned int numIndices = 0;
+		unsigned int numFrameAllocations = 0; // heap allocations made by the per frame allocator
+		unsigned int numBytesUploaded = 0; // vertex, index and instance data sent to the gpu
+		unsigned int numCulledClusters = 0; // clusters of batched meshes outside of the view
 		double timePerFrame; // in seconds
 
 		double GetFrameRate() const
@@ -237,6 +242,9 @@ namespace AstralEngine
 			numDrawCalls = 0;
 			numVertices = 0;
 			numIndices = 0;
+			numFrameAllocations = 0;
+			numBytesUploaded = 0;
+			numCulledClusters = 0;
 		}
 	};
 
@@ -244,6 +252,8 @@ namespace AstralEngine
 	{
 		friend class DrawDataBuffer;
 		friend class Light;
+		friend class Mesh;
+		friend class StaticBatch;
 	public:
 		static void Init();
 		static void Shutdown();
@@ -253,6 +263,9 @@ namespace AstralEngine
 		static const RendererStatistics& GetStats();
 		static void ResetStats();
 		static Vector3 GetCamPos();
+
+		//view projection matrix of the camera used for the current scene
+		static const Mat4& GetViewProjMatrix();
 		static void BindGBufferTextures();
 
 		// Lights
@@ -322,7 +335,19 @@ namespace AstralEngine
 		static void DrawUIElement(const UIElement& element, const Vector4& color);
 
 	private:
+		static void SubmitDrawCommand(DrawCommand* cmd);
+
+		//returns the level of detail of the mesh matching the size it covers on screen
+		static MeshHandle SelectMeshLOD(const Mat4& transform, MeshHandle mesh);
+
+		// memory of the draw commands and temporary render data of the current frame
+		static ALinearAllocator& GetFrameAllocator();
+
 		static RendererStatistics s_stats;
+
+		// double buffered so the data of the previous frame stays valid for a frame
+		static ALinearAllocator s_frameAllocators[2];
+		static size_t s_currFrameAllocator;
 		
 		static RenderQueue* s_forwardQueue;
 		static RenderQueue* s_deferredQueue;
@@ -23,8 +23,9 @@ namespace AstralEngine
 	DrawCommand::DrawCommand() { }
 
 	DrawCommand::DrawCommand(const Mat4& transform, MaterialHandle mat, MeshHandle mesh, const Vector4& color, 
-		const AEntity e, bool opaque, Texture2DHandle texture) : m_transform(transform), m_mesh(mesh), 
-		m_material(mat), m_color(color), m_entity(e), m_texture(texture), m_opaque(opaque)
+		const AEntity e, bool opaque, Texture2DHandle texture, unsigned int transformVersion) : m_transform(transform), 
+		m_mesh(mesh), m_material(mat), m_color(color), m_entity(e), m_texture(texture), m_opaque(opaque), 
+		m_transformVersion(transformVersion)
 	{
 		if (m_material == NullHandle)
 		{
@@ -41,10 +42,11 @@ namespace AstralEngine
 	Texture2DHandle DrawCommand::GetTexture() const { return m_texture; }
 
 	bool DrawCommand::IsOpaque() const { return m_opaque; }
+	unsigned int DrawCommand::GetTransformVersion() const { return m_transformVersion; }
 
 	bool DrawCommand::UsesDeferred() const
 	{
-		return ResourceHandler::GetMaterial(m_material)->UsesDeferredRendering();
+		return ResourceHandler::BorrowMaterial(m_material)->UsesDeferredRendering();
 	}
 
 	bool DrawCommand::operator==(const DrawCommand& other) const
@@ -108,17 +110,468 @@ namespace AstralEngine
 
 	void GBuffer::BindTexureData()
 	{
-		AReference<Texture2D> t1 = ResourceHandler::GetTexture2D(m_framebuffer->GetColorAttachment());
-		AReference<Texture2D> t2 = ResourceHandler::GetTexture2D(m_framebuffer->GetColorAttachment(1));
-		AReference<Texture2D> t3 = ResourceHandler::GetTexture2D(m_framebuffer->GetColorAttachment(2));
+		ResourceView<Texture2D> t1 = ResourceHandler::BorrowTexture2D(m_framebuffer->GetColorAttachment());
+		ResourceView<Texture2D> t2 = ResourceHandler::BorrowTexture2D(m_framebuffer->GetColorAttachment(1));
+		ResourceView<Texture2D> t3 = ResourceHandler::BorrowTexture2D(m_framebuffer->GetColorAttachment(2));
 
 		t1->Bind();
 		t2->Bind(1);
 		t3->Bind(2);
 	}
 
+	static const VertexBufferLayout& GetBatchLayout()
+	{
+		static VertexBufferLayout layout = {
+			{ ADataType::Float3, "position" },
+			{ ADataType::Float3, "normal" },
+			{ ADataType::Float2, "textureCoords" },
+			{ ADataType::Mat4, "transform" },
+			{ ADataType::Float4, "color" },
+			{ ADataType::Float, "textureIndex" }
+		};
+		return layout;
+	}
+
+	// StaticBatch ///////////////////////////////////////////////////////
+
+	static constexpr size_t s_noFrame = MAXSIZE_T;
+
+	StaticBatch::StaticBatch(size_t numTextureSlots, size_t instancingCutoff) : m_numVertices(0), 
+		m_numRemovedVertices(0), m_numDrawnEntries(0), m_numDrawnVertices(0), m_drawIndicesChanged(false), 
+		m_numTextureSlots(numTextureSlots), m_instancingCutoff(instancingCutoff), m_dirtyBegin(0), 
+		m_dirtyEnd(0), m_needsFullUpload(false), m_lastUsedFrame(s_noFrame), m_lastRenderedFrame(s_noFrame)
+	{
+		m_vertexBuffer = VertexBuffer::Create(0);
+		m_vertexBuffer->Bind();
+		m_vertexBuffer->SetLayout(GetBatchLayout());
+		m_indexBuffer = IndexBuffer::Create();
+	}
+
+	void StaticBatch::Update(DrawCommand* const* commands, size_t count, size_t frame, 
+		ADynArr<DrawCommand*>& outRemaining)
+	{
+		AE_PROFILE_FUNCTION();
+		size_t previousFrame = m_lastUsedFrame;
+		m_lastUsedFrame = frame;
+		m_commandsToAdd.Clear();
+
+		size_t runStart = 0;
+		while (runStart < count)
+		{
+			MeshHandle mesh = commands[runStart]->GetMesh();
+			size_t runEnd = runStart + 1;
+			while (runEnd < count && commands[runEnd]->GetMesh() == mesh)
+			{
+				runEnd++;
+			}
+
+			/*runs long enough to be instanced and meshes split in clusters (culled cluster by cluster) 
+			  are cheaper to draw through the dynamic path
+			*/
+			ResourceView<Mesh> meshData = ResourceHandler::BorrowMesh(mesh);
+			bool canBeRetained = runEnd - runStart < m_instancingCutoff && meshData != nullptr 
+				&& meshData->GetClusters().IsEmpty();
+
+			for (size_t i = runStart; i < runEnd; i++)
+			{
+				DrawCommand* cmd = commands[i];
+				if (!canBeRetained || !cmd->IsOpaque() || cmd->GetEntity() == NullEntity)
+				{
+					outRemaining.Add(cmd);
+					continue;
+				}
+
+				IDType entity = ToIntegral(cmd->GetEntity().GetID());
+				if (!m_entryIndices.ContainsKey(entity))
+				{
+					m_commandsToAdd.Add(cmd);
+					continue;
+				}
+
+				//entries which changed mesh (LOD switch or asynchronous load) are added back with the new one
+				Entry& entry = m_entries[m_entryIndices[entity]];
+				if (entry.mesh != mesh || entry.meshData != meshData.Get())
+				{
+					RemoveEntry(entry);
+					m_commandsToAdd.Add(cmd);
+					continue;
+				}
+
+				if (entry.texture != cmd->GetTexture())
+				{
+					int textureIndex = GetTextureIndex(cmd->GetTexture());
+					if (textureIndex == -1)
+					{
+						outRemaining.Add(cmd);
+						continue;
+					}
+					ReleaseTextureIndex(entry.textureIndex);
+					entry.texture = cmd->GetTexture();
+					entry.textureIndex = textureIndex;
+					WriteVertices(entry, cmd);
+				}
+				/*the version is compared rather than Transform::HasChanged since the entity may have 
+				  moved during the frames it was not drawn (culled, hidden, drawn by another camera...)
+				*/
+				else if (entry.transformVersion != cmd->GetTransformVersion() || !(entry.color == cmd->GetColor()))
+				{
+					WriteVertices(entry, cmd);
+				}
+				entry.color = cmd->GetColor();
+				entry.transformVersion = cmd->GetTransformVersion();
+
+				//the entry was not drawn by the previous update
+				if (entry.lastUsedFrame != previousFrame && entry.lastUsedFrame != frame)
+				{
+					m_drawIndicesChanged = true;
+				}
+				entry.lastUsedFrame = frame;
+			}
+			runStart = runEnd;
+		}
+
+		for (DrawCommand* cmd : m_commandsToAdd)
+		{
+			if (!AddEntry(cmd, frame))
+			{
+				outRemaining.Add(cmd);
+			}
+		}
+
+		size_t numDrawnEntries = 0;
+		for (Entry& entry : m_entries)
+		{
+			if (!entry.isAlive)
+			{
+				continue;
+			}
+
+			if (entry.lastUsedFrame == frame)
+			{
+				numDrawnEntries++;
+			}
+			else if (frame - entry.lastUsedFrame > s_unusedFrameLimit)
+			{
+				RemoveEntry(entry);
+			}
+		}
+
+		//every entry drawn now was either drawn before or flagged, so a smaller count means some stopped being drawn
+		if (numDrawnEntries != m_numDrawnEntries)
+		{
+			m_drawIndicesChanged = true;
+		}
+
+		if (m_numRemovedVertices > 0 && m_numRemovedVertices * 2 >= m_numVertices)
+		{
+			Compact();
+		}
+
+		if (m_drawIndicesChanged)
+		{
+			BuildDrawIndices(frame);
+		}
+
+		Upload();
+	}
+
+	void StaticBatch::Render(size_t frame)
+	{
+		if (m_drawIndices.IsEmpty() || m_lastRenderedFrame == frame)
+		{
+			return;
+		}
+		m_lastRenderedFrame = frame;
+
+		for (size_t i = 0; i < m_textures.GetCount(); i++)
+		{
+			if (m_textureUsers[i] == 0)
+			{
+				continue;
+			}
+
+			ResourceView<Texture2D> texture = ResourceHandler::BorrowTexture2D(m_textures[i]);
+			AE_RENDER_ASSERT(texture != nullptr, "");
+			texture->Bind((unsigned int)i);
+		}
+
+		m_vertexBuffer->Bind();
+		m_indexBuffer->Bind();
+		RenderCommand::DrawIndexed(m_indexBuffer);
+
+		// update stats
+		Renderer::s_stats.numIndices += m_drawIndices.GetCount();
+		Renderer::s_stats.numVertices += m_numDrawnVertices;
+		Renderer::s_stats.numDrawCalls++;
+	}
+
+	size_t StaticBatch::GetLastUsedFrame() const { return m_lastUsedFrame; }
+
+	bool StaticBatch::AddEntry(DrawCommand* cmd, size_t frame)
+	{
+		ResourceView<Mesh> mesh = ResourceHandler::BorrowMesh(cmd->GetMesh());
+		AE_RENDER_ASSERT(mesh != nullptr, "");
+
+		int textureIndex = GetTextureIndex(cmd->GetTexture());
+		if (textureIndex == -1)
+		{
+			return false;
+		}
+
+		Entry entry;
+		entry.entity = ToIntegral(cmd->GetEntity().GetID());
+		entry.mesh = cmd->GetMesh();
+		entry.meshData = mesh.Get();
+		entry.texture = cmd->GetTexture();
+		entry.textureIndex = textureIndex;
+		entry.color = cmd->GetColor();
+		entry.transformVersion = cmd->GetTransformVersion();
+		entry.firstVertex = m_numVertices;
+		entry.numVertices = mesh->GetPositions().GetCount();
+		entry.firstIndex = m_indices.GetCount();
+		entry.numIndices = mesh->GetIndices().GetCount();
+		entry.lastUsedFrame = frame;
+		entry.isAlive = true;
+
+		//the vertex buffer grows geometrically so adding entities usually only uploads their own vertices
+		if (m_numVertices + entry.numVertices > m_vertices.GetCount())
+		{
+			m_vertices.Resize((std::max)(m_vertices.GetCount() * 2, m_numVertices + entry.numVertices));
+			m_needsFullUpload = true;
+		}
+		m_numVertices += entry.numVertices;
+
+		const ADynArr<unsigned int>& indices = mesh->GetIndices();
+		m_indices.ResizeUninitialized(entry.firstIndex + entry.numIndices);
+		for (size_t i = 0; i < entry.numIndices; i++)
+		{
+			m_indices[entry.firstIndex + i] = (unsigned int)entry.firstVertex + indices[i];
+		}
+
+		WriteVertices(entry, cmd);
+		m_entryIndices[entry.entity] = m_entries.GetCount();
+		m_entries.Add(entry);
+		m_drawIndicesChanged = true;
+		return true;
+	}
+
+	/*the vertices of the entry stay in the buffers until the batch is compacted, the draw indices are
+	  rebuilt by Update when the entry was drawn since it is not counted as drawn anymore
+	*/
+	void StaticBatch::RemoveEntry(Entry& entry)
+	{
+		entry.isAlive = false;
+		m_entryIndices.Remove(entry.entity);
+		ReleaseTextureIndex(entry.textureIndex);
+		m_numRemovedVertices += entry.numVertices;
+	}
+
+	void StaticBatch::WriteVertices(const Entry& entry, const DrawCommand* cmd)
+	{
+		ResourceView<Mesh> mesh = ResourceHandler::BorrowMesh(entry.mesh);
+		AE_RENDER_ASSERT(mesh != nullptr, "");
+		const ADynArr<Vector3>& positions = mesh->GetPositions();
+		const ADynArr<Vector3>& normals = mesh->GetNormals();
+		const ADynArr<Vector2>& textureCoords = mesh->GetTextureCoords();
+
+		BatchedVertexData* vertices = &m_vertices[entry.firstVertex];
+		for (size_t i = 0; i < entry.numVertices; i++)
+		{
+			vertices[i].vertex.position = positions[i];
+			vertices[i].vertex.normal = normals[i];
+			vertices[i].vertex.textureCoords = textureCoords[i];
+			vertices[i].instance.transform = cmd->GetTransform();
+			vertices[i].instance.color = cmd->GetColor();
+			vertices[i].instance.textureIndex = (float)entry.textureIndex;
+		}
+		MarkDirty(entry.firstVertex, entry.firstVertex + entry.numVertices);
+	}
+
+	void StaticBatch::MarkDirty(size_t begin, size_t end)
+	{
+		if (m_dirtyBegin == m_dirtyEnd)
+		{
+			m_dirtyBegin = begin;
+			m_dirtyEnd = end;
+		}
+		else
+		{
+			m_dirtyBegin = Math::Min(m_dirtyBegin, begin);
+			m_dirtyEnd = Math::Max(m_dirtyEnd, end);
+		}
+	}
+
+	/*moves the entries still alive over the space left by the removed ones, the entries before 
+	  the first hole keep their place so only the vertices after it are uploaded again
+	*/
+	void StaticBatch::Compact()
+	{
+		size_t numEntries = 0;
+		size_t numVertices = 0;
+		size_t numIndices = 0;
+		for (size_t i = 0; i < m_entries.GetCount(); i++)
+		{
+			Entry entry = m_entries[i];
+			if (!entry.isAlive)
+			{
+				continue;
+			}
+
+			if (entry.firstVertex != numVertices || entry.firstIndex != numIndices)
+			{
+				for (size_t j = 0; j < entry.numVertices; j++)
+				{
+					m_vertices[numVertices + j] = m_vertices[entry.firstVertex + j];
+				}
+
+				for (size_t j = 0; j < entry.numIndices; j++)
+				{
+					m_indices[numIndices + j] = m_indices[entry.firstIndex + j] 
+						- (unsigned int)entry.firstVertex + (unsigned int)numVertices;
+				}
+
+				if (entry.firstVertex != numVertices)
+				{
+					MarkDirty(numVertices, numVertices + entry.numVertices);
+				}
+				entry.firstVertex = numVertices;
+				entry.firstIndex = numIndices;
+			}
+
+			numVertices += entry.numVertices;
+			numIndices += entry.numIndices;
+
+			m_entries[numEntries] = entry;
+			m_entryIndices[entry.entity] = numEntries;
+			numEntries++;
+		}
+
+		m_entries.Resize(numEntries);
+		m_indices.Resize(numIndices);
+		m_numVertices = numVertices;
+		m_numRemovedVertices = 0;
+		m_drawIndicesChanged = true;
+	}
+
+	// the index buffer only holds the indices of the entries drawn this frame
+	void StaticBatch::BuildDrawIndices(size_t frame)
+	{
+		m_drawIndices.Clear();
+		m_numDrawnEntries = 0;
+		m_numDrawnVertices = 0;
+		for (const Entry& entry : m_entries)
+		{
+			if (!entry.isAlive || entry.lastUsedFrame != frame)
+			{
+				continue;
+			}
+
+			size_t first = m_drawIndices.GetCount();
+			m_drawIndices.ResizeUninitialized(first + entry.numIndices);
+			memcpy(m_drawIndices.GetData() + first, m_indices.GetData() + entry.firstIndex, 
+				sizeof(unsigned int) * entry.numIndices);
+			m_numDrawnEntries++;
+			m_numDrawnVertices += entry.numVertices;
+		}
+	}
+
+	void StaticBatch::Upload()
+	{
+		// the index buffer is bound to the vertex array which is currently bound
+		m_vertexBuffer->Bind();
+		if (m_needsFullUpload)
+		{
+			m_vertexBuffer->SetData(m_vertices.GetData(), (unsigned int)(sizeof(BatchedVertexData) * m_vertices.GetCount()));
+			Renderer::s_stats.numBytesUploaded += sizeof(BatchedVertexData) * m_vertices.GetCount();
+		}
+		else if (m_dirtyBegin < m_dirtyEnd)
+		{
+			// setting data at offset 0 resizes the buffer so the range has to cover the whole batch
+			if (m_dirtyBegin == 0)
+			{
+				m_dirtyEnd = m_vertices.GetCount();
+			}
+
+			m_vertexBuffer->SetData(&m_vertices[m_dirtyBegin], 
+				(unsigned int)(sizeof(BatchedVertexData) * (m_dirtyEnd - m_dirtyBegin)),
+				(unsigned int)(sizeof(BatchedVertexData) * m_dirtyBegin));
+			Renderer::s_stats.numBytesUploaded += sizeof(BatchedVertexData) * (m_dirtyEnd - m_dirtyBegin);
+		}
+
+		if (m_drawIndicesChanged)
+		{
+			m_indexBuffer->SetData(m_drawIndices.GetData(), (unsigned int)m_drawIndices.GetCount());
+			Renderer::s_stats.numBytesUploaded += sizeof(unsigned int) * m_drawIndices.GetCount();
+		}
+
+		m_needsFullUpload = false;
+		m_drawIndicesChanged = false;
+		m_dirtyBegin = 0;
+		m_dirtyEnd = 0;
+	}
+
+	int StaticBatch::GetTextureIndex(Texture2DHandle texture)
+	{
+		if (texture == NullHandle)
+		{
+			return -2;
+		}
+
+		int freeSlot = -1;
+		for (size_t i = 0; i < m_textures.GetCount(); i++)
+		{
+			if (m_textures[i] == texture)
+			{
+				m_textureUsers[i]++;
+				return (int)i;
+			}
+
+			if (freeSlot == -1 && m_textureUsers[i] == 0)
+			{
+				freeSlot = (int)i;
+			}
+		}
+
+		if (freeSlot != -1)
+		{
+			m_textures[freeSlot] = texture;
+			m_textureUsers[freeSlot] = 1;
+			return freeSlot;
+		}
+
+		if (m_textures.GetCount() >= m_numTextureSlots)
+		{
+			return -1;
+		}
+
+		m_textures.Add(texture);
+		m_textureUsers.Add(1);
+		return (int)m_textures.GetCount() - 1;
+	}
+
+	void StaticBatch::ReleaseTextureIndex(int textureIndex)
+	{
+		if (textureIndex >= 0)
+		{
+			m_textureUsers[textureIndex]--;
+		}
+	}
+
 	// DrawDataBuffer ////////////////////////////////////////////////////
 
+	// per instance attributes, they follow the attributes of VertexData in the vertex array of the mesh
+	static const size_t s_instanceLayoutOffset = 3;
+
+	static const VertexBufferLayout& GetInstanceLayout()
+	{
+		static VertexBufferLayout layout = {
+			{ ADataType::Mat4, "transform", false, 1 },
+			{ ADataType::Float4, "color", false, 1 },
+			{ ADataType::Float, "textureIndex", false, 1 }
+		};
+		return layout;
+	}
+
 	size_t DrawDataBuffer::s_maxNumVertex = 0;
 	size_t DrawDataBuffer::s_maxNumIndices;
 	size_t DrawDataBuffer::s_numTextureSlots;
@@ -129,6 +582,8 @@ namespace AstralEngine
 		m_batchDataArr = nullptr;
 		m_batchIndicesArr = nullptr;
 		m_batchTextureSlots = nullptr;
+		m_instancingTextureSlots = nullptr;
+		m_frame = 0;
 	}
 
 	DrawDataBuffer::~DrawDataBuffer()
@@ -136,14 +591,18 @@ namespace AstralEngine
 		delete[] m_batchDataArr;
 		delete[] m_batchIndicesArr;
 		delete[] m_batchTextureSlots;
+		delete[] m_instancingTextureSlots;
 	}
 
 	void DrawDataBuffer::Initialize()
 	{
 		if (s_maxNumVertex == 0)
 		{
-			s_maxNumVertex = RenderCommand::GetMaxNumVertices();
-			s_maxNumIndices = RenderCommand::GetMaxNumIndices();
+			/*the limits of the api are only a performance hint, the batch is made large enough 
+			  to hold any cluster of a mesh so every mesh can be batched
+			*/
+			s_maxNumVertex = (std::max)(RenderCommand::GetMaxNumVertices(), Mesh::s_maxClusterVertices);
+			s_maxNumIndices = (std::max)(RenderCommand::GetMaxNumIndices(), Mesh::s_maxClusterTriangles * 3);
 			s_numTextureSlots = RenderCommand::GetNumTextureSlots();
 		}
 
@@ -152,14 +611,7 @@ namespace AstralEngine
 		m_batchIndices = IndexBuffer::Create();
 
 		m_batchBuffer->Bind();
-		m_batchBuffer->SetLayout({ 
-			{ ADataType::Float3, "position" },
-			{ ADataType::Float3, "normal" },
-			{ ADataType::Float2, "textureCoords" },
-			{ ADataType::Mat4, "transform" },
-			{ ADataType::Float4, "color" },
-			{ ADataType::Float, "textureIndex" }
-			});
+		m_batchBuffer->SetLayout(GetBatchLayout());
 
 		m_batchDataArr = new BatchedVertexData[s_maxNumVertex];
 		m_batchDataArrIndex = 0;
@@ -171,41 +623,26 @@ namespace AstralEngine
 		m_batchTextureSlotIndex = 0;
 		m_hasBatchedData = false;
 
-		// Instancing
-		m_instancingBuffer = VertexBuffer::Create(s_maxNumVertex * sizeof(VertexData));
+		// Instancing, the instance array is linked to the vertex array of each mesh when it gets instanced
 		m_instancingArr = VertexBuffer::Create(s_maxNumVertex * sizeof(InstanceVertexData), true);
 		m_instancingIndices = IndexBuffer::Create();
 
-		m_instancingBuffer->Bind();
-		m_instancingBuffer->SetLayout({
-			{ ADataType::Float3, "position" },
-			{ ADataType::Float3, "normal" },
-			{ ADataType::Float2, "textureCoords" }
-			});
-		
-
-		m_instancingArr->Bind();
-		m_instancingArr->SetLayout({
-			{ ADataType::Mat4, "transform", false, 1 },
-			{ ADataType::Float4, "color", false, 1 },
-			{ ADataType::Float, "textureIndex", false, 1 }
-			}, 3);
-
 		m_instancingTextureSlots = new Texture2DHandle[s_numTextureSlots];
 		m_instancingTextureSlotIndex = 0;
 	}
 
-	void DrawDataBuffer::Draw(const Mat4& viewProj, MaterialHandle material)
+	void DrawDataBuffer::Draw(const Mat4& viewProj, MaterialHandle material, 
+		DrawCommand* const* commands, size_t count)
 	{
-		if (IsEmpty())
+		if (count == 0)
 		{
 			return;
 		}
 
-		AReference<Material> mat = ResourceHandler::GetMaterial(material);
+		ResourceView<Material> mat = ResourceHandler::BorrowMaterial(material);
 		AE_RENDER_ASSERT(mat != nullptr, "");
 
-		AReference<Shader> shader = ResourceHandler::GetShader(mat->GetShader());
+		ResourceView<Shader> shader = ResourceHandler::BorrowShader(mat->GetShader());
 		AE_RENDER_ASSERT(shader != nullptr, "");
 
 		shader->Bind();
@@ -217,87 +654,83 @@ namespace AstralEngine
 			Renderer::BindGBufferTextures();
 		}
 
-		RenderGeometry(viewProj);
+		RenderGeometry(viewProj, commands, count);
 	}
 
-	void DrawDataBuffer::RenderGeometry(const Mat4& viewProj)
+	void DrawDataBuffer::RenderGeometry(const Mat4& viewProj, DrawCommand* const* commands, size_t count)
 	{
-		if (IsEmpty())
+		if (count == 0)
 		{
 			return;
 		}
 
-		for (auto& meshCommandPair : m_commandsToBatch)
+		m_frustum = Frustum(viewProj);
+
+		// the commands share the same material, the ones kept by the static batch do not need to be batched again
+		MaterialHandle material = commands[0]->GetMaterial();
+		if (!m_staticBatches.ContainsKey(material))
 		{
-			for (DrawCommand* cmd : meshCommandPair.GetElement())
-			{
-				AddToBatching(viewProj, cmd);
-			}
+			m_staticBatches.Add(material, AReference<StaticBatch>::Create(s_numTextureSlots, s_instancingCutoff));
 		}
 
-		RenderBatch(viewProj);
-		RenderInstancing(viewProj, m_commandsToInstance);
-	}
+		AReference<StaticBatch> staticBatch = m_staticBatches[material];
+		m_dynamicCommands.Clear();
+		staticBatch->Update(commands, count, m_frame, m_dynamicCommands);
+		staticBatch->Render(m_frame);
 
-	void DrawDataBuffer::AddDrawCommand(DrawCommand* draw)
-	{
-		AE_RENDER_ASSERT(draw->GetMesh() != NullHandle, "");
-		m_drawCommands.Add(draw);
-		if (m_meshUseCounts.ContainsKey(draw->GetMesh()))
-		{
-			m_meshUseCounts[draw->GetMesh()]++;
-		}
-		else
-		{
-			m_meshUseCounts.Add(draw->GetMesh(), 1);
-		}
+		commands = m_dynamicCommands.GetData();
+		count = m_dynamicCommands.GetCount();
 
-		size_t count = m_meshUseCounts[draw->GetMesh()];
-		if (count > s_instancingCutoff)
-		{
-			m_commandsToInstance[draw->GetMesh()].Add(draw);
-		}
-		else if (count == s_instancingCutoff)
+		size_t runStart = 0;
+		while (runStart < count)
 		{
-			m_commandsToInstance.Add(draw->GetMesh(), m_commandsToBatch[draw->GetMesh()]);
-			m_commandsToInstance[draw->GetMesh()].Add(draw);
-			m_commandsToBatch.Remove(draw->GetMesh());
-		}
-		else
-		{
-			m_commandsToBatch[draw->GetMesh()].Add(draw);
-		}
-	}
+			MeshHandle mesh = commands[runStart]->GetMesh();
+			AE_RENDER_ASSERT(mesh != NullHandle, "");
 
-	void DrawDataBuffer::Clear()
-	{
-		for (DrawCommand* cmd : m_drawCommands)
-		{
-			delete cmd;
+			size_t runEnd = runStart + 1;
+			while (runEnd < count && commands[runEnd]->GetMesh() == mesh)
+			{
+				runEnd++;
+			}
+
+			if (runEnd - runStart >= s_instancingCutoff)
+			{
+				// flush what was batched so far so the commands are drawn in order
+				RenderBatch(viewProj);
+				ClearBatching();
+				RenderMeshInstance(viewProj, mesh, &commands[runStart], runEnd - runStart);
+				ClearInstancing();
+			}
+			else
+			{
+				for (size_t i = runStart; i < runEnd; i++)
+				{
+					AddToBatching(viewProj, commands[i]);
+				}
+			}
+			runStart = runEnd;
 		}
 
-		m_drawCommands.Clear();
-		m_meshUseCounts.Clear();
-		m_commandsToBatch.Clear();
-		m_commandsToInstance.Clear();
+		RenderBatch(viewProj);
 		ClearBatching();
-		ClearInstancing();
 	}
 
-	bool DrawDataBuffer::IsEmpty() const { return m_drawCommands.IsEmpty(); }
-
-	void DrawDataBuffer::ReadVertexDataFromMesh(AReference<Mesh>& mesh, VertexData* vertexDataArr,
-		size_t dataOffset, size_t dataCount)
+	void DrawDataBuffer::EndFrame()
 	{
-		const ADynArr<Vector3>& positions = mesh->GetPositions();
-		const ADynArr<Vector3>& normals = mesh->GetNormals();
-		const ADynArr<Vector2>& textureCoords = mesh->GetTextureCoords();
-		for (size_t i = 0; i < positions.GetCount(); i++)
+		ASmallArr<MaterialHandle, 16> unusedMaterials;
+		for (AKeyElementPair<MaterialHandle, AReference<StaticBatch>>& pair : m_staticBatches)
 		{
-			vertexDataArr[dataOffset + i].position = positions[i];
-			vertexDataArr[dataOffset + i].textureCoords = textureCoords[i];
-			vertexDataArr[dataOffset + i].normal = normals[i];
+			if (m_frame - pair.GetElement()->GetLastUsedFrame() > StaticBatch::s_unusedFrameLimit)
+			{
+				unusedMaterials.Add(pair.GetKey());
+			}
+		}
+
+		for (MaterialHandle material : unusedMaterials)
+		{
+			m_staticBatches.Remove(material);
 		}
+		m_frame++;
 	}
 
 	int DrawDataBuffer::GetTextureIndex(Texture2DHandle* arr, size_t& index, Texture2DHandle texture)
@@ -330,84 +763,38 @@ namespace AstralEngine
 	{
 		for (size_t i = 0; i < index; i++)
 		{
-			AReference<Texture2D> texture = ResourceHandler::GetTexture2D(arr[i]);
+			ResourceView<Texture2D> texture = ResourceHandler::BorrowTexture2D(arr[i]);
 			AE_RENDER_ASSERT(texture != nullptr, "");
 			texture->Bind((unsigned int)i);
 		}
 	}
 
-	size_t DrawDataBuffer::ComputeDrawCallSize()
-	{
-		// make sure numVertex is a multiple of 3 since we are drawing triangles
-		size_t maxVertexSize = s_maxNumVertex - (s_maxNumVertex % 3);
-		size_t maxIndexSize = s_maxNumIndices - (s_maxNumIndices % 3);
-
-		return Math::Min(maxVertexSize, maxIndexSize);
-	}
-
 	void DrawDataBuffer::AddToBatching(const Mat4& viewProj, DrawCommand* cmd)
 	{
-		AReference<Mesh> mesh = ResourceHandler::GetMesh(cmd->GetMesh());
+		ResourceView<Mesh> mesh = ResourceHandler::BorrowMesh(cmd->GetMesh());
 		AE_RENDER_ASSERT(mesh != nullptr, "");
-		const ADynArr<Vector3>& positions = mesh->GetPositions();
-		const ADynArr<Vector3>& normals = mesh->GetNormals();
-		const ADynArr<Vector2>& textureCoords = mesh->GetTextureCoords();
-		const ADynArr<unsigned int>& indices = mesh->GetIndices();
-		int textureIndex = GetTextureIndex(m_batchTextureSlots, m_batchTextureSlotIndex, cmd->GetTexture());
 
-		if (textureIndex == -1)
+		// meshes which do not fit in a single cluster are batched cluster by cluster
+		if (!mesh->GetClusters().IsEmpty())
 		{
-			RenderBatch(viewProj);
-			ClearBatching();
-			textureIndex = GetTextureIndex(m_batchTextureSlots, m_batchTextureSlotIndex, cmd->GetTexture());
+			AddClustersToBatching(viewProj, *mesh.Get(), cmd);
+			return;
 		}
 
-		if (positions.GetCount() >= s_maxNumVertex || indices.GetCount() >= s_maxNumIndices)
-		//if (true)
-		{
-			// split up mesh for render here
-			size_t numVertices = positions.GetCount();
-			BatchedVertexData* vertexDataArr = new BatchedVertexData[numVertices];
-
-
-			for (size_t i = 0; i < numVertices; i++)
-			{
-				vertexDataArr[i].vertex.position = positions[i];
-				vertexDataArr[i].vertex.normal = normals[i];
-				vertexDataArr[i].vertex.textureCoords = textureCoords[i];
-				vertexDataArr[i].instance.color = cmd->GetColor();
-				vertexDataArr[i].instance.transform = cmd->GetTransform();
-				vertexDataArr[i].instance.textureIndex = (float)textureIndex;
-			}
-
-			size_t drawCallSize = ComputeDrawCallSize();
-			//drawCallSize = 3; // temp
-			size_t offset = 0;
-			size_t currDrawSize = indices.GetCount();
-			while (offset < indices.GetCount())
-			{
-				RenderBatch(viewProj);
-				ClearBatching();
-
-				currDrawSize = Math::Min(drawCallSize, indices.GetCount() - offset);
-				BatchRenderMeshSection(vertexDataArr, numVertices, indices, offset, currDrawSize);
-				offset += currDrawSize;
-				m_hasBatchedData = true;
-			}
-
-			m_batchDataArrIndex = currDrawSize;
-			m_batchIndicesArrIndex = currDrawSize;
-
-			delete[] vertexDataArr;
-			return;
+		const ADynArr<Vector3>& positions = mesh->GetPositions();
+		const ADynArr<Vector3>& normals = mesh->GetNormals();
+		const ADynArr<Vector2>& textureCoords = mesh->GetTextureCoords();
+		const ADynArr<unsigned int>& indices = mesh->GetIndices();
+		AE_RENDER_ASSERT(positions.GetCount() <= s_maxNumVertex && indices.GetCount() <= s_maxNumIndices, 
+			"Mesh too large to be batched");
 
-		}
-		else if (m_batchDataArrIndex + positions.GetCount() >= s_maxNumVertex 
-			|| m_batchIndicesArrIndex + indices.GetCount() >= s_maxNumIndices )
+		if (m_batchDataArrIndex + positions.GetCount() > s_maxNumVertex 
+			|| m_batchIndicesArrIndex + indices.GetCount() > s_maxNumIndices)
 		{
 			RenderBatch(viewProj);
 			ClearBatching();
 		}
+		int textureIndex = GetBatchTextureIndex(viewProj, cmd->GetTexture());
 
 		for (size_t i = 0; i < positions.GetCount(); i++)
 		{
@@ -429,6 +816,87 @@ namespace AstralEngine
 		m_hasBatchedData = true;
 	}
 
+	void DrawDataBuffer::AddClustersToBatching(const Mat4& viewProj, const Mesh& mesh, DrawCommand* cmd)
+	{
+		const ADynArr<MeshCluster>& clusters = mesh.GetClusters();
+		const Mat4& transform = cmd->GetTransform();
+
+		Vector3 center;
+		float radius;
+		Frustum::TransformSphere(transform, mesh.GetBoundsCenter(), mesh.GetBoundsRadius(), center, radius);
+		if (!m_frustum.Intersects(center, radius))
+		{
+			Renderer::s_stats.numCulledClusters += (unsigned int)clusters.GetCount();
+			return;
+		}
+
+		// the clusters of a mesh entirely in view do not need to be tested
+		bool cullClusters = !m_frustum.Contains(center, radius);
+
+		const ADynArr<Vector3>& positions = mesh.GetPositions();
+		const ADynArr<Vector3>& normals = mesh.GetNormals();
+		const ADynArr<Vector2>& textureCoords = mesh.GetTextureCoords();
+		const unsigned int* clusterVertices = mesh.GetClusterVertices().GetData();
+		const unsigned short* clusterIndices = mesh.GetClusterIndices().GetData();
+		int textureIndex = GetBatchTextureIndex(viewProj, cmd->GetTexture());
+
+		for (const MeshCluster& cluster : clusters)
+		{
+			if (cullClusters)
+			{
+				Frustum::TransformSphere(transform, cluster.boundsCenter, cluster.boundsRadius, center, radius);
+				if (!m_frustum.Intersects(center, radius))
+				{
+					Renderer::s_stats.numCulledClusters++;
+					continue;
+				}
+			}
+
+			if (m_batchDataArrIndex + cluster.numVertices > s_maxNumVertex
+				|| m_batchIndicesArrIndex + cluster.numIndices > s_maxNumIndices)
+			{
+				RenderBatch(viewProj);
+				ClearBatching();
+				textureIndex = GetBatchTextureIndex(viewProj, cmd->GetTexture());
+			}
+
+			BatchedVertexData* vertexData = &m_batchDataArr[m_batchDataArrIndex];
+			const unsigned int* vertices = &clusterVertices[cluster.firstVertex];
+			for (size_t i = 0; i < cluster.numVertices; i++)
+			{
+				unsigned int vertex = vertices[i];
+				vertexData[i].vertex.position = positions[vertex];
+				vertexData[i].vertex.normal = normals[vertex];
+				vertexData[i].vertex.textureCoords = textureCoords[vertex];
+				vertexData[i].instance.transform = transform;
+				vertexData[i].instance.color = cmd->GetColor();
+				vertexData[i].instance.textureIndex = (float)textureIndex;
+			}
+
+			const unsigned short* indices = &clusterIndices[cluster.firstIndex];
+			for (size_t i = 0; i < cluster.numIndices; i++)
+			{
+				m_batchIndicesArr[m_batchIndicesArrIndex + i] = (unsigned int)m_batchDataArrIndex + indices[i];
+			}
+
+			m_batchDataArrIndex += cluster.numVertices;
+			m_batchIndicesArrIndex += cluster.numIndices;
+			m_hasBatchedData = true;
+		}
+	}
+
+	int DrawDataBuffer::GetBatchTextureIndex(const Mat4& viewProj, Texture2DHandle texture)
+	{
+		int textureIndex = GetTextureIndex(m_batchTextureSlots, m_batchTextureSlotIndex, texture);
+		if (textureIndex == -1)
+		{
+			RenderBatch(viewProj);
+			ClearBatching();
+			textureIndex = GetTextureIndex(m_batchTextureSlots, m_batchTextureSlotIndex, texture);
+		}
+		return textureIndex;
+	}
+
 	void DrawDataBuffer::RenderBatch(const Mat4& viewProj)
 	{
 		if (m_hasBatchedData)
@@ -437,8 +905,11 @@ namespace AstralEngine
 
 			m_batchBuffer->SetData(m_batchDataArr, sizeof(BatchedVertexData) * m_batchDataArrIndex);
 			m_batchIndices->SetData(m_batchIndicesArr, m_batchIndicesArrIndex);
+			Renderer::s_stats.numBytesUploaded += sizeof(BatchedVertexData) * m_batchDataArrIndex
+				+ sizeof(unsigned int) * m_batchIndicesArrIndex;
 
 			m_batchBuffer->Bind();
+			m_batchIndices->Bind();
 			RenderCommand::DrawIndexed(m_batchIndices);
 
 			// update stats
@@ -456,95 +927,34 @@ namespace AstralEngine
 		m_hasBatchedData = false;
 	}
 
-	void DrawDataBuffer::BatchRenderMeshSection(BatchedVertexData* vertexData, size_t numVertex,
-		const ADynArr<unsigned int>& indices, size_t dataOffset, size_t drawCallSize)
-	{
-		
-
-		unsigned int* indexArr = new unsigned int[drawCallSize];
-		BatchedVertexData* vertexDataArr = new BatchedVertexData[drawCallSize];
-
-		for (size_t i = 0; i < drawCallSize; i++)
-		{
-			unsigned int currIndex = indices[i + dataOffset];
-			AE_RENDER_ASSERT(currIndex < numVertex, "Index out of bounds");
-			vertexDataArr[i] = vertexData[currIndex];
-			indexArr[i] = i;
-		}
-
-		BindTextures(m_batchTextureSlots, m_batchTextureSlotIndex);
-
-		m_batchBuffer->Bind();
-		m_batchBuffer->SetData(vertexDataArr, sizeof(BatchedVertexData) * drawCallSize);
-
-		m_instancingIndices->Bind();
-		m_instancingIndices->SetData(indexArr, drawCallSize);
-		RenderCommand::DrawIndexed(m_instancingIndices);
-
-		delete[] indexArr;
-		delete[] vertexDataArr;
-
-		// update stats
-		Renderer::s_stats.numIndices += drawCallSize;
-		Renderer::s_stats.numVertices += drawCallSize;
-		Renderer::s_stats.numDrawCalls++;
-	}
-
-	void DrawDataBuffer::CollectMeshesToInstance(ASinglyLinkedList<MeshHandle>& toInstance)
-	{
-		for (auto& pair : m_meshUseCounts)
-		{
-			if (pair.GetElement() >= s_instancingCutoff)
-			{
-				toInstance.Add(pair.GetKey());
-			}
-		}
-	}
-
-	void DrawDataBuffer::RenderInstancing(const Mat4& viewProj, AUnorderedMap<MeshHandle,
-		ADynArr<DrawCommand*>>& commandsToInstance)
-	{
-		
-
-		for (auto& pair : commandsToInstance)
-		{
-			RenderMeshInstance(viewProj, pair.GetKey(), pair.GetElement());
-		}
-	}
-
 	void DrawDataBuffer::RenderMeshInstance(const Mat4& viewProj, MeshHandle mesh, 
-		ADynArr<DrawCommand*>& commands)
+		DrawCommand* const* commands, size_t count)
 	{
-		
-
-		if (commands.IsEmpty())
+		if (count == 0)
 		{
 			return;
 		}
 
-		AReference<Mesh> meshToInstance = ResourceHandler::GetMesh(mesh);
+		ResourceView<Mesh> meshToInstance = ResourceHandler::BorrowMesh(mesh);
 
 		AE_RENDER_ASSERT(meshToInstance != nullptr, "");
 
 		size_t numVertices = meshToInstance->GetPositions().GetCount();
-		VertexData* vertexDataArr = new VertexData[numVertices];
-		ReadVertexDataFromMesh(meshToInstance, vertexDataArr, 0, numVertices);
-		
-		const ADynArr<unsigned int>& indices = meshToInstance->GetIndices();
+		size_t numIndices = meshToInstance->GetIndices().GetCount();
 
-		InstanceVertexData* instanceData = new InstanceVertexData[commands.GetCount()];
+		// the geometry already lives on the gpu, only the per instance data has to be sent
+		InstanceVertexData* instanceData = Renderer::GetFrameAllocator().NewArray<InstanceVertexData>(count);
 		size_t index = 0;
 		size_t indexOffset = 0;
-		auto it = commands.begin();
 
-		while (index < commands.GetCount())
+		while (index < count)
 		{
 			int textureIndex;
 
-			for (; it != commands.end(); it++)
+			for (; index < count; index++)
 			{
-				DrawCommand* cmd = *it;
-				textureIndex = (float)GetTextureIndex(m_instancingTextureSlots,
+				DrawCommand* cmd = commands[index];
+				textureIndex = GetTextureIndex(m_instancingTextureSlots,
 					m_instancingTextureSlotIndex, cmd->GetTexture());
 
 				if (textureIndex == -1)
@@ -556,48 +966,22 @@ namespace AstralEngine
 				instanceData[index].transform = cmd->GetTransform();
 				instanceData[index].color = cmd->GetColor();
 				instanceData[index].textureIndex = (float)textureIndex;
-				index++;
 			}
 
-			if (numVertices < s_maxNumVertex)
-			//if (false)
-			{
-				size_t numInstancesToRender = index - indexOffset;
-				BindTextures(m_instancingTextureSlots, m_instancingTextureSlotIndex);
+			size_t numInstancesToRender = index - indexOffset;
+			BindTextures(m_instancingTextureSlots, m_instancingTextureSlotIndex);
 
-				m_instancingBuffer->Bind();
-				m_instancingBuffer->SetData(vertexDataArr, sizeof(VertexData) * numVertices);
+			m_instancingArr->SetData(&instanceData[indexOffset], 
+				sizeof(InstanceVertexData) * numInstancesToRender);
 
-				m_instancingIndices->Bind();
-				m_instancingIndices->SetData(indices.GetData(), indices.GetCount());
+			meshToInstance->BindForInstancing(m_instancingArr, GetInstanceLayout(), s_instanceLayoutOffset);
+			RenderCommand::DrawInstancedIndexed(meshToInstance->GetIndexBuffer(), numInstancesToRender);
 
-				m_instancingArr->Bind();
-				m_instancingArr->SetData(&instanceData[indexOffset], 
-					sizeof(InstanceVertexData) * numInstancesToRender);
-
-				m_instancingBuffer->Bind();
-				m_instancingIndices->Bind();
-				RenderCommand::DrawInstancedIndexed(m_instancingIndices, numInstancesToRender);
-
-				// update stats
-				Renderer::s_stats.numIndices += indices.GetCount() * numInstancesToRender;
-				Renderer::s_stats.numVertices += numVertices * numInstancesToRender;
-				Renderer::s_stats.numDrawCalls++;				
-			}
-			else
-			{
-				size_t drawCallSize = ComputeDrawCallSize();
-				drawCallSize = 3; // temp
-				size_t offset = 0;
-
-				while (offset < indices.GetCount())
-				{
-					size_t currDrawSize = Math::Min(drawCallSize, indices.GetCount() - offset);
-					InstanceRenderMeshSection(vertexDataArr, numVertices, indices, &instanceData[indexOffset],
-						index - indexOffset, offset, currDrawSize);
-					offset += currDrawSize;
-				}
-			}
+			// update stats
+			Renderer::s_stats.numIndices += numIndices * numInstancesToRender;
+			Renderer::s_stats.numVertices += numVertices * numInstancesToRender;
+			Renderer::s_stats.numBytesUploaded += sizeof(InstanceVertexData) * numInstancesToRender;
+			Renderer::s_stats.numDrawCalls++;
 
 			if (textureIndex == -1)
 			{
@@ -605,49 +989,6 @@ namespace AstralEngine
 				ClearInstancing();
 			}
 		}
-		delete[] instanceData;
-	}
-
-	void DrawDataBuffer::InstanceRenderMeshSection(VertexData* vertexData, size_t numVertex,
-		const ADynArr<unsigned int>& indices, InstanceVertexData* instanceData,
-		size_t numInstanceData, size_t dataOffset, size_t drawCallSize)
-	{
-		
-
-		AE_RENDER_ASSERT(drawCallSize > 0, "Invalid draw call size");
-		unsigned int* indexArr = new unsigned int[drawCallSize];
-		VertexData* vertexDataArr = new VertexData[drawCallSize];
-
-		for (size_t i = 0; i < drawCallSize; i++)
-		{
-			unsigned int currIndex = indices[i + dataOffset];
-			AE_RENDER_ASSERT(currIndex < numVertex, "Index out of bounds");
-			vertexDataArr[i] = vertexData[currIndex];
-			indexArr[i] = i;
-		}
-
-		BindTextures(m_instancingTextureSlots, m_instancingTextureSlotIndex);
-
-		m_instancingBuffer->Bind();
-		m_instancingBuffer->SetData(vertexDataArr, sizeof(VertexData) * drawCallSize);
-
-		m_instancingIndices->Bind();
-		m_instancingIndices->SetData(indexArr, drawCallSize);
-
-		m_instancingArr->Bind();
-		m_instancingArr->SetData(instanceData, sizeof(InstanceVertexData) * numInstanceData);
-
-		m_instancingBuffer->Bind();
-		m_instancingIndices->Bind();
-		RenderCommand::DrawInstancedIndexed(m_instancingIndices, numInstanceData);
-
-		delete[] indexArr;
-		delete[] vertexDataArr;
-
-		// update stats
-		Renderer::s_stats.numIndices += drawCallSize;
-		Renderer::s_stats.numVertices += drawCallSize;
-		Renderer::s_stats.numDrawCalls++;
 	}
 
 	void DrawDataBuffer::ClearInstancing()
@@ -656,73 +997,43 @@ namespace AstralEngine
 	}
 
 	
-	// RenderingDataSorter ////////////////////////////////////////////////////
+	// RenderQueue /////////////////////////////////////////////////////////////////////
 
-	void RenderingDataSorter::AddData(DrawCommand* data)
-	{
-		AE_RENDER_ASSERT(data != nullptr, "");
-		MaterialHandle mat = data->GetMaterial();
-		if (!m_buffers.ContainsKey(mat))
-		{
-			m_buffers.Add(mat, DrawDataBuffer());
-			m_buffers[mat].Initialize();
-		}
-		m_buffers[data->GetMaterial()].AddDrawCommand(data);
-	}
+	// see RenderQueue for the layout of the sort keys
+	static constexpr std::uint64_t s_transparentKeyBit = (std::uint64_t)1 << 63;
+	static constexpr unsigned int s_keyHandleBits = 16;
+	static constexpr unsigned int s_opaqueDepthBits = 15;
+	static constexpr unsigned int s_transparentDepthBits = 24;
 
-	void RenderingDataSorter::Clear()
+	// keeps the lowest numBits bits of the value and moves them to their position in the key
+	static std::uint64_t ComputeKeyField(std::uint64_t value, unsigned int numBits, unsigned int shift)
 	{
-		for (auto& pair : m_buffers)
-		{
-			pair.GetElement().Clear();
-		}
+		return (value & (((std::uint64_t)1 << numBits) - 1)) << shift;
 	}
 
-	bool RenderingDataSorter::IsEmpty() const
+	// depth of the origin of the transform remapped from normalized device coordinates to [0, 1]
+	static float ComputeNormalizedDepth(const Mat4& viewProj, const Mat4& transform)
 	{
-		if (m_buffers.GetCount() == 0)
-		{
-			return true;
-		}
-
-		for (auto& pair : m_buffers)
+		Vector4 clipPos = viewProj * transform[3];
+		if (clipPos.w <= 0.0f)
 		{
-			if (!pair.GetElement().IsEmpty())
-			{
-				return false;
-			}
+			// behind the camera
+			return 0.0f;
 		}
-		return true;
-	}
-
-	RenderingDataSorter::AIterator RenderingDataSorter::begin()
-	{
-		return m_buffers.begin();
-	}
 
-	RenderingDataSorter::AIterator RenderingDataSorter::end()
-	{
-		return m_buffers.end();
+		float depth = (clipPos.z / clipPos.w + 1.0f) * 0.5f;
+		return Math::Clamp(depth, 0.0f, 1.0f);
 	}
 
-	RenderingDataSorter::AConstIterator RenderingDataSorter::begin() const
+	static std::uint64_t QuantizeDepth(float depth, unsigned int numBits)
 	{
-		return m_buffers.begin();
+		return (std::uint64_t)(depth * (float)(((std::uint64_t)1 << numBits) - 1));
 	}
 
-	RenderingDataSorter::AConstIterator RenderingDataSorter::end() const
+	RenderQueue::RenderQueue(GBuffer* gBuffer) : m_gBuffer(gBuffer)
 	{
-		return m_buffers.end();
-	}
-
-	// RenderQueue /////////////////////////////////////////////////////////////////////
-	RenderQueue::RenderQueue(GBuffer* gBuffer) : m_gBuffer(gBuffer), m_transparent(nullptr)
-	{
-		if (gBuffer == nullptr)
-		{
-			m_transparent = new RenderingDataSorter();
-		}
-		else
+		m_drawBuffer.Initialize();
+		if (gBuffer != nullptr)
 		{
 			SetupFullscreenRenderingObjects();
 		}
@@ -740,109 +1051,213 @@ namespace AstralEngine
 
 	void RenderQueue::AddData(DrawCommand* data)
 	{
+		AE_RENDER_ASSERT(data != nullptr, "");
 		AE_CORE_ASSERT(data->UsesDeferred() == (m_gBuffer != nullptr), 
 			"Draw Command passed to the wrong render queue");
+		AE_CORE_ASSERT(!data->UsesDeferred() || data->IsOpaque(), 
+			"Deferred render queue does not support transparent material");
+
+		RenderItem item;
+		item.key = 0;
+		item.command = data;
+		m_items.Add(item);
+	}
 
-		if (data->UsesDeferred())
+	void RenderQueue::Draw(const Mat4& viewProj)
+	{
+		AE_PROFILE_FUNCTION();
+		ComputeSortKeys(viewProj);
+		SortItems();
+
+		if (m_gBuffer != nullptr)
 		{
-			AE_CORE_ASSERT(m_gBuffer != nullptr, "Draw Command passed to the wrong render queue");
-			AE_CORE_ASSERT(data->IsOpaque(), "Deferred render queue does not support transparent material");
-			m_opaque.AddData(data);
+			DrawDeferred(viewProj);
 		}
-		else 
+		else
 		{
-			if (data->IsOpaque())
+			DrawForward(viewProj);
+		}
+		m_drawBuffer.EndFrame();
+	}
+
+	void RenderQueue::Clear()
+	{
+		m_items.Clear();
+		m_sortedCommands.Clear();
+	}
+
+	void RenderQueue::ComputeSortKeys(const Mat4& viewProj)
+	{
+		AE_PROFILE_FUNCTION();
+
+		// commands tend to be submitted in runs using the same material so remember the last lookup
+		MaterialHandle lastMaterial = NullHandle;
+		ShaderHandle lastShader = NullHandle;
+
+		for (RenderItem& item : m_items)
+		{
+			const DrawCommand* cmd = item.command;
+			float depth = ComputeNormalizedDepth(viewProj, cmd->GetTransform());
+
+			if (cmd->IsOpaque())
 			{
-				m_opaque.AddData(data);
+				if (cmd->GetMaterial() != lastMaterial)
+				{
+					lastMaterial = cmd->GetMaterial();
+					ResourceView<Material> material = ResourceHandler::BorrowMaterial(lastMaterial);
+					lastShader = material == nullptr ? NullHandle : material->GetShader();
+				}
+
+				item.key = ComputeKeyField(lastShader, s_keyHandleBits, 47)
+					| ComputeKeyField(cmd->GetMaterial(), s_keyHandleBits, 31)
+					| ComputeKeyField(cmd->GetMesh(), s_keyHandleBits, 15)
+					| QuantizeDepth(depth, s_opaqueDepthBits);
 			}
 			else
 			{
-				m_transparent->AddData(data);
+				item.key = s_transparentKeyBit
+					| (QuantizeDepth(1.0f - depth, s_transparentDepthBits) << 39)
+					| ComputeKeyField(cmd->GetMaterial(), s_keyHandleBits, 23)
+					| ComputeKeyField(cmd->GetMesh(), s_keyHandleBits, 7);
 			}
 		}
 	}
 
-	void RenderQueue::Draw(const Mat4& viewProj)
+	// least significant digit radix sort, passes where every key has the same digit are skipped
+	void RenderQueue::SortItems()
 	{
-		if (m_gBuffer != nullptr)
+		AE_PROFILE_FUNCTION();
+		m_sortedCommands.Clear();
+
+		size_t count = m_items.GetCount();
+		if (count == 0)
 		{
-			Vector4 clearColor = RenderCommand::GetClearColor();
-			// deferred rendering
-			m_gBuffer->Bind();
-			RenderCommand::SetClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-			RenderCommand::Clear();
-			RenderCommand::EnableBlending(false);
+			return;
+		}
+
+		if (m_sortBuffer.GetCount() < count)
+		{
+			m_sortBuffer.Resize(count);
+		}
 
-			AReference<Shader> shader = m_gBuffer->PrepareForRender(viewProj);
+		RenderItem* src = m_items.GetData();
+		RenderItem* dst = m_sortBuffer.GetData();
 
-			for (auto& pair : m_opaque)
+		for (unsigned int shift = 0; shift < 64; shift += 8)
+		{
+			size_t offsets[256] = { };
+			for (size_t i = 0; i < count; i++)
 			{
-				AReference<Material> currMat = ResourceHandler::GetMaterial(pair.GetKey());
-				AE_RENDER_ASSERT(currMat != nullptr, "");
+				offsets[(src[i].key >> shift) & 0xFF]++;
+			}
 
-				Texture2DHandle diffuseMap = currMat->GetDiffuseMap();
-				Texture2DHandle specularMap = currMat->GetSpecularMap();
-				if (diffuseMap == NullHandle)
-				{
-					diffuseMap = Texture2D::WhiteTexture();
-				}
+			if (offsets[(src[0].key >> shift) & 0xFF] == count)
+			{
+				continue;
+			}
 
-				if (specularMap == NullHandle)
-				{
-					specularMap = Texture2D::WhiteTexture();
-				}
+			size_t total = 0;
+			for (size_t i = 0; i < 256; i++)
+			{
+				size_t digitCount = offsets[i];
+				offsets[i] = total;
+				total += digitCount;
+			}
 
-				Vector4 color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
-				if (currMat->HasColor())
-				{
-					color = currMat->GetColor();
-				}
+			for (size_t i = 0; i < count; i++)
+			{
+				dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+			}
+			std::swap(src, dst);
+		}
 
-				shader->SetFloat4("u_matColor", color);
+		for (size_t i = 0; i < count; i++)
+		{
+			m_sortedCommands.Add(src[i].command);
+		}
+	}
 
-				ResourceHandler::GetTexture2D(diffuseMap)->Bind();
-				ResourceHandler::GetTexture2D(specularMap)->Bind(1);
+	void RenderQueue::DrawForward(const Mat4& viewProj)
+	{
+		size_t first = 0;
+		while (first < m_sortedCommands.GetCount())
+		{
+			size_t last = FindMaterialRunEnd(first);
+			m_drawBuffer.Draw(viewProj, m_sortedCommands[first]->GetMaterial(), 
+				&m_sortedCommands[first], last - first);
+			first = last;
+		}
+	}
 
-				pair.GetElement().RenderGeometry(viewProj);
-			}
-			m_gBuffer->Unbind();
-			RenderCommand::EnableBlending(true);
-			RenderCommand::SetClearColor(clearColor);
-			RenderCommand::Clear();
+	void RenderQueue::DrawDeferred(const Mat4& viewProj)
+	{
+		Vector4 clearColor = RenderCommand::GetClearColor();
+		m_gBuffer->Bind();
+		RenderCommand::SetClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		RenderCommand::Clear();
+		RenderCommand::EnableBlending(false);
 
-			shader = ResourceHandler::GetShader(m_deferredShader);
-			shader->Bind();
-			Renderer::SendLightUniformsToShader(shader);
-			shader->SetFloat3("u_camPos", Renderer::GetCamPos());
-			m_gBuffer->BindTexureData();
+		AReference<Shader> shader = m_gBuffer->PrepareForRender(viewProj);
 
-			m_deferredVB->Bind();
-			m_deferredIB->Bind();
-			RenderCommand::DrawIndexed(m_deferredIB);
-			m_gBuffer->GetFramebuffer()->CopyTo(nullptr);
-		}
-		else
+		size_t first = 0;
+		while (first < m_sortedCommands.GetCount())
 		{
-			// forward rendering
-			for (auto& pair : m_opaque)
+			size_t last = FindMaterialRunEnd(first);
+			ResourceView<Material> currMat = ResourceHandler::BorrowMaterial(m_sortedCommands[first]->GetMaterial());
+			AE_RENDER_ASSERT(currMat != nullptr, "");
+
+			Texture2DHandle diffuseMap = currMat->GetDiffuseMap();
+			Texture2DHandle specularMap = currMat->GetSpecularMap();
+			if (diffuseMap == NullHandle)
+			{
+				diffuseMap = Texture2D::WhiteTexture();
+			}
+
+			if (specularMap == NullHandle)
 			{
-				pair.GetElement().Draw(viewProj, pair.GetKey());
+				specularMap = Texture2D::WhiteTexture();
 			}
 
-			for (auto& pair : *m_transparent)
+			Vector4 color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+			if (currMat->HasColor())
 			{
-				pair.GetElement().Draw(viewProj, pair.GetKey());
+				color = currMat->GetColor();
 			}
+
+			shader->SetFloat4("u_matColor", color);
+
+			ResourceHandler::BorrowTexture2D(diffuseMap)->Bind();
+			ResourceHandler::BorrowTexture2D(specularMap)->Bind(1);
+
+			m_drawBuffer.RenderGeometry(viewProj, &m_sortedCommands[first], last - first);
+			first = last;
 		}
+		m_gBuffer->Unbind();
+		RenderCommand::EnableBlending(true);
+		RenderCommand::SetClearColor(clearColor);
+		RenderCommand::Clear();
+
+		shader = ResourceHandler::GetShader(m_deferredShader);
+		shader->Bind();
+		Renderer::SendLightUniformsToShader(shader);
+		shader->SetFloat3("u_camPos", Renderer::GetCamPos());
+		m_gBuffer->BindTexureData();
+
+		m_deferredVB->Bind();
+		m_deferredIB->Bind();
+		RenderCommand::DrawIndexed(m_deferredIB);
+		m_gBuffer->GetFramebuffer()->CopyTo(nullptr);
 	}
 
-	void RenderQueue::Clear()
+	size_t RenderQueue::FindMaterialRunEnd(size_t first) const
 	{
-		m_opaque.Clear();
-		if (m_transparent != nullptr)
+		MaterialHandle material = m_sortedCommands[first]->GetMaterial();
+		size_t last = first + 1;
+		while (last < m_sortedCommands.GetCount() && m_sortedCommands[last]->GetMaterial() == material)
 		{
-			m_transparent->Clear();
+			last++;
 		}
+		return last;
 	}
 
 	void RenderQueue::BindGBufferTextureData() { m_gBuffer->BindTexureData(); }
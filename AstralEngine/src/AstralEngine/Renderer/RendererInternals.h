@@ -3,6 +3,7 @@
 #include "AstralEngine/ECS/AEntity.h"
 #include "Renderer.h"
 #include "Framebuffer.h"
+#include "Frustum.h"
 
 
 namespace AstralEngine
@@ -18,7 +19,8 @@ namespace AstralEngine
 	public:
 		DrawCommand();
 		DrawCommand(const Mat4& transform, MaterialHandle mat, MeshHandle mesh, 
-			const Vector4& color, const AEntity e, bool opaque, Texture2DHandle texture = NullHandle);
+			const Vector4& color, const AEntity e, bool opaque, Texture2DHandle texture = NullHandle,
+			unsigned int transformVersion = 0);
 
 		const Mat4& GetTransform() const;
 		MaterialHandle GetMaterial() const;
@@ -29,6 +31,9 @@ namespace AstralEngine
 		bool IsOpaque() const;
 		bool UsesDeferred() const;
 
+		// matrix version of the transform of the entity (see Transform::GetMatrixVersion)
+		unsigned int GetTransformVersion() const;
+
 		bool operator==(const DrawCommand& other) const;
 		bool operator!=(const DrawCommand& other) const;
 
@@ -40,6 +45,7 @@ namespace AstralEngine
 		AEntity m_entity;
 		Texture2DHandle m_texture;
 		bool m_opaque;
+		unsigned int m_transformVersion;
 	};
 
 
@@ -61,9 +67,103 @@ namespace AstralEngine
 		AReference<Framebuffer> m_framebuffer;
 	};
 
-	// class responsible for handling draw calls by either batching them or instanciating them
-	// additionally this class will keep track of what transforms matrix have not changed since 
-	// last frame and will only update matrices which have changed
+	/* retained batch of the opaque draw commands of entities which use the same material
+
+	   the vertices of every entity are kept between frames in buffers owned by the batch so only 
+	   the vertices of the entities whose transform, color or texture changed are rewritten and 
+	   uploaded. Only the commands the dynamic path would batch are retained, runs long enough to 
+	   be instanced and meshes split in clusters are left to it.
+
+	   entities which are not drawn in a frame (culled, hidden...) keep their vertices for 
+	   s_unusedFrameLimit frames and are only left out of the index buffer. Removed entities leave 
+	   a hole which is filled once holes make up half of the batch, only the vertices which moved 
+	   are uploaded again, so scenes made mostly of static geometry are almost free to batch
+	*/
+	class StaticBatch sealed
+	{
+	public:
+		StaticBatch(size_t numTextureSlots, size_t instancingCutoff);
+
+		// updates the batch with the commands provided, commands which cannot be batched are added to outRemaining
+		void Update(DrawCommand* const* commands, size_t count, size_t frame, ADynArr<DrawCommand*>& outRemaining);
+
+		// renders the batch using whichever shader is currently bound, the batch is drawn at most once per frame
+		void Render(size_t frame);
+
+		size_t GetLastUsedFrame() const;
+
+		// number of frames an entity, or a whole batch, is kept after it was last drawn
+		static constexpr size_t s_unusedFrameLimit = 120;
+
+	private:
+		struct Entry
+		{
+			IDType entity;
+			MeshHandle mesh;
+			const Mesh* meshData;
+			Texture2DHandle texture;
+			int textureIndex;
+			Vector4 color;
+			unsigned int transformVersion;
+			size_t firstVertex;
+			size_t numVertices;
+			size_t firstIndex;
+			size_t numIndices;
+			size_t lastUsedFrame;
+			bool isAlive;
+		};
+
+		bool AddEntry(DrawCommand* cmd, size_t frame);
+		void RemoveEntry(Entry& entry);
+		void WriteVertices(const Entry& entry, const DrawCommand* cmd);
+		void MarkDirty(size_t begin, size_t end);
+		void Compact();
+		void BuildDrawIndices(size_t frame);
+		void Upload();
+
+		// returns -1 if there is no more available texture slots and -2 if no texture is used
+		int GetTextureIndex(Texture2DHandle texture);
+		void ReleaseTextureIndex(int textureIndex);
+
+		ADynArr<Entry> m_entries;
+		AUnorderedMap<IDType, size_t> m_entryIndices;
+		ADynArr<DrawCommand*> m_commandsToAdd;
+
+		// as large as the vertex buffer, the entries use the first m_numVertices
+		ADynArr<BatchedVertexData> m_vertices;
+		size_t m_numVertices;
+		size_t m_numRemovedVertices;
+
+		// indices of every entry, m_drawIndices only holds the ones of the entries drawn this frame
+		ADynArr<unsigned int> m_indices;
+		ADynArr<unsigned int> m_drawIndices;
+		size_t m_numDrawnEntries;
+		size_t m_numDrawnVertices;
+		bool m_drawIndicesChanged;
+
+		// a slot is reused once no entry uses its texture anymore so the index of the others never changes
+		ADynArr<Texture2DHandle> m_textures;
+		ADynArr<size_t> m_textureUsers;
+		size_t m_numTextureSlots;
+		size_t m_instancingCutoff;
+
+		AReference<VertexBuffer> m_vertexBuffer;
+		AReference<IndexBuffer> m_indexBuffer;
+
+		// range of vertices to upload, the whole batch is uploaded when its size changed
+		size_t m_dirtyBegin;
+		size_t m_dirtyEnd;
+		bool m_needsFullUpload;
+
+		size_t m_lastUsedFrame;
+		size_t m_lastRenderedFrame;
+	};
+
+	/* renders runs of draw commands which share the same material, the commands are expected to be 
+	   sorted so consecutive commands using the same mesh are instanced once there are enough of them
+	   while the rest of the commands are batched together in the order they are provided. 
+	   Opaque commands linked to an entity are kept in a StaticBatch per material instead
+	*/
 	class DrawDataBuffer sealed
 	{
 	public:
@@ -72,45 +172,41 @@ namespace AstralEngine
 
 		void Initialize();
 
-		void Draw(const Mat4& viewProj, MaterialHandle material);
-		void RenderGeometry(const Mat4& viewProj);
-		void AddDrawCommand(DrawCommand* draw);
-		void Clear();
+		// binds the material then renders the commands
+		void Draw(const Mat4& viewProj, MaterialHandle material, DrawCommand* const* commands, size_t count);
 
-		bool IsEmpty() const;
+		// renders the commands using whichever shader is currently bound
+		void RenderGeometry(const Mat4& viewProj, DrawCommand* const* commands, size_t count);
 
-	private:
-		void ReadVertexDataFromMesh(AReference<Mesh>& mesh, VertexData* vertexDataArr, size_t dataOffset,
-			size_t dataCount);
+		// releases the static batches of the materials which were not drawn for StaticBatch::s_unusedFrameLimit frames
+		void EndFrame();
 
+	private:
 		// returns -1 if there is no more available texture slots
 		int GetTextureIndex(Texture2DHandle* arr, size_t& index, Texture2DHandle texture);
 		void BindTextures(Texture2DHandle* arr, size_t index);
 
-		size_t ComputeDrawCallSize();
 		// Batching /////////////////////////////////////////////
 		void AddToBatching(const Mat4& viewProj, DrawCommand* cmd);
+
+		// adds the clusters of the mesh which are in view, flushing the batch whenever it is full
+		void AddClustersToBatching(const Mat4& viewProj, const Mesh& mesh, DrawCommand* cmd);
+
+		// renders the batch first if there is no more available texture slots
+		int GetBatchTextureIndex(const Mat4& viewProj, Texture2DHandle texture);
 		void RenderBatch(const Mat4& viewProj);
 		void ClearBatching();
-		void BatchRenderMeshSection(BatchedVertexData* vertexData, size_t numVertex,
-			const ADynArr<unsigned int>& indices, size_t dataOffset, size_t drawCallSize);
 
 
 		// Instancing ////////////////////////////////////////////
-		void CollectMeshesToInstance(ASinglyLinkedList<MeshHandle>& toInstance);
-		void RenderInstancing(const Mat4& viewProj, AUnorderedMap<MeshHandle, 
-			ADynArr<DrawCommand*>>& commandsToInstance);
-		void RenderMeshInstance(const Mat4& viewProj, MeshHandle mesh, ADynArr<DrawCommand*>& commands);
-
-		void InstanceRenderMeshSection(VertexData* vertexData, size_t numVertex, 
-			const ADynArr<unsigned int>& indices, InstanceVertexData* instanceData, 
-			size_t numInstanceData, size_t dataOffset, size_t drawCallSize);
+		// draws the commands in a single call per texture set using the gpu buffers owned by the mesh
+		void RenderMeshInstance(const Mat4& viewProj, MeshHandle mesh, DrawCommand* const* commands, 
+			size_t count);
 		void ClearInstancing();
 
 
-		// once a mesh has been used s_instancingCutoff times or 
-		// more in a single frame it will be sent to be instanced instead of being batched 
-		// with the rest of the data
+		// once s_instancingCutoff or more consecutive commands use the same mesh 
+		// they are instanced instead of being batched with the rest of the data
 		static constexpr size_t s_instancingCutoff = 10;//1000; 
 		static size_t s_maxNumVertex;
 		static size_t s_maxNumIndices;
@@ -130,45 +226,41 @@ namespace AstralEngine
 		size_t m_batchTextureSlotIndex;
 		bool m_hasBatchedData;
 
+		// frustum of the view projection the commands are rendered with
+		Frustum m_frustum;
+
 		// used for instancing
-		AReference<VertexBuffer> m_instancingBuffer;
 		AReference<VertexBuffer> m_instancingArr;
 		AReference<IndexBuffer> m_instancingIndices;
 
 		Texture2DHandle* m_instancingTextureSlots;
 		size_t m_instancingTextureSlotIndex;
 
-		// keeps track of how many time each mesh has been used this frame
-		AUnorderedMap<MeshHandle, size_t> m_meshUseCounts; 
-		AUnorderedMap<MeshHandle, ADynArr<DrawCommand*>> m_commandsToInstance;
-		AUnorderedMap<MeshHandle, ADynArr<DrawCommand*>> m_commandsToBatch;
-
-		ASinglyLinkedList<DrawCommand*> m_drawCommands;
+		// used for static batching
+		AUnorderedMap<MaterialHandle, AReference<StaticBatch>> m_staticBatches;
+		ADynArr<DrawCommand*> m_dynamicCommands;
+		size_t m_frame;
 	};
 
-	
-	class RenderingDataSorter
+	// draw command and the key used to order it inside a RenderQueue
+	struct RenderItem
 	{
-	public:
-		using AIterator = AUnorderedMap<MaterialHandle, DrawDataBuffer>::AIterator;
-		using AConstIterator = AUnorderedMap<MaterialHandle, DrawDataBuffer>::AConstIterator;
-
-		void AddData(DrawCommand* data);
-		void Clear();
+		std::uint64_t key;
+		DrawCommand* command;
+	};
 
-		bool IsEmpty() const;
+	/* processes and renders to the screen according to a specific rendering path either forward or deferred
 
-		AIterator begin();
-		AIterator end();
+	   the draw commands of a frame are stored in a flat array along with a 64 bit sort key which is 
+	   radix sorted once per frame, the sorted commands are then walked to emit batches and instanced runs.
+	   From the most to the least significant bits the keys are laid out as
 
-		AConstIterator begin() const;
-		AConstIterator end() const;
+	   opaque:      | 0 | shader (16) | material (16) | mesh (16) | depth front to back (15) |
+	   transparent: | 1 | depth back to front (24) | material (16) | mesh (16) | unused (7) |
 
-	private:
-		AUnorderedMap<MaterialHandle, DrawDataBuffer> m_buffers;
-	};
-
-	// processes and renders to the screen according to a specific rendering path either forward or deferred
+	   so opaque commands are grouped to minimize state changes while transparent commands are 
+	   drawn after them from the furthest to the closest
+	*/
 	class RenderQueue sealed
 	{
 	public:
@@ -185,10 +277,20 @@ namespace AstralEngine
 
 	private:
 		void SetupFullscreenRenderingObjects();
+		void ComputeSortKeys(const Mat4& viewProj);
+		void SortItems();
+		void DrawForward(const Mat4& viewProj);
+		void DrawDeferred(const Mat4& viewProj);
+
+		// returns the end of the run of sorted commands starting at first which use the same material
+		size_t FindMaterialRunEnd(size_t first) const;
 
 		GBuffer* m_gBuffer;
-		RenderingDataSorter m_opaque;
-		RenderingDataSorter* m_transparent;
+		DrawDataBuffer m_drawBuffer;
+
+		ADynArr<RenderItem> m_items;
+		ADynArr<RenderItem> m_sortBuffer;
+		ADynArr<DrawCommand*> m_sortedCommands;
 
 		ShaderHandle m_deferredShader;
 		AReference<VertexBuffer> m_deferredVB;
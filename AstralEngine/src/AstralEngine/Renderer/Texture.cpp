@@ -2,6 +2,7 @@
 #include "Texture.h"
 #include "RenderAPI.h"
 #include "AstralEngine/Platform/OpenGL/OpenGLTexture.h"
+#include <stb_image.h>
 
 namespace AstralEngine 
 {
@@ -76,6 +77,27 @@ namespace AstralEngine
 		return nullptr;
 	}
 
+	unsigned char* Texture2D::DecodeFile(const std::string& path, unsigned int& outWidth, unsigned int& outHeight)
+	{
+		AE_PROFILE_FUNCTION();
+		int width, height, channels;
+		stbi_set_flip_vertically_on_load_thread(true);
+		unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+		if (pixels == nullptr)
+		{
+			return nullptr;
+		}
+
+		outWidth = (unsigned int)width;
+		outHeight = (unsigned int)height;
+		return pixels;
+	}
+
+	void Texture2D::FreePixels(unsigned char* pixels)
+	{
+		stbi_image_free(pixels);
+	}
+
 
 	//CubeMap /////////////////////////////////////////
 
@@ -47,6 +47,12 @@ namespace AstralEngine
 		static AReference<Texture2D> Create(unsigned int width, unsigned int height, 
 			Texture2DInternalFormat internalFormat);
 		static AReference<Texture2D> Create(unsigned int width, unsigned int height, void* data, unsigned int size);
+
+		/*decodes an image file into RGBA8 pixels without creating the texture so it can be called from any 
+		  thread, returns nullptr if the file could not be decoded. The pixels must be freed with FreePixels
+		*/
+		static unsigned char* DecodeFile(const std::string& path, unsigned int& outWidth, unsigned int& outHeight);
+		static void FreePixels(unsigned char* pixels);
 	};
 
 	//sub texture of a texture atlas
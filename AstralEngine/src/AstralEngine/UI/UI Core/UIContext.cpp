@@ -1400,6 +1400,7 @@ namespace AstralEngine
                 continue;
             }
             DockContextPruneNodeData* dataRoot = (data->rootID == settings->id) ? data : &pool[data->rootID];
+            data = &pool[settings->id]; // adding the root to the pool can move the data of the node
 
             bool remove = false;
             
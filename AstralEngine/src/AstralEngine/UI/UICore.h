@@ -383,7 +383,7 @@ namespace AstralEngine
 		//gets called when the button is clicked
 		void ClickButton()
 		{
-			m_listeners.CallDelagates();
+			m_listeners.CallDelegates();
 		}
 
 		static UIButton* s_clickedButton; //keeps track of the last clicked button
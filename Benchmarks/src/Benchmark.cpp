@@ -0,0 +1,31 @@
+#include "Benchmark.h"
+
+namespace Benchmarks
+{
+	static volatile size_t s_sink = 0;
+
+	void DoNotOptimize(size_t value)
+	{
+		s_sink = s_sink + value;
+	}
+
+	void PrintSuite(const char* name)
+	{
+		printf("\n%s\n", name);
+	}
+
+	void PrintTime(const char* label, double ms)
+	{
+		printf("  %-48s %10.3f ms\n", label, ms);
+	}
+
+	void PrintThroughput(const char* label, double ms, size_t count, const char* unit)
+	{
+		printf("  %-48s %10.3f ms  %12.2f M%s/s\n", label, ms, (double)count / (ms * 1000.0), unit);
+	}
+
+	void PrintValue(const char* label, double value, const char* unit)
+	{
+		printf("  %-48s %10.3f %s\n", label, value, unit);
+	}
+}
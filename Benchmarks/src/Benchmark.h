@@ -0,0 +1,49 @@
+#pragma once
+#include <AstralEngine.h>
+
+#include <chrono>
+#include <cstdio>
+
+namespace Benchmarks
+{
+	/*every benchmark uses fixed seeds and sizes so the numbers of two builds can be compared, 
+	  they are meant to be run in the Release configuration
+	*/
+	static constexpr unsigned int s_seed = 1337;
+
+	/*runs func the number of times requested and returns the fastest run in milliseconds, 
+	  the fastest run is the one least disturbed by the rest of the system
+	*/
+	template<typename Func>
+	double Measure(size_t runs, Func func)
+	{
+		double best = 0.0;
+		for (size_t i = 0; i < runs; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			func();
+			auto end = std::chrono::steady_clock::now();
+			double ms = std::chrono::duration<double, std::milli>(end - start).count();
+			best = i == 0 ? ms : (std::min)(best, ms);
+		}
+		return best;
+	}
+
+	//defeats the optimizer for results which are otherwise unused
+	void DoNotOptimize(size_t value);
+
+	void PrintSuite(const char* name);
+	void PrintTime(const char* label, double ms);
+	void PrintThroughput(const char* label, double ms, size_t count, const char* unit);
+	void PrintValue(const char* label, double value, const char* unit);
+
+	// suites /////////////////////////////////////////////////////////////
+	void RunSparseSetBenchmarks();
+	void RunResourcePoolBenchmarks();
+	void RunResourceAccessBenchmarks();
+	void RunOBJParserBenchmarks();
+	void RunVertexWeldBenchmarks();
+	void RunMeshProcessingBenchmarks();
+	void RunUnorderedMapBenchmarks();
+	void RunReferenceBenchmarks();
+}
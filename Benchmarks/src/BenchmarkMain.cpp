@@ -0,0 +1,40 @@
+#include "Benchmark.h"
+
+#include <cstring>
+
+//EntryPoint.h is not included since the benchmarks do not create an Application
+HANDLE AstralEngine::Logger::s_handle;
+std::ofstream AstralEngine::Logger::s_file;
+std::mutex AstralEngine::Logger::s_mutex;
+
+/*runs every suite, or only the ones whose name contains the first argument
+
+  Benchmarks.exe             runs everything
+  Benchmarks.exe SparseSet   runs the ASparseSet suite only
+*/
+static void RunSuite(const char* filter, const char* name, void(*suite)())
+{
+	if (filter == nullptr || strstr(name, filter) != nullptr)
+	{
+		Benchmarks::PrintSuite(name);
+		suite();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	AstralEngine::Logger::Init("Benchmarks.log");
+	AstralEngine::JobSystem::Init();
+
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+	RunSuite(filter, "SparseSet", &Benchmarks::RunSparseSetBenchmarks);
+	RunSuite(filter, "ResourcePool", &Benchmarks::RunResourcePoolBenchmarks);
+	RunSuite(filter, "ResourceAccess", &Benchmarks::RunResourceAccessBenchmarks);
+	RunSuite(filter, "OBJParser", &Benchmarks::RunOBJParserBenchmarks);
+	RunSuite(filter, "VertexWeld", &Benchmarks::RunVertexWeldBenchmarks);
+	RunSuite(filter, "MeshProcessing", &Benchmarks::RunMeshProcessingBenchmarks);
+	RunSuite(filter, "UnorderedMap", &Benchmarks::RunUnorderedMapBenchmarks);
+	RunSuite(filter, "Reference", &Benchmarks::RunReferenceBenchmarks);
+
+	AstralEngine::JobSystem::Shutdown();
+}
@@ -0,0 +1,252 @@
+#include "Benchmark.h"
+#include "AstralEngine/Renderer/MeshOptimizer.h"
+
+#include <random>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+namespace Benchmarks
+{
+	using namespace AstralEngine;
+
+	static constexpr size_t s_majorSegments = 512;
+	static constexpr size_t s_minorSegments = 128;
+	static constexpr float s_majorRadius = 1.0f;
+	static constexpr float s_minorRadius = 0.4f;
+
+	//resolution of the views rasterized to measure the overdraw
+	static constexpr int s_overdrawResolution = 512;
+
+	struct BenchGeometry
+	{
+		ADynArr<Vector3> positions;
+		ADynArr<Vector2> textureCoords;
+		ADynArr<Vector3> normals;
+		ADynArr<unsigned int> indices;
+	};
+
+	/*torus lying in the xz plane whose triangles are shuffled like an unoptimized export, seen from 
+	  the side its far half is hidden by its near half so the order of the triangles affects the overdraw
+	*/
+	static BenchGeometry GenerateTorus()
+	{
+		BenchGeometry geometry;
+		const float twoPi = 6.28318530718f;
+		for (size_t i = 0; i < s_majorSegments; i++)
+		{
+			float u = twoPi * (float)i / (float)s_majorSegments;
+			for (size_t j = 0; j < s_minorSegments; j++)
+			{
+				float v = twoPi * (float)j / (float)s_minorSegments;
+				Vector3 normal(std::cos(v) * std::cos(u), std::sin(v), std::cos(v) * std::sin(u));
+				Vector3 center(s_majorRadius * std::cos(u), 0.0f, s_majorRadius * std::sin(u));
+				geometry.positions.Add(center + normal * s_minorRadius);
+				geometry.textureCoords.Add(Vector2((float)i / (float)s_majorSegments, (float)j / (float)s_minorSegments));
+				geometry.normals.Add(normal);
+			}
+		}
+
+		ADynArr<unsigned int> quads;
+		for (size_t i = 0; i < s_majorSegments; i++)
+		{
+			for (size_t j = 0; j < s_minorSegments; j++)
+			{
+				unsigned int a = (unsigned int)(i * s_minorSegments + j);
+				unsigned int b = (unsigned int)(((i + 1) % s_majorSegments) * s_minorSegments + j);
+				unsigned int c = (unsigned int)(((i + 1) % s_majorSegments) * s_minorSegments + (j + 1) % s_minorSegments);
+				unsigned int d = (unsigned int)(i * s_minorSegments + (j + 1) % s_minorSegments);
+				unsigned int triangles[6] = { a, b, c, a, c, d };
+
+				//wind the triangles so they face outward
+				for (int t = 0; t < 6; t += 3)
+				{
+					const Vector3& p0 = geometry.positions[triangles[t]];
+					Vector3 normal = Vector3::CrossProduct(geometry.positions[triangles[t + 1]] - p0, 
+						geometry.positions[triangles[t + 2]] - p0);
+					if (Vector3::DotProduct(normal, geometry.normals[triangles[t]]) < 0.0f)
+					{
+						std::swap(triangles[t + 1], triangles[t + 2]);
+					}
+				}
+
+				for (unsigned int index : triangles)
+				{
+					quads.Add(index);
+				}
+			}
+		}
+
+		std::mt19937 rng(s_seed);
+		size_t numTriangles = quads.GetCount() / 3;
+		ADynArr<size_t> order(numTriangles);
+		for (size_t i = 0; i < numTriangles; i++)
+		{
+			order.Add(i);
+		}
+		std::shuffle(order.GetData(), order.GetData() + numTriangles, rng);
+
+		geometry.indices = ADynArr<unsigned int>(quads.GetCount());
+		for (size_t triangle : order)
+		{
+			geometry.indices.Add(quads[triangle * 3]);
+			geometry.indices.Add(quads[triangle * 3 + 1]);
+			geometry.indices.Add(quads[triangle * 3 + 2]);
+		}
+		return geometry;
+	}
+
+	static float EdgeFunction(float ax, float ay, float bx, float by, float px, float py)
+	{
+		return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+	}
+
+	/*rasterizes the mesh from the six axis directions with back face culling and an early depth test, 
+	  returns the number of fragments shaded per pixel covered (1 means no overdraw)
+	*/
+	static float MeasureOverdraw(const BenchGeometry& geometry)
+	{
+		Vector3 boundsMin = geometry.positions[0];
+		Vector3 boundsMax = boundsMin;
+		for (const Vector3& position : geometry.positions)
+		{
+			boundsMin = Vector3((std::min)(boundsMin.x, position.x), (std::min)(boundsMin.y, position.y),
+				(std::min)(boundsMin.z, position.z));
+			boundsMax = Vector3((std::max)(boundsMax.x, position.x), (std::max)(boundsMax.y, position.y),
+				(std::max)(boundsMax.z, position.z));
+		}
+		Vector3 center = (boundsMin + boundsMax) * 0.5f;
+		float extent = (boundsMax - boundsMin).Magnitude() * 0.5f;
+
+		const Vector3 axes[3] = { Vector3(1.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f), Vector3(0.0f, 0.0f, 1.0f) };
+		float* depths = new float[s_overdrawResolution * s_overdrawResolution];
+		size_t numShaded = 0;
+		size_t numCovered = 0;
+
+		for (int view = 0; view < 6; view++)
+		{
+			float sign = view < 3 ? 1.0f : -1.0f;
+			Vector3 forward = axes[view % 3] * sign;
+			Vector3 right = axes[(view + 1) % 3];
+			Vector3 up = axes[(view + 2) % 3];
+
+			for (int i = 0; i < s_overdrawResolution * s_overdrawResolution; i++)
+			{
+				depths[i] = FLT_MAX;
+			}
+
+			for (size_t t = 0; t + 2 < geometry.indices.GetCount(); t += 3)
+			{
+				const Vector3& p0 = geometry.positions[geometry.indices[t]];
+				const Vector3& p1 = geometry.positions[geometry.indices[t + 1]];
+				const Vector3& p2 = geometry.positions[geometry.indices[t + 2]];
+				if (Vector3::DotProduct(Vector3::CrossProduct(p1 - p0, p2 - p0), forward) >= 0.0f)
+				{
+					continue;
+				}
+
+				float x[3];
+				float y[3];
+				float z[3];
+				const Vector3* corners[3] = { &p0, &p1, &p2 };
+				for (int c = 0; c < 3; c++)
+				{
+					Vector3 local = *corners[c] - center;
+					x[c] = (Vector3::DotProduct(local, right) / extent * 0.5f + 0.5f) * s_overdrawResolution;
+					y[c] = (Vector3::DotProduct(local, up) / extent * 0.5f + 0.5f) * s_overdrawResolution;
+					z[c] = Vector3::DotProduct(local, forward);
+				}
+
+				float area = EdgeFunction(x[0], y[0], x[1], y[1], x[2], y[2]);
+				if (area == 0.0f)
+				{
+					continue;
+				}
+
+				int minX = (std::max)(0, (int)std::floor((std::min)({ x[0], x[1], x[2] })));
+				int maxX = (std::min)(s_overdrawResolution - 1, (int)std::ceil((std::max)({ x[0], x[1], x[2] })));
+				int minY = (std::max)(0, (int)std::floor((std::min)({ y[0], y[1], y[2] })));
+				int maxY = (std::min)(s_overdrawResolution - 1, (int)std::ceil((std::max)({ y[0], y[1], y[2] })));
+
+				for (int py = minY; py <= maxY; py++)
+				{
+					for (int px = minX; px <= maxX; px++)
+					{
+						float sx = (float)px + 0.5f;
+						float sy = (float)py + 0.5f;
+						float w0 = EdgeFunction(x[1], y[1], x[2], y[2], sx, sy) / area;
+						float w1 = EdgeFunction(x[2], y[2], x[0], y[0], sx, sy) / area;
+						float w2 = 1.0f - w0 - w1;
+						if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+						{
+							continue;
+						}
+
+						float depth = w0 * z[0] + w1 * z[1] + w2 * z[2];
+						float& stored = depths[py * s_overdrawResolution + px];
+						if (depth < stored)
+						{
+							stored = depth;
+							numShaded++;
+						}
+					}
+				}
+			}
+
+			for (int i = 0; i < s_overdrawResolution * s_overdrawResolution; i++)
+			{
+				numCovered += depths[i] != FLT_MAX ? 1 : 0;
+			}
+		}
+
+		delete[] depths;
+		return numCovered == 0 ? 0.0f : (float)numShaded / (float)numCovered;
+	}
+
+	static void PrintMeshStatistics(const char* name, const BenchGeometry& geometry)
+	{
+		char label[128];
+		VertexCacheStatistics stats = MeshOptimizer::AnalyzeVertexCache(geometry.indices, geometry.positions.GetCount());
+		snprintf(label, sizeof(label), "%s acmr", name);
+		PrintValue(label, stats.acmr, "");
+		snprintf(label, sizeof(label), "%s atvr", name);
+		PrintValue(label, stats.atvr, "");
+		snprintf(label, sizeof(label), "%s overdraw", name);
+		PrintValue(label, MeasureOverdraw(geometry), "");
+	}
+
+	void RunMeshProcessingBenchmarks()
+	{
+		BenchGeometry geometry = GenerateTorus();
+		PrintValue("triangles", (double)(geometry.indices.GetCount() / 3) / 1000.0, "k");
+		PrintMeshStatistics("shuffled", geometry);
+
+		//every pass is measured on a copy of its input so it can be run several times
+		BenchGeometry cacheOptimized = geometry;
+		double cacheMs = Measure(3, [&]()
+			{
+				cacheOptimized.indices = geometry.indices;
+				MeshOptimizer::OptimizeVertexCache(cacheOptimized.indices, cacheOptimized.positions.GetCount());
+			});
+		PrintTime("OptimizeVertexCache", cacheMs);
+		PrintMeshStatistics("vertex cache", cacheOptimized);
+
+		BenchGeometry overdrawOptimized = cacheOptimized;
+		double overdrawMs = Measure(3, [&]()
+			{
+				overdrawOptimized.indices = cacheOptimized.indices;
+				MeshOptimizer::OptimizeOverdraw(overdrawOptimized.positions, overdrawOptimized.indices);
+			});
+		PrintTime("OptimizeOverdraw", overdrawMs);
+		PrintMeshStatistics("vertex cache + overdraw", overdrawOptimized);
+
+		BenchGeometry fetchOptimized = overdrawOptimized;
+		double fetchMs = Measure(3, [&]()
+			{
+				fetchOptimized = overdrawOptimized;
+				MeshOptimizer::OptimizeVertexFetch(fetchOptimized.positions, fetchOptimized.textureCoords, 
+					fetchOptimized.normals, fetchOptimized.indices);
+			});
+		PrintTime("OptimizeVertexFetch", fetchMs);
+	}
+}
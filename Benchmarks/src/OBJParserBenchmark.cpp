@@ -0,0 +1,93 @@
+#include "Benchmark.h"
+#include "AstralEngine/Renderer/OBJParser.h"
+
+#include <string>
+#include <fstream>
+
+namespace Benchmarks
+{
+	using namespace AstralEngine;
+
+	//a grid of 1582 x 1582 vertices has 1581 x 1581 quads, 4999122 triangles
+	static constexpr size_t s_gridSize = 1582;
+	static constexpr const char* s_objFilepath = "benchmark_grid.obj";
+
+	/*writes a grid with positions, texture coordinates and normals, the faces are quads so they are
+	  triangulated by the parser and every other row uses relative indices
+	*/
+	static std::string GenerateGridOBJ()
+	{
+		std::string obj;
+		obj.reserve(s_gridSize * s_gridSize * 200);
+		char line[256];
+
+		for (size_t y = 0; y < s_gridSize; y++)
+		{
+			for (size_t x = 0; x < s_gridSize; x++)
+			{
+				float u = (float)x / (float)(s_gridSize - 1);
+				float v = (float)y / (float)(s_gridSize - 1);
+				int length = snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n", 
+					u * 100.0f, (float)((x * 7 + y * 13) % 17) * 0.05f, v * 100.0f, u, v, 0.0f, 1.0f, 0.0f);
+				obj.append(line, length);
+			}
+		}
+
+		long long numVertices = (long long)(s_gridSize * s_gridSize);
+		for (size_t y = 0; y < s_gridSize - 1; y++)
+		{
+			for (size_t x = 0; x < s_gridSize - 1; x++)
+			{
+				long long corners[4] = {
+					(long long)(y * s_gridSize + x),
+					(long long)(y * s_gridSize + x + 1),
+					(long long)((y + 1) * s_gridSize + x + 1),
+					(long long)((y + 1) * s_gridSize + x)
+				};
+
+				for (long long& corner : corners)
+				{
+					corner = y % 2 == 0 ? corner + 1 : corner - numVertices;
+				}
+
+				int length = snprintf(line, sizeof(line), "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n",
+					corners[0], corners[0], corners[0], corners[1], corners[1], corners[1], 
+					corners[2], corners[2], corners[2], corners[3], corners[3], corners[3]);
+				obj.append(line, length);
+			}
+		}
+
+		return obj;
+	}
+
+	static void PrintParse(const char* label, double ms, size_t size)
+	{
+		PrintTime(label, ms);
+		PrintValue(label, (double)size / (1024.0 * 1024.0) / (ms / 1000.0), "MB/s");
+	}
+
+	void RunOBJParserBenchmarks()
+	{
+		std::string obj = GenerateGridOBJ();
+		PrintValue("file size", (double)obj.size() / (1024.0 * 1024.0), "MB");
+
+		OBJParser* parser = new OBJParser();
+		bool succeeded = true;
+		double memoryMs = Measure(3, [&]() { succeeded &= parser->Parse(obj.data(), obj.size()); });
+		PrintValue("triangles", (double)(parser->GetIndices().GetCount() / 3) / 1000000.0, "M");
+		PrintParse("parse from memory", memoryMs, obj.size());
+
+		std::ofstream file(s_objFilepath, std::ios::out | std::ios::binary);
+		file.write(obj.data(), obj.size());
+		file.close();
+		double fileMs = Measure(3, [&]() { succeeded &= parser->ParseFile(s_objFilepath); });
+		std::remove(s_objFilepath);
+		PrintParse("parse from file", fileMs, obj.size());
+
+		if (!succeeded)
+		{
+			printf("  the generated file could not be parsed\n");
+		}
+		delete parser;
+	}
+}
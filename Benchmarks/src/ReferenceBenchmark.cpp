@@ -0,0 +1,212 @@
+#include "Benchmark.h"
+
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace Benchmarks
+{
+	struct PlainObject
+	{
+		size_t value[4];
+	};
+
+	struct SharedObject
+	{
+		size_t value[4];
+	};
+
+	//destroyed objects are counted so the stress test can check that every object was destroyed exactly once
+	static std::atomic<size_t> s_numStressObjects(0);
+
+	struct StressObject : public AstralEngine::ARefCounted
+	{
+		StressObject(size_t v) : value(v), isAlive(true) { s_numStressObjects.fetch_add(1); }
+		~StressObject() { isAlive = false; s_numStressObjects.fetch_sub(1); }
+
+		AstralEngine::AReference<StressObject> GetReference() { return AstralEngine::AReference<StressObject>(this); }
+
+		size_t value;
+		std::atomic<bool> isAlive;
+	};
+}
+
+namespace AstralEngine
+{
+	template<>
+	struct AAtomicRefCount<Benchmarks::SharedObject> : std::true_type { };
+
+	template<>
+	struct AAtomicRefCount<Benchmarks::StressObject> : std::true_type { };
+}
+
+namespace Benchmarks
+{
+	using namespace AstralEngine;
+
+	static constexpr size_t s_numCreated = 1000000;
+	static constexpr size_t s_numCopies = 10000000;
+
+	//references copied at once, kept small so they stay in the cache and the counts are what is measured
+	static constexpr size_t s_copyBatch = 1000;
+
+	static constexpr size_t s_numStressRounds = 200;
+	static constexpr size_t s_numStressIterations = 2000;
+
+	template<typename Ref, typename Create>
+	static double MeasureCreate(Create create)
+	{
+		ADynArr<Ref> refs(s_copyBatch);
+		return Measure(3, [&]()
+			{
+				for (size_t i = 0; i < s_numCreated; i += s_copyBatch)
+				{
+					for (size_t j = 0; j < s_copyBatch; j++)
+					{
+						refs.Add(create());
+					}
+					refs.Clear();
+				}
+			});
+	}
+
+	template<typename Ref>
+	static double MeasureCopy(const Ref& source)
+	{
+		ADynArr<Ref> refs(s_copyBatch);
+		return Measure(3, [&]()
+			{
+				for (size_t i = 0; i < s_numCopies; i += s_copyBatch)
+				{
+					for (size_t j = 0; j < s_copyBatch; j++)
+					{
+						refs.Add(source);
+					}
+					refs.Clear();
+				}
+			});
+	}
+
+	template<typename Ref, typename WeakRef, typename Lock>
+	static double MeasureLock(const WeakRef& source, Lock lock)
+	{
+		ADynArr<Ref> refs(s_copyBatch);
+		return Measure(3, [&]()
+			{
+				for (size_t i = 0; i < s_numCopies; i += s_copyBatch)
+				{
+					for (size_t j = 0; j < s_copyBatch; j++)
+					{
+						refs.Add(lock(source));
+					}
+					refs.Clear();
+				}
+			});
+	}
+
+	/*every round the threads copy a shared reference, promote weak references to it and make references 
+	  back from the raw pointer while the main thread finally releases it as other threads still promote 
+	  weak references. Fails if an object is seen destroyed while referenced, if the counts do not go back 
+	  to their initial value or if an object is not destroyed exactly once
+	*/
+	static bool RunReferenceStressTest()
+	{
+		size_t numThreads = (std::max)((size_t)std::thread::hardware_concurrency(), (size_t)4);
+		std::atomic<bool> failed(false);
+
+		for (size_t round = 0; round < s_numStressRounds && !failed; round++)
+		{
+			AReference<StressObject> shared = AReference<StressObject>::Create(round);
+			AWeakRef<StressObject> weak = shared;
+
+			std::vector<std::thread> threads;
+			for (size_t t = 0; t < numThreads; t++)
+			{
+				threads.emplace_back([&shared, weak, &failed, round]()
+					{
+						for (size_t i = 0; i < s_numStressIterations; i++)
+						{
+							AReference<StressObject> copy = shared;
+							AWeakRef<StressObject> weakCopy = copy;
+							AReference<StressObject> promoted = weakCopy;
+							AReference<StressObject> fromPointer = promoted->GetReference();
+							if (promoted == nullptr || !fromPointer->isAlive || fromPointer->value != round)
+							{
+								failed = true;
+							}
+						}
+					});
+			}
+
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+
+			if (shared.GetStrongCount() != 1 || shared.GetWeakCount() != 1)
+			{
+				failed = true;
+			}
+
+			//the last strong reference is released while the weak ones are promoted
+			threads.clear();
+			for (size_t t = 0; t < numThreads; t++)
+			{
+				threads.emplace_back([weak, &failed]()
+					{
+						for (size_t i = 0; i < s_numStressIterations; i++)
+						{
+							AReference<StressObject> promoted = weak;
+							if (promoted != nullptr && !promoted->isAlive)
+							{
+								failed = true;
+							}
+						}
+					});
+			}
+			shared = nullptr;
+
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+
+			if (!weak.IsExpired() || s_numStressObjects.load() != 0)
+			{
+				failed = true;
+			}
+		}
+
+		return !failed;
+	}
+
+	void RunReferenceBenchmarks()
+	{
+		//run first, libstdc++ updates the counts of std::shared_ptr without atomics until the process creates a thread
+		bool passed = false;
+		double stressMs = Measure(1, [&passed]() { passed = RunReferenceStressTest(); });
+		PrintTime(passed ? "concurrent stress test passed" : "concurrent stress test FAILED", stressMs);
+
+		double createPlain = MeasureCreate<AReference<PlainObject>>([]() { return AReference<PlainObject>::Create(); });
+		double createShared = MeasureCreate<std::shared_ptr<PlainObject>>([]() { return std::make_shared<PlainObject>(); });
+		PrintThroughput("AReference create/destroy", createPlain, s_numCreated, "op");
+		PrintThroughput("std::make_shared create/destroy", createShared, s_numCreated, "op");
+
+		AReference<PlainObject> plain = AReference<PlainObject>::Create();
+		AReference<SharedObject> atomic = AReference<SharedObject>::Create();
+		std::shared_ptr<PlainObject> standard = std::make_shared<PlainObject>();
+		PrintThroughput("AReference copy/destroy", MeasureCopy(plain), s_numCopies, "op");
+		PrintThroughput("AReference (atomic) copy/destroy", MeasureCopy(atomic), s_numCopies, "op");
+		PrintThroughput("std::shared_ptr copy/destroy", MeasureCopy(standard), s_numCopies, "op");
+
+		AWeakRef<SharedObject> weakAtomic = atomic;
+		std::weak_ptr<PlainObject> weakStandard = standard;
+		double lockAtomic = MeasureLock<AReference<SharedObject>>(weakAtomic, 
+			[](const AWeakRef<SharedObject>& weak) { return AReference<SharedObject>(weak); });
+		double lockStandard = MeasureLock<std::shared_ptr<PlainObject>>(weakStandard, 
+			[](const std::weak_ptr<PlainObject>& weak) { return weak.lock(); });
+		PrintThroughput("AWeakRef (atomic) promote/destroy", lockAtomic, s_numCopies, "op");
+		PrintThroughput("std::weak_ptr lock/destroy", lockStandard, s_numCopies, "op");
+	}
+}
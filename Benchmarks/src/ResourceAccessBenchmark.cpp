@@ -0,0 +1,139 @@
+#include "Benchmark.h"
+#include "AstralEngine/Core/Resource.h"
+
+#include <random>
+
+namespace Benchmarks
+{
+	struct BenchMesh
+	{
+		size_t indexCount;
+	};
+
+	struct BenchMaterial
+	{
+		size_t shader;
+		size_t diffuseMap;
+		size_t specularMap;
+		bool deferred;
+	};
+
+	struct BenchResource
+	{
+		size_t id;
+	};
+}
+
+namespace AstralEngine
+{
+	//same policy as the meshes created by the loading jobs
+	template<>
+	struct AAtomicRefCount<Benchmarks::BenchMesh> : std::true_type { };
+}
+
+namespace Benchmarks
+{
+	using namespace AstralEngine;
+
+	static constexpr size_t s_numCommands = 100000;
+	static constexpr size_t s_numMeshes = 1000;
+	static constexpr size_t s_numMaterials = 200;
+	static constexpr size_t s_numShaders = 8;
+	static constexpr size_t s_numTextures = 400;
+
+	struct BenchDrawCommand
+	{
+		MeshHandle mesh;
+		MaterialHandle material;
+	};
+
+	/*pools standing in for the ones of the ResourceHandler, a draw command touches its material to know
+	  if it is deferred, its mesh when it is batched, then the shader and the textures of its material when drawn
+	*/
+	struct BenchResources
+	{
+		ResourcePool<BenchMesh> meshes;
+		ResourcePool<BenchMaterial> materials;
+		ResourcePool<BenchResource> shaders;
+		ResourcePool<BenchResource> textures;
+	};
+
+	//copies the references like the Get functions of the ResourceHandler
+	static size_t SubmitWithGet(BenchResources& resources, const ADynArr<BenchDrawCommand>& commands)
+	{
+		size_t sum = 0;
+		for (const BenchDrawCommand& cmd : commands)
+		{
+			AReference<BenchMaterial> material = resources.materials.GetResource(cmd.material);
+			AReference<BenchMesh> mesh = resources.meshes.GetResource(cmd.mesh);
+			AReference<BenchResource> shader = resources.shaders.GetResource(material->shader);
+			AReference<BenchResource> diffuse = resources.textures.GetResource(material->diffuseMap);
+			AReference<BenchResource> specular = resources.textures.GetResource(material->specularMap);
+			sum += (material->deferred ? 1 : 0) + mesh->indexCount + shader->id + diffuse->id + specular->id;
+		}
+		return sum;
+	}
+
+	//borrows the resources like the renderer does
+	static size_t SubmitWithBorrow(BenchResources& resources, const ADynArr<BenchDrawCommand>& commands)
+	{
+		size_t sum = 0;
+		for (const BenchDrawCommand& cmd : commands)
+		{
+			ResourceView<BenchMaterial> material(resources.materials.BorrowResource(cmd.material));
+			ResourceView<BenchMesh> mesh(resources.meshes.BorrowResource(cmd.mesh));
+			ResourceView<BenchResource> shader(resources.shaders.BorrowResource(material->shader));
+			ResourceView<BenchResource> diffuse(resources.textures.BorrowResource(material->diffuseMap));
+			ResourceView<BenchResource> specular(resources.textures.BorrowResource(material->specularMap));
+			sum += (material->deferred ? 1 : 0) + mesh->indexCount + shader->id + diffuse->id + specular->id;
+		}
+		return sum;
+	}
+
+	void RunResourceAccessBenchmarks()
+	{
+		std::mt19937 rng(s_seed);
+		BenchResources* resources = new BenchResources();
+
+		ADynArr<ResourceHandle> shaders(s_numShaders);
+		for (size_t i = 0; i < s_numShaders; i++)
+		{
+			shaders.Add(resources->shaders.AddResource(AReference<BenchResource>::Create(BenchResource{ i })));
+		}
+
+		ADynArr<ResourceHandle> textures(s_numTextures);
+		for (size_t i = 0; i < s_numTextures; i++)
+		{
+			textures.Add(resources->textures.AddResource(AReference<BenchResource>::Create(BenchResource{ i })));
+		}
+
+		ADynArr<ResourceHandle> materials(s_numMaterials);
+		for (size_t i = 0; i < s_numMaterials; i++)
+		{
+			BenchMaterial material{ shaders[rng() % s_numShaders], textures[rng() % s_numTextures],
+				textures[rng() % s_numTextures], rng() % 2 == 0 };
+			materials.Add(resources->materials.AddResource(AReference<BenchMaterial>::Create(material)));
+		}
+
+		ADynArr<ResourceHandle> meshes(s_numMeshes);
+		for (size_t i = 0; i < s_numMeshes; i++)
+		{
+			meshes.Add(resources->meshes.AddResource(AReference<BenchMesh>::Create(BenchMesh{ i * 3 })));
+		}
+
+		ADynArr<BenchDrawCommand> commands(s_numCommands);
+		for (size_t i = 0; i < s_numCommands; i++)
+		{
+			commands.Add({ meshes[rng() % s_numMeshes], materials[rng() % s_numMaterials] });
+		}
+
+		size_t sum = 0;
+		double getMs = Measure(5, [&]() { sum += SubmitWithGet(*resources, commands); });
+		double borrowMs = Measure(5, [&]() { sum += SubmitWithBorrow(*resources, commands); });
+		DoNotOptimize(sum);
+		delete resources;
+
+		PrintThroughput("get (reference copies) draw commands", getMs, s_numCommands, "cmd");
+		PrintThroughput("borrow (views) draw commands", borrowMs, s_numCommands, "cmd");
+	}
+}
@@ -0,0 +1,119 @@
+#include "Benchmark.h"
+#include "AstralEngine/Core/Resource.h"
+
+#include <random>
+
+namespace Benchmarks
+{
+	using namespace AstralEngine;
+
+	static constexpr size_t s_numResources = 10000;
+	static constexpr size_t s_numFreed = 5000;
+	static constexpr size_t s_numLookups = 1000000;
+
+	struct PooledResource
+	{
+		size_t value;
+	};
+
+	/*ResourcePool before it was a slot map, kept as a reference. A handle is the index of its resource and 
+	  validating it scans the stack of the handles to reuse
+	*/
+	class LinearScanPool
+	{
+	public:
+		ResourceHandle AddResource(const AReference<PooledResource>& resource)
+		{
+			ResourceHandle handle;
+			if (m_handlesToReuse.IsEmpty())
+			{
+				handle = m_resourceList.GetCount();
+				m_resourceList.Add(resource);
+			}
+			else
+			{
+				handle = m_handlesToReuse.Pop();
+				m_resourceList[handle] = resource;
+			}
+			return handle;
+		}
+
+		void RemoveHandle(ResourceHandle handle)
+		{
+			m_handlesToReuse.Push(handle);
+		}
+
+		AReference<PooledResource>& GetResource(ResourceHandle handle)
+		{
+			return m_resourceList[handle];
+		}
+
+		bool HandleIsValid(ResourceHandle handle)
+		{
+			return handle < m_resourceList.GetCount() && !m_handlesToReuse.Contains(handle);
+		}
+
+	private:
+		ADynArr<AReference<PooledResource>> m_resourceList;
+		AStack<ResourceHandle> m_handlesToReuse;
+	};
+
+	/*fills the pool, frees every other resource then looks up random live handles the way 
+	  ResourceHandler::GetMesh does, validating the handle before accessing the resource
+	*/
+	template<typename Pool>
+	static void RunResourcePool(const char* name, size_t runs)
+	{
+		std::mt19937 rng(s_seed);
+		Pool* pool = new Pool();
+		ADynArr<ResourceHandle> handles(s_numResources);
+		for (size_t i = 0; i < s_numResources; i++)
+		{
+			handles.Add(pool->AddResource(AReference<PooledResource>::Create(PooledResource{ i })));
+		}
+
+		ADynArr<ResourceHandle> liveHandles(s_numResources - s_numFreed);
+		for (size_t i = 0; i < s_numResources; i++)
+		{
+			if (i % 2 == 0)
+			{
+				pool->RemoveHandle(handles[i]);
+			}
+			else
+			{
+				liveHandles.Add(handles[i]);
+			}
+		}
+
+		ADynArr<ResourceHandle> lookups(s_numLookups);
+		for (size_t i = 0; i < s_numLookups; i++)
+		{
+			lookups.Add(liveHandles[rng() % liveHandles.GetCount()]);
+		}
+
+		size_t sum = 0;
+		double ms = Measure(runs, [&]()
+			{
+				for (ResourceHandle handle : lookups)
+				{
+					if (pool->HandleIsValid(handle))
+					{
+						sum += pool->GetResource(handle)->value;
+					}
+				}
+			});
+		DoNotOptimize(sum);
+		delete pool;
+
+		char label[128];
+		snprintf(label, sizeof(label), "%s lookups", name);
+		PrintThroughput(label, ms, s_numLookups, "op");
+	}
+
+	void RunResourcePoolBenchmarks()
+	{
+		//the scan of the 5000 freed handles takes seconds so it is only run once
+		RunResourcePool<LinearScanPool>("linear scan", 1);
+		RunResourcePool<ResourcePool<PooledResource>>("slot map", 3);
+	}
+}
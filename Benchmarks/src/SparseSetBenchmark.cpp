@@ -0,0 +1,109 @@
+#include "Benchmark.h"
+#include "AstralEngine/Data Struct/ASparseSet.h"
+
+#include <random>
+#include <algorithm>
+
+namespace Benchmarks
+{
+	using namespace AstralEngine;
+
+	static constexpr size_t s_numEntities = 1000000;
+
+	//the ids are scattered over 64 times as many indices as there are entities
+	static constexpr size_t s_idRange = s_numEntities * 64;
+
+	//pages of 16384 entries of 8 bytes like the ASparseSet before it was configurable, kept as a reference
+	using PreviousSparseSet = ASparseSet<BaseEntity, AE_PAGE_SIZE, size_t>;
+	using CurrentSparseSet = ASparseSet<BaseEntity>;
+
+	static ADynArr<BaseEntity> GenerateScatteredIds()
+	{
+		std::mt19937 rng(s_seed);
+		ADynArr<BaseEntity> ids(s_numEntities);
+		ADynArr<bool> used;
+		used.Resize(s_idRange, false);
+		while (ids.GetCount() < s_numEntities)
+		{
+			IDType index = (IDType)(rng() % s_idRange);
+			if (!used[index])
+			{
+				used[index] = true;
+				ids.Add(ComposeEntity(index, 0));
+			}
+		}
+		return ids;
+	}
+
+	static double ToMegabytes(size_t bytes)
+	{
+		return (double)bytes / (1024.0 * 1024.0);
+	}
+
+	/*inserts every id, removes 90% of them then removes the rest, the memory held by the sparse pages
+	  is sampled after each step so the pages released once empty show up
+	*/
+	template<typename SparseSet>
+	static void RunSparseSet(const char* name, const ADynArr<BaseEntity>& ids)
+	{
+		char label[128];
+		size_t removedFirst = ids.GetCount() * 9 / 10;
+		SparseSet* set = new SparseSet();
+
+		double insertMs = Measure(1, [&]()
+			{
+				for (BaseEntity e : ids)
+				{
+					set->Add(e);
+				}
+			});
+		size_t fullMemory = set->GetSparseMemory();
+
+		size_t found = 0;
+		double containsMs = Measure(1, [&]()
+			{
+				for (BaseEntity e : ids)
+				{
+					found += set->Contains(e) ? 1 : 0;
+				}
+			});
+		DoNotOptimize(found);
+
+		double removeMs = Measure(1, [&]()
+			{
+				for (size_t i = 0; i < removedFirst; i++)
+				{
+					set->Remove(ids[i]);
+				}
+			});
+		size_t partialMemory = set->GetSparseMemory();
+
+		for (size_t i = removedFirst; i < ids.GetCount(); i++)
+		{
+			set->Remove(ids[i]);
+		}
+		size_t emptyMemory = set->GetSparseMemory();
+		delete set;
+
+		snprintf(label, sizeof(label), "%s insert", name);
+		PrintThroughput(label, insertMs, ids.GetCount(), "op");
+		snprintf(label, sizeof(label), "%s contains", name);
+		PrintThroughput(label, containsMs, ids.GetCount(), "op");
+		snprintf(label, sizeof(label), "%s remove 90%%", name);
+		PrintThroughput(label, removeMs, removedFirst, "op");
+
+		snprintf(label, sizeof(label), "%s sparse memory full", name);
+		PrintValue(label, ToMegabytes(fullMemory), "MB");
+		snprintf(label, sizeof(label), "%s sparse memory after removing 90%%", name);
+		PrintValue(label, ToMegabytes(partialMemory), "MB");
+		snprintf(label, sizeof(label), "%s sparse memory empty", name);
+		PrintValue(label, ToMegabytes(emptyMemory), "MB");
+	}
+
+	void RunSparseSetBenchmarks()
+	{
+		ADynArr<BaseEntity> ids = GenerateScatteredIds();
+		RunSparseSet<PreviousSparseSet>("128KB pages", ids);
+		RunSparseSet<CurrentSparseSet>("16KB pages", ids);
+	}
+}
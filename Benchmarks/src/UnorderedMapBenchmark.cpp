@@ -0,0 +1,278 @@
+#include "Benchmark.h"
+#include "AstralEngine/Data Struct/AUnorderedMap.h"
+#include "AstralEngine/Data Struct/ASinglyLinkedList.h"
+
+#include <random>
+#include <functional>
+#include <unordered_map>
+
+namespace Benchmarks
+{
+	using namespace AstralEngine;
+
+	static constexpr size_t s_numKeys = 1000000;
+
+	/*AUnorderedMap before it used open addressing, kept as a reference. The pairs are stored in linked 
+	  lists, the bucket index goes through std::function and the table only grows once the integer 
+	  load factor reaches 10
+	*/
+	template<typename K, typename T>
+	class ChainedMap
+	{
+	public:
+		struct Pair
+		{
+			K key;
+			T element;
+
+			bool operator==(const Pair& other) const { return key == other.key; }
+		};
+
+		ChainedMap() : m_bucketCount(5), m_count(0), m_equalsFunc(&DefaultEquals), m_compressFunc(&DefaultCompress)
+		{
+			m_buckets = new ASinglyLinkedList<Pair>[m_bucketCount];
+		}
+
+		~ChainedMap()
+		{
+			delete[] m_buckets;
+		}
+
+		void Add(const K& key, const T& element)
+		{
+			m_buckets[GetBucketIndex(key)].Add(Pair{ key, element });
+			m_count++;
+			if (m_count / m_bucketCount >= 10)
+			{
+				Rehash();
+			}
+		}
+
+		void Remove(const K& key)
+		{
+			if (!ContainsKey(key))
+			{
+				return;
+			}
+
+			ASinglyLinkedList<Pair>& bucket = m_buckets[GetBucketIndex(key)];
+			for (auto it = bucket.begin(); it != bucket.end(); it++)
+			{
+				if (m_equalsFunc(key, (*it).key))
+				{
+					bucket.Remove(it);
+					m_count--;
+					break;
+				}
+			}
+		}
+
+		bool ContainsKey(const K& key) const
+		{
+			for (const Pair& pair : m_buckets[GetBucketIndex(key)])
+			{
+				if (m_equalsFunc(pair.key, key))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		const T& operator[](const K& key) const
+		{
+			const ASinglyLinkedList<Pair>& bucket = m_buckets[GetBucketIndex(key)];
+			for (const Pair& pair : bucket)
+			{
+				if (m_equalsFunc(pair.key, key))
+				{
+					return pair.element;
+				}
+			}
+			return (*bucket.begin()).element;
+		}
+
+		template<typename Func>
+		void ForEach(Func func) const
+		{
+			for (size_t i = 0; i < m_bucketCount; i++)
+			{
+				for (const Pair& pair : m_buckets[i])
+				{
+					func(pair.key, pair.element);
+				}
+			}
+		}
+
+	private:
+		static bool DefaultEquals(const K& k1, const K& k2) { return k1 == k2; }
+		//computed on 64 bits, long is 32 bits on windows and 7 * hash would overflow
+		static int DefaultCompress(long long hash, size_t size) { return (int)((7ll * hash + 31ll) % (long long)size); }
+
+		int GetBucketIndex(const K& key) const
+		{
+			//the hash is truncated to a positive int so the compression never returns a negative index
+			return m_compressFunc((int)(m_hash(key) & 0x7FFFFFFF), m_bucketCount);
+		}
+
+		void Rehash()
+		{
+			size_t oldBucketCount = m_bucketCount;
+			ASinglyLinkedList<Pair>* oldBuckets = m_buckets;
+			m_bucketCount = (size_t)((float)m_bucketCount * 1.5f);
+			m_buckets = new ASinglyLinkedList<Pair>[m_bucketCount];
+			for (size_t i = 0; i < oldBucketCount; i++)
+			{
+				for (const Pair& pair : oldBuckets[i])
+				{
+					m_buckets[GetBucketIndex(pair.key)].Add(pair);
+				}
+			}
+			delete[] oldBuckets;
+		}
+
+		ASinglyLinkedList<Pair>* m_buckets;
+		size_t m_bucketCount;
+		size_t m_count;
+		std::function<bool(const K&, const K&)> m_equalsFunc;
+		std::function<int(long long, size_t)> m_compressFunc;
+		std::hash<K> m_hash;
+	};
+
+	struct MapTimings
+	{
+		double insertMs;
+		double findMs;
+		double missMs;
+		double iterateMs;
+		double eraseMs;
+	};
+
+	/*the engine looks keys up with ContainsKey followed by operator[], std::unordered_map with find. 
+	  The maps are recreated for every run so each one measures insertions into an empty map
+	*/
+	template<typename Map, typename Insert, typename Find, typename Iterate, typename Erase>
+	static MapTimings RunMap(const ADynArr<size_t>& keys, const ADynArr<size_t>& missingKeys, 
+		Insert insert, Find find, Iterate iterate, Erase erase)
+	{
+		MapTimings timings;
+		size_t sum = 0;
+		Map* map = nullptr;
+
+		timings.insertMs = Measure(3, [&]()
+			{
+				delete map;
+				map = new Map();
+				for (size_t i = 0; i < keys.GetCount(); i++)
+				{
+					insert(*map, keys[i], i);
+				}
+			});
+
+		timings.findMs = Measure(3, [&]()
+			{
+				for (size_t key : keys)
+				{
+					sum += find(*map, key);
+				}
+			});
+
+		timings.missMs = Measure(3, [&]()
+			{
+				for (size_t key : missingKeys)
+				{
+					sum += find(*map, key);
+				}
+			});
+
+		timings.iterateMs = Measure(3, [&]() { sum += iterate(*map); });
+
+		//erasing empties the map so it is only measured once
+		timings.eraseMs = Measure(1, [&]()
+			{
+				for (size_t key : keys)
+				{
+					erase(*map, key);
+				}
+			});
+
+		delete map;
+		DoNotOptimize(sum);
+		return timings;
+	}
+
+	static void PrintMapTimings(const char* name, const MapTimings& timings)
+	{
+		char label[128];
+		snprintf(label, sizeof(label), "%s insert", name);
+		PrintThroughput(label, timings.insertMs, s_numKeys, "op");
+		snprintf(label, sizeof(label), "%s find", name);
+		PrintThroughput(label, timings.findMs, s_numKeys, "op");
+		snprintf(label, sizeof(label), "%s find missing", name);
+		PrintThroughput(label, timings.missMs, s_numKeys, "op");
+		snprintf(label, sizeof(label), "%s iterate", name);
+		PrintThroughput(label, timings.iterateMs, s_numKeys, "op");
+		snprintf(label, sizeof(label), "%s erase", name);
+		PrintThroughput(label, timings.eraseMs, s_numKeys, "op");
+	}
+
+	void RunUnorderedMapBenchmarks()
+	{
+		std::mt19937_64 rng(s_seed);
+		ADynArr<size_t> keys(s_numKeys);
+		ADynArr<size_t> missingKeys(s_numKeys);
+
+		//64 bits random keys, the chance that two of them collide is negligible
+		for (size_t i = 0; i < s_numKeys; i++)
+		{
+			keys.Add((size_t)rng());
+			missingKeys.Add((size_t)rng());
+		}
+
+		MapTimings chained = RunMap<ChainedMap<size_t, size_t>>(keys, missingKeys,
+			[](ChainedMap<size_t, size_t>& map, size_t key, size_t value) { map.Add(key, value); },
+			[](ChainedMap<size_t, size_t>& map, size_t key) { return map.ContainsKey(key) ? map[key] : 0; },
+			[](ChainedMap<size_t, size_t>& map)
+			{
+				size_t sum = 0;
+				map.ForEach([&sum](size_t key, size_t value) { sum += value; });
+				return sum;
+			},
+			[](ChainedMap<size_t, size_t>& map, size_t key) { map.Remove(key); });
+		PrintMapTimings("chained AUnorderedMap", chained);
+
+		MapTimings current = RunMap<AUnorderedMap<size_t, size_t>>(keys, missingKeys,
+			[](AUnorderedMap<size_t, size_t>& map, size_t key, size_t value) { map.Add(key, value); },
+			[](AUnorderedMap<size_t, size_t>& map, size_t key) { return map.ContainsKey(key) ? map[key] : 0; },
+			[](AUnorderedMap<size_t, size_t>& map)
+			{
+				size_t sum = 0;
+				for (AKeyElementPair<size_t, size_t>& pair : map)
+				{
+					sum += pair.GetElement();
+				}
+				return sum;
+			},
+			[](AUnorderedMap<size_t, size_t>& map, size_t key) { map.Remove(key); });
+		PrintMapTimings("AUnorderedMap", current);
+
+		MapTimings standard = RunMap<std::unordered_map<size_t, size_t>>(keys, missingKeys,
+			[](std::unordered_map<size_t, size_t>& map, size_t key, size_t value) { map.emplace(key, value); },
+			[](std::unordered_map<size_t, size_t>& map, size_t key)
+			{
+				auto it = map.find(key);
+				return it != map.end() ? it->second : 0;
+			},
+			[](std::unordered_map<size_t, size_t>& map)
+			{
+				size_t sum = 0;
+				for (const auto& pair : map)
+				{
+					sum += pair.second;
+				}
+				return sum;
+			},
+			[](std::unordered_map<size_t, size_t>& map, size_t key) { map.erase(key); });
+		PrintMapTimings("std::unordered_map", standard);
+	}
+}
@@ -0,0 +1,124 @@
+#include "Benchmark.h"
+#include "AstralEngine/Renderer/OBJParser.h"
+
+#include <string>
+
+namespace Benchmarks
+{
+	using namespace AstralEngine;
+
+	//side of the grids welded, the number of vertices is quadrupled every step
+	static constexpr size_t s_gridSizes[] = { 64, 128, 256, 512, 1024, 2048 };
+
+	//the linear search is quadratic so it is only run on the smallest grids
+	static constexpr size_t s_maxLinearSearchGridSize = 128;
+
+	//triangulated grid where every vertex is shared by up to six triangles
+	static std::string GenerateGridOBJ(size_t gridSize)
+	{
+		std::string obj;
+		char line[128];
+
+		for (size_t y = 0; y < gridSize; y++)
+		{
+			for (size_t x = 0; x < gridSize; x++)
+			{
+				int length = snprintf(line, sizeof(line), "v %zu 0 %zu\nvt %zu %zu\nvn 0 1 0\n", x, y, x, y);
+				obj.append(line, length);
+			}
+		}
+
+		for (size_t y = 0; y < gridSize - 1; y++)
+		{
+			for (size_t x = 0; x < gridSize - 1; x++)
+			{
+				size_t a = y * gridSize + x + 1;
+				size_t b = a + 1;
+				size_t c = a + gridSize + 1;
+				size_t d = a + gridSize;
+				int length = snprintf(line, sizeof(line), "f %zu/%zu/1 %zu/%zu/1 %zu/%zu/1\nf %zu/%zu/1 %zu/%zu/1 %zu/%zu/1\n",
+					a, a, b, b, c, c, a, a, c, c, d, d);
+				obj.append(line, length);
+			}
+		}
+
+		return obj;
+	}
+
+	//weld of the importer before it used a hash map, every corner searches all the vertices added so far
+	static size_t WeldWithLinearSearch(const OBJParser& parser)
+	{
+		ADynArr<Vector3> outPositions;
+		ADynArr<Vector2> outTextureCoords;
+		ADynArr<Vector3> outNormals;
+		ADynArr<unsigned int> outIndices;
+
+		for (const OBJIndex& index : parser.GetIndices())
+		{
+			const Vector3& position = parser.GetPositions()[index.position];
+			const Vector2& textureCoords = parser.GetTextureCoords()[index.textureCoords];
+			const Vector3& normal = parser.GetNormals()[index.normal];
+
+			int found = -1;
+			for (unsigned int i = 0; i < outPositions.GetCount(); i++)
+			{
+				if (outPositions[i] == position && outTextureCoords[i] == textureCoords && outNormals[i] == normal)
+				{
+					found = i;
+					break;
+				}
+			}
+
+			if (found == -1)
+			{
+				found = (int)outPositions.GetCount();
+				outPositions.Add(position);
+				outTextureCoords.Add(textureCoords);
+				outNormals.Add(normal);
+			}
+			outIndices.Add((unsigned int)found);
+		}
+		return outPositions.GetCount();
+	}
+
+	static void PrintWeld(const char* name, size_t gridSize, double ms, size_t numCorners)
+	{
+		char label[128];
+		snprintf(label, sizeof(label), "%s %zu vertices", name, gridSize * gridSize);
+		PrintThroughput(label, ms, numCorners, "corner");
+	}
+
+	/*the throughput of the hash map weld stays about the same as the grid grows, 
+	  the one of the linear search is divided by four every step
+	*/
+	void RunVertexWeldBenchmarks()
+	{
+		for (size_t gridSize : s_gridSizes)
+		{
+			std::string obj = GenerateGridOBJ(gridSize);
+			OBJParser parser;
+			if (!parser.Parse(obj.data(), obj.size()))
+			{
+				printf("  the generated file could not be parsed\n");
+				return;
+			}
+			size_t numCorners = parser.GetIndices().GetCount();
+
+			ADynArr<Vector3> positions;
+			ADynArr<Vector2> textureCoords;
+			ADynArr<Vector3> normals;
+			ADynArr<unsigned int> indices;
+			double hashMs = Measure(3, [&]() { parser.WeldVertices(positions, textureCoords, normals, indices); });
+			DoNotOptimize(positions.GetCount());
+			PrintWeld("hash map", gridSize, hashMs, numCorners);
+
+			if (gridSize <= s_maxLinearSearchGridSize)
+			{
+				size_t numVertices = 0;
+				double linearMs = Measure(1, [&]() { numVertices = WeldWithLinearSearch(parser); });
+				DoNotOptimize(numVertices);
+				PrintWeld("linear search", gridSize, linearMs, numCorners);
+			}
+		}
+	}
+}
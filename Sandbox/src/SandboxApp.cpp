@@ -139,6 +139,18 @@ public:
 			case Stat::FrameRate:
 				std::cout << "Frame Rate: " << (float)Renderer::GetStats().GetFrameRate() << "\n";
 				break;
+
+			case Stat::FrameAllocations:
+				std::cout << "Frame Allocations: " << Renderer::GetStats().numFrameAllocations << "\n";
+				break;
+
+			case Stat::BytesUploaded:
+				std::cout << "Bytes Uploaded: " << Renderer::GetStats().numBytesUploaded << "\n";
+				break;
+
+			case Stat::CulledClusters:
+				std::cout << "Culled Clusters: " << Renderer::GetStats().numCulledClusters << "\n";
+				break;
 			}
 		}
 	}
@@ -151,6 +163,9 @@ private:
 		NumIndices,
 		TimePerFrame,
 		FrameRate,
+		FrameAllocations,
+		BytesUploaded,
+		CulledClusters,
 		Count
 	};
 
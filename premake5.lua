@@ -119,6 +119,61 @@ project "Sandbox"
 		}
 
 
+	filter "configurations:Debug"
+		defines "AE_DEBUG"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "AE_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "AE_DIST"
+		runtime "Release"
+		optimize "on"
+
+
+project "Benchmarks"
+	location "Benchmarks"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+	
+	files
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp"
+	}
+
+	includedirs
+	{
+		"AstralEngine/src",
+		"%{IncludeDir.Glad}",
+		"%{IncludeDir.stbi}"
+	}
+
+	links
+	{
+		"AstralEngine",
+		"Opengl32.lib"
+	}
+	
+	filter "system:windows"
+		staticruntime "on"
+		systemversion "latest"
+
+		defines
+		{
+			"AE_PLATFORM_WINDOWS"
+		}
+
+
 	filter "configurations:Debug"
 		defines "AE_DEBUG"
 		runtime "Debug"